@@ -0,0 +1,460 @@
+#include "async_output.h"
+#include "chunk_buffer_pool.h"
+#include "file_io.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Pojedyncza operacja io_uring zapisuje co najwyżej tyle bajtów (pole len ma 32 bity)
+const size_t MAX_URING_WRITE = 1024 * 1024 * 1024;
+
+bool isAligned(uint64_t value) {
+    return value % AsyncOutputSink::DIRECT_ALIGNMENT == 0;
+}
+
+} // namespace
+
+// Kolejki zgłoszeń i zakończeń io_uring zmapowane z jądra
+struct AsyncOutputSink::IoUring {
+    int fd = -1;
+    void* sqRing = nullptr;
+    size_t sqRingSize = 0;
+    void* cqRing = nullptr;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    ~IoUring() {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing) munmap(sqRing, sqRingSize);
+        if (fd >= 0) close(fd);
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            return false;
+        }
+        if (singleMmap) {
+            cqRing = sqRing;
+        } else {
+            cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                          IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED) {
+                cqRing = nullptr;
+                return false;
+            }
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesMapped = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                IORING_OFF_SQES);
+        if (sqesMapped == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqesMapped);
+
+        unsigned char* sq = static_cast<unsigned char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        unsigned char* cq = static_cast<unsigned char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Zgłasza jedną operację; bez SQPOLL jądro pobiera ją w io_uring_enter, więc kolejka nie rośnie.
+    // Wołane tylko z wątku zgłoszeń
+    bool push(uint8_t opcode, int fileFd, const void* data, size_t size, uint64_t offset, uint64_t userData) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fileFd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = static_cast<uint32_t>(std::min(size, MAX_URING_WRITE));
+        sqe->off = offset;
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (true) {
+            long submitted = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+            if (submitted >= 0) {
+                return submitted == 1;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+        }
+    }
+
+    // Czeka na co najmniej jedno zakończenie
+    void waitCompletion() {
+        syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+};
+
+AsyncOutputOptions AsyncOutputOptions::fromEnvironment(size_t bufferSize, size_t bufferCount) {
+    AsyncOutputOptions options;
+    options.bufferSize = bufferSize;
+    options.bufferCount = bufferCount;
+    const char* backend = std::getenv("CIPHERDATA_OUTPUT_IO");
+    if (backend != nullptr && *backend != '\0') {
+        options.backend = backend;
+    }
+    const char* direct = std::getenv("CIPHERDATA_DIRECT_IO");
+    options.direct = direct != nullptr && std::strcmp(direct, "1") == 0;
+    return options;
+}
+
+AsyncOutputSink::AsyncOutputSink(const AsyncOutputOptions& options)
+    : capacity(std::max<size_t>(options.bufferSize, 1)), direct(options.direct),
+      maxBuffers(std::max<size_t>(options.bufferCount, 1)) {
+    if (options.backend != "auto" && options.backend != "io_uring" && options.backend != "threads") {
+        std::cerr << "Nieznany backend wyjścia: " << options.backend << " (dostępne: auto, io_uring, threads)"
+                  << std::endl;
+    }
+    if (options.backend == "auto" || options.backend == "io_uring") {
+        // Zapis bufora to najwyżej dwie operacje, plus operacja budząca przy zamykaniu
+        unsigned entries = 8;
+        while (entries < 2 * maxBuffers + 1) {
+            entries <<= 1;
+        }
+        ring = std::make_unique<IoUring>();
+        if (ring->setup(entries)) {
+            // Operacje wątku, który się zakończył, jądro anuluje (ECANCELED) - zgłasza więc
+            // zawsze jeden wątek żyjący tak długo jak sink, a nie wątki wywołujących
+            ioThreads.emplace_back(&AsyncOutputSink::submitLoop, this);
+            completionThread = std::thread(&AsyncOutputSink::completionLoop, this);
+        } else {
+            if (options.backend == "io_uring") {
+                std::cerr << "  io_uring niedostępny, zapis przez pulę wątków pwrite" << std::endl;
+            }
+            ring.reset();
+        }
+    }
+    if (!ring) {
+        for (size_t i = 0; i < std::max<size_t>(options.ioThreads, 1); i++) {
+            ioThreads.emplace_back(&AsyncOutputSink::ioLoop, this);
+        }
+    }
+}
+
+AsyncOutputSink::~AsyncOutputSink() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return pendingTotal == 0; });
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread& thread : ioThreads) {
+        thread.join();
+    }
+    if (completionThread.joinable()) {
+        completionThread.join();
+    }
+    for (File& file : files) {
+        if (file.bufferedFd >= 0) close(file.bufferedFd);
+        if (file.directFd >= 0) close(file.directFd);
+    }
+    for (unsigned char* buffer : buffers) {
+        ChunkBufferPool::shared().giveBack(buffer);
+    }
+}
+
+std::string AsyncOutputSink::backendName() const {
+    std::string name = ring ? "io_uring" : "pwrite";
+    return direct ? name + "+O_DIRECT" : name;
+}
+
+int AsyncOutputSink::openFile(const std::string& path) {
+    File file;
+    file.path = path;
+    file.bufferedFd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file.bufferedFd < 0) {
+        std::cerr << "  Błąd: Nie można otworzyć pliku " << path << std::endl;
+        return -1;
+    }
+    if (direct) {
+        file.directFd = open(path.c_str(), O_WRONLY | O_DIRECT);
+        if (file.directFd < 0) {
+            // Np. tmpfs - zapis przez page cache
+            std::cerr << "  O_DIRECT niedostępne dla " << path << ", zapis przez page cache" << std::endl;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    files.push_back(file);
+    return static_cast<int>(files.size() - 1);
+}
+
+bool AsyncOutputSink::flushFile(int file) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (file < 0 || static_cast<size_t>(file) >= files.size()) {
+        return false;
+    }
+    changed.wait(lock, [this, file] { return files[file].pending == 0; });
+    return !files[file].failed;
+}
+
+bool AsyncOutputSink::closeFile(int file) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (file < 0 || static_cast<size_t>(file) >= files.size()) {
+        return false;
+    }
+    changed.wait(lock, [this, file] { return files[file].pending == 0; });
+    File& entry = files[file];
+    bool ok = !entry.failed;
+    if (entry.directFd >= 0 && close(entry.directFd) != 0) {
+        ok = false;
+    }
+    if (entry.bufferedFd >= 0 && close(entry.bufferedFd) != 0) {
+        ok = false;
+    }
+    entry.directFd = entry.bufferedFd = -1;
+    return ok;
+}
+
+bool AsyncOutputSink::failed(int file) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file < 0 || static_cast<size_t>(file) >= files.size() || files[file].failed;
+}
+
+unsigned char* AsyncOutputSink::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (freeBuffers.empty()) {
+        if (buffers.size() + leasing < maxBuffers) {
+            // Mapowanie nowego bufora trwa - bez blokady, żeby zakończenia zapisów nie czekały
+            bool first = buffers.empty() && leasing == 0;
+            leasing++;
+            lock.unlock();
+            unsigned char* buffer = first ? ChunkBufferPool::shared().lease(capacity)
+                                          : ChunkBufferPool::shared().tryLease(capacity);
+            lock.lock();
+            leasing--;
+            if (buffer) {
+                buffers.push_back(buffer);
+                return buffer;
+            }
+            if (first) {
+                return nullptr;
+            }
+            // Limit pamięci puli - sink zostaje przy buforach, które już ma
+            maxBuffers = buffers.size() + leasing;
+            continue;
+        }
+        changed.wait(lock);
+    }
+    unsigned char* buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    return buffer;
+}
+
+void AsyncOutputSink::release(unsigned char* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(buffer);
+    }
+    changed.notify_all();
+}
+
+void AsyncOutputSink::submit(int file, unsigned char* buffer, size_t size, uint64_t offset) {
+    std::vector<Part*> parts;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file < 0 || static_cast<size_t>(file) >= files.size() || files[file].bufferedFd < 0 || size == 0) {
+            if (size > 0) {
+                std::cerr << "  Błąd: Zapis do zamkniętego pliku" << std::endl;
+            }
+            freeBuffers.push_back(buffer);
+            changed.notify_all();
+            return;
+        }
+        File& entry = files[file];
+        Request* request = new Request;
+        request->file = file;
+        request->buffer = buffer;
+
+        // O_DIRECT wymaga wyrównanego przesunięcia, adresu i długości - reszta idzie przez page cache
+        size_t directSize = 0;
+        if (entry.directFd >= 0 && isAligned(offset)) {
+            directSize = size / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+        }
+        if (directSize > 0) {
+            parts.push_back(new Part{request, entry.directFd, buffer, directSize, offset});
+        }
+        if (directSize < size) {
+            parts.push_back(new Part{request, entry.bufferedFd, buffer + directSize, size - directSize,
+                                     offset + directSize});
+        }
+        request->pendingParts = static_cast<int>(parts.size());
+        entry.pending++;
+        pendingTotal++;
+    }
+    for (Part* part : parts) {
+        dispatch(part);
+    }
+}
+
+bool AsyncOutputSink::write(int file, const unsigned char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        size_t piece = std::min(size, capacity);
+        unsigned char* buffer = acquire();
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (file >= 0 && static_cast<size_t>(file) < files.size()) {
+                files[file].failed = true;
+            }
+            return false;
+        }
+        std::memcpy(buffer, data, piece);
+        submit(file, buffer, piece, offset);
+        data += piece;
+        size -= piece;
+        offset += piece;
+    }
+    return true;
+}
+
+void AsyncOutputSink::dispatch(Part* part) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(part);
+    }
+    changed.notify_all();
+}
+
+void AsyncOutputSink::completePart(Part* part, bool ok) {
+    Request* request = part->request;
+    delete part;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        File& entry = files[request->file];
+        if (!ok && !entry.failed) {
+            entry.failed = true;
+            std::cerr << "  Błąd przy zapisie do pliku " << entry.path << std::endl;
+        }
+        if (--request->pendingParts > 0) {
+            return;
+        }
+        freeBuffers.push_back(request->buffer);
+        entry.pending--;
+        pendingTotal--;
+    }
+    delete request;
+    changed.notify_all();
+}
+
+void AsyncOutputSink::ioLoop() {
+    while (true) {
+        Part* part = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            part = queue.front();
+            queue.pop_front();
+        }
+        bool ok = pwriteAll(part->fd, part->data, part->size, static_cast<off_t>(part->offset));
+        completePart(part, ok);
+    }
+}
+
+void AsyncOutputSink::submitLoop() {
+    while (true) {
+        Part* part = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            part = queue.front();
+            queue.pop_front();
+        }
+        if (!ring->push(IORING_OP_WRITE, part->fd, part->data, part->size, part->offset,
+                        reinterpret_cast<uint64_t>(part))) {
+            completePart(part, false);
+        }
+    }
+    // Operacja pusta z user_data = 0 kończy wątek zakończeń
+    ring->push(IORING_OP_NOP, -1, nullptr, 0, 0, 0);
+}
+
+void AsyncOutputSink::completionLoop() {
+    while (true) {
+        ring->waitCompletion();
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        bool stop = false;
+        std::vector<Part*> resubmit;
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = ring->cqes[head & *ring->cqMask];
+            if (cqe.user_data == 0) {
+                stop = true;
+                continue;
+            }
+            Part* part = reinterpret_cast<Part*>(cqe.user_data);
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                resubmit.push_back(part);
+            } else if (cqe.res <= 0) {
+                completePart(part, false);
+            } else if (static_cast<size_t>(cqe.res) < part->size) {
+                // Częściowy zapis - reszta jako kolejna operacja
+                part->data += cqe.res;
+                part->size -= static_cast<size_t>(cqe.res);
+                part->offset += static_cast<uint64_t>(cqe.res);
+                resubmit.push_back(part);
+            } else {
+                completePart(part, true);
+            }
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+        for (Part* part : resubmit) {
+            dispatch(part);
+        }
+        if (stop) {
+            return;
+        }
+    }
+}
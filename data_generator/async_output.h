@@ -0,0 +1,136 @@
+#ifndef ASYNC_OUTPUT_H
+#define ASYNC_OUTPUT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Asynchroniczne wyjście dla wielogigabajtowych plików generatorów.
+ *
+ * Sink ma pierścień buforów z ChunkBufferPool: wywołujący bierze wolny bufor (acquire), wypełnia
+ * go (generuje / szyfruje w miejscu) i zleca zapis (submit) - bufor wraca do pierścienia
+ * dopiero po zakończeniu zapisu, a wywołujący od razu przygotowuje kolejny chunk. Gdy
+ * wszystkie bufory są w zapisie, acquire() czeka, więc ograniczeniem staje się przepustowość
+ * dysku, a pamięć jest stała. Jeden sink obsługuje wiele plików naraz (wspólne bufory).
+ * Bufory są brane z puli przy pierwszej potrzebie, w limicie pamięci puli (bez miejsca na
+ * pierwszy acquire() zwraca nullptr), i wracają do niej w destruktorze.
+ *
+ * Zapisy wykonuje io_uring (wywołania systemowe bez liburing, jeden wątek zbierający
+ * zakończenia) albo - gdy io_uring nie jest dostępny - pula wątków z pwrite. W trybie
+ * O_DIRECT dane omijają page cache; część zapisu niewyrównana do DIRECT_ALIGNMENT
+ * (koniec pliku, dowolne przesunięcia) idzie zwykłym deskryptorem tego samego pliku.
+ */
+
+struct AsyncOutputOptions {
+    size_t bufferSize = 100 * 1024 * 1024; // pojemność jednego bufora
+    size_t bufferCount = 4;                // najwyżej tyle buforów w pierścieniu (wypełniane + w zapisie)
+    std::string backend = "auto";          // "auto", "io_uring" albo "threads"
+    bool direct = false;                   // O_DIRECT dla wyrównanych zapisów
+    size_t ioThreads = 2;                  // wątki pwrite (backend "threads")
+
+    // Opcje z nadpisaniem przez zmienne środowiskowe CIPHERDATA_OUTPUT_IO (backend)
+    // i CIPHERDATA_DIRECT_IO=1 (O_DIRECT) - wspólne dla wszystkich generatorów
+    static AsyncOutputOptions fromEnvironment(size_t bufferSize, size_t bufferCount);
+};
+
+class AsyncOutputSink {
+public:
+    static constexpr size_t DIRECT_ALIGNMENT = 4096;
+
+    explicit AsyncOutputSink(const AsyncOutputOptions& options);
+    ~AsyncOutputSink();
+
+    AsyncOutputSink(const AsyncOutputSink&) = delete;
+    AsyncOutputSink& operator=(const AsyncOutputSink&) = delete;
+
+    // "io_uring" albo "pwrite", z dopiskiem "+O_DIRECT"
+    std::string backendName() const;
+    size_t bufferSize() const { return capacity; }
+
+    // Tworzy (obcina) plik; zwraca uchwyt albo -1 (komunikat na stderr)
+    int openFile(const std::string& path);
+
+    // Czeka na wszystkie zlecone zapisy pliku (np. przed nadpisaniem nagłówka); false po błędzie zapisu
+    bool flushFile(int file);
+
+    // Czeka na wszystkie zapisy pliku i zamyka go; false, jeśli zapis albo zamknięcie się nie powiodło
+    bool closeFile(int file);
+
+    // True, gdy któryś zapis pliku już się nie powiódł - wywołujący może przerwać przygotowywanie
+    // kolejnych chunków (nie czeka na zapisy w toku)
+    bool failed(int file);
+
+    // Wolny bufor z pierścienia (bufferSize() bajtów, wyrównany do DIRECT_ALIGNMENT); czeka, gdy brak wolnych.
+    // nullptr tylko, gdy pula nie da nawet pierwszego bufora - wywołujący musi uznać plik za nieudany
+    unsigned char* acquire();
+
+    // Oddaje bufor bez zapisu
+    void release(unsigned char* buffer);
+
+    // Zleca zapis `size` bajtów bufora z acquire() pod przesunięciem `offset`; bufor przechodzi do sinka
+    void submit(int file, unsigned char* buffer, size_t size, uint64_t offset);
+
+    // Kopiuje dane do buforów pierścienia i zleca ich zapis (dla danych w buforach wywołującego).
+    // False bez bufora - plik jest wtedy oznaczany jako nieudany, a closeFile() zwróci false
+    bool write(int file, const unsigned char* data, size_t size, uint64_t offset);
+
+private:
+    struct File {
+        std::string path;
+        int bufferedFd = -1;
+        int directFd = -1;                 // -1 bez O_DIRECT
+        size_t pending = 0;                // zlecone, niezakończone zapisy
+        bool failed = false;
+    };
+
+    struct Request {
+        int file = -1;
+        unsigned char* buffer = nullptr;
+        int pendingParts = 0;
+    };
+
+    // Jeden zapis systemowy; zapis bufora O_DIRECT dzieli się na część wyrównaną i resztę
+    struct Part {
+        Request* request = nullptr;
+        int fd = -1;
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        uint64_t offset = 0;
+    };
+
+    struct IoUring;
+
+    size_t capacity;
+    bool direct;
+    size_t maxBuffers;                      // maleje, gdy pula odmówi kolejnego bufora
+    size_t leasing = 0;                     // bufory w trakcie pobierania z puli
+    std::vector<unsigned char*> buffers;    // bufory pobrane z puli
+    std::vector<File> files;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<unsigned char*> freeBuffers;
+    size_t pendingTotal = 0;
+
+    std::unique_ptr<IoUring> ring;          // null = backend wątków
+    std::thread completionThread;
+
+    std::deque<Part*> queue;                // części czekające na zgłoszenie / pwrite
+    std::vector<std::thread> ioThreads;     // wątki pwrite albo jeden wątek zgłoszeń io_uring
+    bool stopping = false;
+
+    void dispatch(Part* part);
+    void completePart(Part* part, bool ok);
+    void ioLoop();
+    void submitLoop();
+    void completionLoop();
+};
+
+#endif // ASYNC_OUTPUT_H
@@ -0,0 +1,296 @@
+#include "cipher_engine.h"
+#include "cipher_policies.h"
+#include "des_bitslice.h"
+#include "ecb_kernels.h"
+#include "evp_cipher.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <random>
+#include <iomanip>
+#include <cstring>
+#include <chrono>
+#include <functional>
+#include <type_traits>
+#include <openssl/des.h>
+#include <openssl/blowfish.h>
+#include <openssl/cast.h>
+#include <openssl/rc2.h>
+#include <openssl/rc4.h>
+
+/**
+ * Benchmark przepustowości szyfrów (GB/s).
+ * "przed" - dawna pętla blok po bloku (kopiowanie przez bufor na stosie, nowy wektor wyjściowy);
+ *           dla szyfrów spoza zestawu 56-bit: DES_ecb3_encrypt / RC2_ecb_encrypt blok po bloku,
+ *           pętla bajtowa (xor, vigenere) albo jedno wywołanie EVP na kopii dopełnionej do pełnego
+ *           bloku; IDEA bez EVP (OpenSSL bez IDEA) - własne jądro wywoływane blok po bloku,
+ *           sprawdzone wcześniej wzorcem z publikacji IDEA (pojedynczy blok i każdy pas grupy),
+ * "po"    - CipherEngine szyfrujący w miejscu do bufora wywołującego (dla IDEA - pełne grupy
+ *           pasów wektora, więc zgodność porównuje wynik wielopasowy z jednoblokowym).
+ * Pierwszy argument to rozmiar danych w MB, drugi - liczba powtórzeń, trzeci - lista algorytmów
+ * jak w generatorach ("all" domyślnie).
+ * Dla każdego algorytmu sprawdzana jest też zgodność obu wyników bajt po bajcie.
+ */
+
+// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+namespace {
+
+// Nazwa EVP szyfru z rozszerzonego zestawu (cipher_policies.h); IDEA ma w bibliotece własne
+// jądro, a wzorcem jest EVP, o ile OpenSSL zbudowano z IDEA
+const char* evpNameFor(const std::string& alg) {
+    const char* name = alg == "idea" ? "IDEA-ECB" : "";
+    forEachCipherPolicy(ExtendedCipherPolicies(), [&](auto policy) {
+        using Policy = decltype(policy);
+        if constexpr (std::is_base_of_v<EvpCipherPolicy<Policy>, Policy>) {
+            if (alg == Policy::NAME) {
+                name = Policy::EVP_NAME;
+            }
+        }
+    });
+    return name;
+}
+
+// Wzorzec IDEA (Lai, Massey): klucz 0001 0002 ... 0008, tekst 0000 0001 0002 0003 -> 11FB ED2B 0198 6DE5.
+// Sprawdzany jako pojedynczy blok i w każdym pasie kilku pełnych grup jądra z niepełną resztą
+bool ideaKnownAnswer() {
+    static const unsigned char KEY[16] = {0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04,
+                                          0x00, 0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x08};
+    static const unsigned char PLAIN[8] = {0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03};
+    static const unsigned char CIPHER[8] = {0x11, 0xFB, 0xED, 0x2B, 0x01, 0x98, 0x6D, 0xE5};
+    IdeaKey key;
+    ideaSetKey(&key, KEY);
+
+    unsigned char single[8];
+    ideaEcbEncryptBlocks(&key, PLAIN, single, 1);
+    if (memcmp(single, CIPHER, 8) != 0) {
+        return false;
+    }
+    // 67 bloków: dwie pełne grupy największego wariantu (32 pasy) i reszta
+    const size_t blocks = 67;
+    std::vector<unsigned char> buffer(8 * blocks);
+    for (size_t i = 0; i < blocks; i++) {
+        memcpy(&buffer[8 * i], PLAIN, 8);
+    }
+    ideaEcbEncryptBlocks(&key, buffer.data(), buffer.data(), blocks);
+    for (size_t i = 0; i < blocks; i++) {
+        if (memcmp(&buffer[8 * i], CIPHER, 8) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// IDEA blok po bloku (każdy blok sam w pierwszym pasie grupy), ostatni dopełniony zerami
+std::vector<unsigned char> ideaBlockByBlock(const std::vector<unsigned char>& data, const unsigned char key56[7]) {
+    unsigned char key16[16];
+    expandCipherKey(key56, key16, sizeof(key16));
+    IdeaKey key;
+    ideaSetKey(&key, key16);
+    std::vector<unsigned char> encrypted(data.size());
+    for (size_t i = 0; i < data.size(); i += 8) {
+        size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
+        unsigned char block[8] = {0};
+        memcpy(block, &data[i], blockSize);
+        ideaEcbEncryptBlocks(&key, block, block, 1);
+        memcpy(&encrypted[i], block, blockSize);
+    }
+    return encrypted;
+}
+
+// Referencyjna implementacja sprzed libcipherdata (kopia dawnych encryptCAST/encryptDES/...)
+std::vector<unsigned char> legacyEncrypt(const std::string& alg, const std::vector<unsigned char>& data,
+                                         const unsigned char key56[7]) {
+    std::vector<unsigned char> encrypted(data.size());
+    if (alg == "cast") {
+        CAST_KEY castKey;
+        CAST_set_key(&castKey, 7, key56);
+        for (size_t i = 0; i < data.size(); i += CAST_BLOCK) {
+            size_t blockSize = std::min(static_cast<size_t>(CAST_BLOCK), data.size() - i);
+            unsigned char input[CAST_BLOCK] = {0};
+            unsigned char output[CAST_BLOCK];
+            memcpy(input, &data[i], blockSize);
+            CAST_ecb_encrypt(input, output, &castKey, CAST_ENCRYPT);
+            memcpy(&encrypted[i], output, blockSize);
+        }
+    } else if (alg == "rc4") {
+        RC4_KEY rc4Key;
+        RC4_set_key(&rc4Key, 7, key56);
+        RC4(&rc4Key, data.size(), data.data(), encrypted.data());
+    } else if (alg == "des") {
+        DES_key_schedule desKey;
+        unsigned char desKey8[8];
+        memcpy(desKey8, key56, 7);
+        desKey8[7] = 0;
+        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
+        DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(desKey8), &desKey);
+        for (size_t i = 0; i < data.size(); i += 8) {
+            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
+            unsigned char input[8] = {0};
+            unsigned char output[8];
+            memcpy(input, &data[i], blockSize);
+            DES_ecb_encrypt(reinterpret_cast<const_DES_cblock*>(input),
+                            reinterpret_cast<DES_cblock*>(output),
+                            &desKey, DES_ENCRYPT);
+            memcpy(&encrypted[i], output, blockSize);
+        }
+    } else if (alg == "blowfish") {
+        BF_KEY bfKey;
+        BF_set_key(&bfKey, 7, key56);
+        for (size_t i = 0; i < data.size(); i += BF_BLOCK) {
+            size_t blockSize = std::min(static_cast<size_t>(BF_BLOCK), data.size() - i);
+            unsigned char input[BF_BLOCK] = {0};
+            unsigned char output[BF_BLOCK];
+            memcpy(input, &data[i], blockSize);
+            BF_ecb_encrypt(input, output, &bfKey, BF_ENCRYPT);
+            memcpy(&encrypted[i], output, blockSize);
+        }
+    } else if (alg == "3des") {
+        unsigned char keys[24];
+        expandCipherKey(key56, keys, sizeof(keys));
+        DES_key_schedule schedules[3];
+        for (int k = 0; k < 3; k++) {
+            DES_set_odd_parity(reinterpret_cast<DES_cblock*>(keys + 8 * k));
+            DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(keys + 8 * k), &schedules[k]);
+        }
+        for (size_t i = 0; i < data.size(); i += 8) {
+            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
+            unsigned char input[8] = {0};
+            unsigned char output[8];
+            memcpy(input, &data[i], blockSize);
+            DES_ecb3_encrypt(reinterpret_cast<const_DES_cblock*>(input), reinterpret_cast<DES_cblock*>(output),
+                             &schedules[0], &schedules[1], &schedules[2], DES_ENCRYPT);
+            memcpy(&encrypted[i], output, blockSize);
+        }
+    } else if (alg == "rc2") {
+        unsigned char key16[16];
+        expandCipherKey(key56, key16, sizeof(key16));
+        RC2_KEY rc2Key;
+        RC2_set_key(&rc2Key, sizeof(key16), key16, 128);
+        for (size_t i = 0; i < data.size(); i += 8) {
+            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
+            unsigned char input[8] = {0};
+            unsigned char output[8];
+            memcpy(input, &data[i], blockSize);
+            RC2_ecb_encrypt(input, output, &rc2Key, RC2_ENCRYPT);
+            memcpy(&encrypted[i], output, blockSize);
+        }
+    } else if (alg == "xor" || alg == "vigenere") {
+        for (size_t i = 0; i < data.size(); i++) {
+            encrypted[i] = alg == "xor" ? data[i] ^ key56[i % 7] : static_cast<unsigned char>(data[i] + key56[i % 7]);
+        }
+    } else {
+        // Szyfry EVP: jedno wywołanie na dane dopełnione zerami do pełnego bloku, potem obcięcie
+        EvpCipherKey key;
+        if (!setEvpCipherKey(key, evpNameFor(alg), key56)) {
+            return alg == "idea" ? ideaBlockByBlock(data, key56) : std::vector<unsigned char>();
+        }
+        const size_t blockSize = EVP_CIPHER_get_block_size(key.cipher.get());
+        std::vector<unsigned char> padded(data);
+        padded.resize((data.size() + blockSize - 1) / blockSize * blockSize, 0);
+        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+        EVP_EncryptInit_ex2(ctx, key.cipher.get(), key.key, key.iv, nullptr);
+        EVP_CIPHER_CTX_set_padding(ctx, 0);
+        int written = 0;
+        EVP_EncryptUpdate(ctx, padded.data(), &written, padded.data(), static_cast<int>(padded.size()));
+        EVP_CIPHER_CTX_free(ctx);
+        memcpy(encrypted.data(), padded.data(), data.size());
+    }
+    return encrypted;
+}
+
+// Najlepszy z `repeats` pomiarów, w GB/s
+double measureGBps(const std::function<void()>& fn, size_t bytes, int repeats) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, static_cast<double>(bytes) / elapsed.count() / 1e9);
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sizeMB = 64;
+    int repeats = 3;
+    std::vector<std::string> algorithms = cipherAlgorithms();
+
+    if (argc > 1) {
+        sizeMB = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+        repeats = std::stoi(argv[2]);
+    }
+    if (argc > 3 && !selectCipherAlgorithms(argv[3], algorithms)) {
+        return 1;
+    }
+
+    // Rozmiar celowo niepodzielny przez 8, żeby objąć też obsługę ostatniego bloku
+    const size_t size = sizeMB * 1024 * 1024 + 3;
+
+    std::cout << "=== Benchmark szyfrów ===" << std::endl;
+    std::cout << "Rozmiar danych: " << sizeMB << " MB, powtórzenia: " << repeats << std::endl;
+    std::cout << "Wariant bitslicowanego DES: " << BitslicedDes::kernelName() << std::endl;
+    std::cout << "Wariant jąder RC2 / IDEA: " << wideEcbKernelName() << std::endl << std::endl;
+
+    unsigned char key56[7];
+    generate56BitKey(12345, key56);
+
+    std::vector<unsigned char> data(size);
+    std::mt19937 gen(12345);
+    for (auto& b : data) {
+        b = static_cast<unsigned char>(gen());
+    }
+
+    bool allMatch = true;
+    if (std::find(algorithms.begin(), algorithms.end(), "idea") != algorithms.end()) {
+        bool known = ideaKnownAnswer();
+        allMatch = known;
+        std::cout << "Wzorzec IDEA (klucz 0001..0008, 11FB ED2B 0198 6DE5): " << (known ? "OK" : "BŁĄD") << std::endl
+                  << std::endl;
+    }
+
+    std::cout << std::left << std::setw(12) << "Algorytm" << std::right
+              << std::setw(14) << "przed [GB/s]" << std::setw(12) << "po [GB/s]"
+              << std::setw(10) << "zysk" << "  zgodność" << std::endl;
+
+    for (const std::string& alg : algorithms) {
+        std::unique_ptr<CipherEngine> engine = createCipherEngine(alg, key56);
+        if (!engine) {
+            std::cout << std::left << std::setw(12) << alg << " niedostępny w tej instalacji OpenSSL" << std::endl;
+            continue;
+        }
+
+        std::vector<unsigned char> reference;
+        double before = measureGBps([&]() { reference = legacyEncrypt(alg, data, key56); }, size, repeats);
+
+        std::vector<unsigned char> buffer(size);
+        bool encrypted = true;
+        double after = measureGBps(
+            [&]() { encrypted = engine->encrypt(data.data(), buffer.data(), size) && encrypted; }, size, repeats);
+
+        if (reference.empty()) {
+            allMatch = allMatch && encrypted;
+            std::cout << std::left << std::setw(12) << alg << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(14) << "-" << std::setw(12) << after << std::setw(10) << "-"
+                      << (encrypted ? "  brak wzorca" : "  BŁĄD") << std::endl;
+            continue;
+        }
+        bool match = encrypted && buffer == reference;
+        allMatch = allMatch && match;
+
+        std::cout << std::left << std::setw(12) << alg << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << before << std::setw(12) << after
+                  << std::setw(9) << std::setprecision(2) << after / before << "x"
+                  << "  " << (match ? "OK" : "BŁĄD") << std::endl;
+    }
+
+    return allMatch ? 0 : 1;
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,277 @@
+#include "block_hash_set.h"
+#include "block_hash_set_impl.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const size_t INITIAL_GROUPS = 8192; // 64 K kluczy, 1,5 MB
+const size_t MIN_GROUPS = 8;
+const size_t SKETCH_ROWS = 4;
+const size_t SKETCH_ROW_CELLS = 4;  // liczniki wiersza w jednej linii szkicu
+const size_t MIN_SKETCH_LINES = 256;
+const size_t MAX_CANDIDATES = 64;
+const unsigned HLL_BITS = 16; // 64 K rejestrów - błąd standardowy 0,4%
+const size_t SLOT_BYTES = sizeof(uint64_t) + sizeof(BlockSlotInfo);
+
+struct Group64 {
+    static unsigned match(const uint64_t* keys, uint64_t key) {
+        unsigned mask = 0;
+        for (unsigned i = 0; i < 8; i++) {
+            mask |= static_cast<unsigned>(keys[i] == key) << i;
+        }
+        return mask;
+    }
+};
+
+struct BlockSetKernelChoice {
+    void (*add)(BlockHashSet::Table& table, const unsigned char* data, size_t blocks);
+    const char* name;
+};
+
+BlockSetKernelChoice selectBlockSetKernel() {
+#ifdef CIPHERDATA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {blockHashSetAddAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {blockHashSetAddAvx2, "avx2"};
+    }
+#endif
+    return {blockHashSetAdd64, "64-bit"};
+}
+
+const BlockSetKernelChoice& blockSetKernel() {
+    static const BlockSetKernelChoice choice = selectBlockSetKernel();
+    return choice;
+}
+
+size_t floorPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power * 2 <= value) {
+        power *= 2;
+    }
+    return power;
+}
+
+void resizeTable(BlockHashSet::Table& table, size_t groupCount) {
+    table.groups.assign(groupCount, BlockKeyGroup{});
+    table.slots.assign(groupCount * 8, BlockSlotInfo{});
+    table.groupMask = groupCount - 1;
+    table.shift = 64 - static_cast<unsigned>(__builtin_ctzll(groupCount));
+    // Przy 7/8 nieudane wyszukiwanie (każdy nowy blok po przepełnieniu) przegląda średnio
+    // ok. 4,7 grupy, przy 3/4 - 1,7; tablica mieści o 1/7 mniej bloków, ale po przepełnieniu
+    // blok kosztuje zwykle jedną-dwie linie cache zamiast pięciu
+    table.maxEntries = groupCount * 8 * 3 / 4;
+}
+
+// Licznik wiersza r w linii szkicu: po 2 bity innego mnożenia haszu dla każdego wiersza
+inline size_t sketchCell(uint64_t hash, size_t row) {
+    uint64_t mixed = (hash ^ (hash >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    return row * SKETCH_ROW_CELLS + static_cast<size_t>((mixed >> (56 + 2 * row)) & (SKETCH_ROW_CELLS - 1));
+}
+
+} // namespace
+
+void blockHashSetAdd64(BlockHashSet::Table& table, const unsigned char* data, size_t blocks) {
+    addBlocks<Group64>(table, data, blocks);
+}
+
+bool BlockHashSet::Table::grow() {
+    if (groups.size() * 2 > maxGroups) {
+        return false;
+    }
+    std::vector<BlockKeyGroup> oldGroups;
+    std::vector<BlockSlotInfo> oldSlots;
+    oldGroups.swap(groups);
+    oldSlots.swap(slots);
+    resizeTable(*this, oldGroups.size() * 2);
+    for (size_t slot = 0; slot < oldSlots.size(); slot++) {
+        uint64_t key = oldGroups[slot / 8].keys[slot % 8];
+        if (key == 0) {
+            continue;
+        }
+        size_t group = static_cast<size_t>(blockHash(key) >> shift);
+        unsigned empty;
+        while ((empty = Group64::match(groups[group].keys, 0)) == 0) {
+            group = (group + 1) & groupMask;
+        }
+        size_t target = group * 8 + __builtin_ctz(empty);
+        groups[group].keys[target & 7] = key;
+        slots[target] = oldSlots[slot];
+    }
+    return true;
+}
+
+void BlockHashSet::Table::addOverflow(uint64_t key, uint64_t hash) {
+    if (!overflowed) {
+        overflowed = true;
+        registers.assign(size_t(1) << HLL_BITS, 0);
+        size_t lines = std::max(MIN_SKETCH_LINES, floorPowerOfTwo(sketchBytes / sizeof(BlockSketchLine)));
+        sketch.assign(lines, BlockSketchLine{});
+        sketchLineMask = lines - 1;
+    }
+    overflowBlocks++;
+
+    // Rejestr HyperLogLog z najmłodszych bitów haszu (numer grupy w tablicy to najstarsze)
+    uint8_t rank = static_cast<uint8_t>(__builtin_ctzll((hash >> HLL_BITS) | (1ULL << (64 - HLL_BITS))) + 1);
+    uint8_t& reg = registers[hash & ((1u << HLL_BITS) - 1)];
+    reg = std::max(reg, rank);
+
+    // Aktualizacja zachowawcza: zwiększane tylko minimalne liczniki - mniejsze przeszacowanie.
+    // Wszystkie wiersze leżą w jednej linii, więc blok to jedno chybienie cache, nie cztery.
+    uint32_t* line = sketch[blockSketchLine(*this, hash)].cells;
+    size_t cells[SKETCH_ROWS];
+    uint32_t estimate = UINT32_MAX;
+    for (size_t row = 0; row < SKETCH_ROWS; row++) {
+        cells[row] = sketchCell(hash, row);
+        estimate = std::min(estimate, line[cells[row]]);
+    }
+    if (estimate == UINT32_MAX) {
+        return;
+    }
+    estimate++;
+    for (size_t row = 0; row < SKETCH_ROWS; row++) {
+        line[cells[row]] = std::max(line[cells[row]], estimate);
+    }
+    if (estimate < 2) {
+        return;
+    }
+
+    // Kandydaci do najczęstszych: blok zostaje, dopóki nie wyprze go częstszy. Przy pełnej
+    // liście bloki nie częstsze od najsłabszego kandydata pomijane są bez przeglądania listy.
+    if (estimate <= candidateFloor) {
+        return;
+    }
+    Repetition* weakest = nullptr;
+    for (Repetition& candidate : candidates) {
+        if (candidate.block == key) {
+            candidate.count = estimate;
+            return;
+        }
+        if (weakest == nullptr || candidate.count < weakest->count) {
+            weakest = &candidate;
+        }
+    }
+    Repetition repetition;
+    repetition.block = key;
+    repetition.count = estimate;
+    repetition.estimated = true;
+    if (candidates.size() < MAX_CANDIDATES) {
+        candidates.push_back(repetition);
+        if (candidates.size() < MAX_CANDIDATES) {
+            return;
+        }
+    } else {
+        *weakest = repetition;
+    }
+    candidateFloor = candidates.front().count;
+    for (const Repetition& candidate : candidates) {
+        candidateFloor = std::min(candidateFloor, candidate.count);
+    }
+}
+
+BlockHashSet::BlockHashSet(size_t memoryLimit) : table(std::make_unique<Table>()) {
+    // 1/8 limitu na szkic count-min, reszta na tablicę
+    table->sketchBytes = memoryLimit / 8;
+    size_t tableBytes = memoryLimit - table->sketchBytes;
+    table->maxGroups = std::max(MIN_GROUPS, floorPowerOfTwo(std::max<size_t>(tableBytes / (8 * SLOT_BYTES), 1)));
+    resizeTable(*table, std::min(INITIAL_GROUPS, table->maxGroups));
+}
+
+BlockHashSet::~BlockHashSet() = default;
+
+void BlockHashSet::addBlocks(const unsigned char* data, size_t blocks) {
+    blockSetKernel().add(*table, data, blocks);
+}
+
+uint64_t BlockHashSet::blocks() const {
+    return table->totalBlocks;
+}
+
+bool BlockHashSet::exact() const {
+    return !table->overflowed;
+}
+
+uint64_t BlockHashSet::distinctBlocks() const {
+    uint64_t exactCount = table->entries + (table->zero.count > 0 ? 1 : 0);
+    if (!table->overflowed) {
+        return exactCount;
+    }
+    // Bloki spoza tablicy nigdy do niej nie trafiają, więc ich różne wartości szacuje osobny
+    // HyperLogLog (z poprawką dla małych liczności - zliczanie liniowe)
+    const double m = static_cast<double>(table->registers.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t reg : table->registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(reg));
+        zeros += reg == 0;
+    }
+    double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    uint64_t overflowDistinct = std::min(static_cast<uint64_t>(std::llround(estimate)), table->overflowBlocks);
+    return exactCount + overflowDistinct;
+}
+
+double BlockHashSet::distinctRelativeError() const {
+    return table->overflowed ? 1.04 / std::sqrt(static_cast<double>(table->registers.size())) : 0.0;
+}
+
+uint64_t BlockHashSet::duplicateBlocks() const {
+    return table->totalBlocks - distinctBlocks();
+}
+
+const uint64_t* BlockHashSet::distanceHistogram() const {
+    return table->distances;
+}
+
+std::vector<BlockHashSet::Repetition> BlockHashSet::topRepetitions(size_t k) const {
+    std::vector<Repetition> all;
+    auto add = [&all](uint64_t block, const BlockSlotInfo& info) {
+        if (info.count >= 2) {
+            Repetition repetition;
+            repetition.block = block;
+            repetition.count = info.count;
+            repetition.lastIndex = info.last;
+            all.push_back(repetition);
+        }
+    };
+    add(0, table->zero);
+    for (size_t slot = 0; slot < table->slots.size(); slot++) {
+        add(table->groups[slot / 8].keys[slot % 8], table->slots[slot]);
+    }
+    // Szkic count-min tylko zawyża: z prawdopodobieństwem 1 - e^-wierszy błąd nie przekracza
+    // e * N / szerokość wiersza (linie * liczniki wiersza w linii), więc kandydaci poniżej tej
+    // granicy mogą być samymi kolizjami
+    if (table->overflowed) {
+        const double width = static_cast<double>((table->sketchLineMask + 1) * SKETCH_ROW_CELLS);
+        const double bound = std::exp(1.0) * static_cast<double>(table->overflowBlocks) / width;
+        for (const Repetition& candidate : table->candidates) {
+            if (static_cast<double>(candidate.count) > bound + 1.0) {
+                all.push_back(candidate);
+            }
+        }
+    }
+
+    size_t count = std::min(k, all.size());
+    std::partial_sort(all.begin(), all.begin() + count, all.end(),
+                      [](const Repetition& a, const Repetition& b) { return a.count > b.count; });
+    all.resize(count);
+    return all;
+}
+
+uint64_t BlockHashSet::tableEntries() const {
+    return table->entries;
+}
+
+size_t BlockHashSet::memoryBytes() const {
+    return table->groups.size() * sizeof(BlockKeyGroup) + table->slots.size() * sizeof(BlockSlotInfo) +
+           table->sketch.size() * sizeof(BlockSketchLine) + table->registers.size();
+}
+
+const char* BlockHashSet::kernelName() {
+    return blockSetKernel().name;
+}
@@ -0,0 +1,82 @@
+#ifndef BLOCK_HASH_SET_H
+#define BLOCK_HASH_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Licznik powtórzeń bloków 8-bajtowych (wyciek trybu ECB) dla wielogigabajtowych plików.
+ *
+ * Bloki są kluczami zbioru z adresowaniem otwartym: grupa 8 kluczy zajmuje jedną linię
+ * cache i jest porównywana z szukanym kluczem naraz (AVX-512 / AVX2 / słowa 64-bitowe,
+ * wariant wybierany w czasie działania), a hasze kolejnych bloków są liczone z wyprzedzeniem
+ * i ich grupy pobierane instrukcją prefetch. Dla każdego bloku w tablicy zbiór pamięta
+ * liczbę wystąpień i ostatnie położenie - stąd histogram odległości między powtórzeniami
+ * i najczęstsze bloki.
+ *
+ * Pamięć jest ograniczona: tablica rośnie do limitu, a po jego wyczerpaniu bloki już
+ * obecne liczone są dalej dokładnie, a nowe trafiają do HyperLogLog (liczba różnych,
+ * więc i powtórzeń - exact() == false) i szkicu count-min (szacunek liczby wystąpień
+ * i kandydaci do najczęstszych bloków). Tablica rośnie przy zapełnieniu 3/4, by szukanie
+ * nowych bloków po przepełnieniu kończyło się zwykle w pierwszej lub drugiej grupie, a
+ * wszystkie wiersze count-min dla bloku leżą w jednej linii cache.
+ */
+class BlockHashSet {
+public:
+    static const size_t DISTANCE_BUCKETS = 64;
+
+    struct Repetition {
+        uint64_t block = 0;      // wartość bloku (8 bajtów little endian)
+        uint64_t count = 0;      // wystąpienia (szacunek, gdy estimated)
+        uint64_t lastIndex = 0;  // numer bloku ostatniego wystąpienia (tylko dokładne)
+        bool estimated = false;  // blok spoza tablicy - liczba ze szkicu count-min
+    };
+
+    // memoryLimit - łączny rozmiar tablicy i szkiców w bajtach
+    explicit BlockHashSet(size_t memoryLimit);
+    ~BlockHashSet();
+
+    BlockHashSet(const BlockHashSet&) = delete;
+    BlockHashSet& operator=(const BlockHashSet&) = delete;
+
+    // Dodaje `blocks` kolejnych bloków; numeracja bloków ciągnie się przez kolejne wywołania
+    void addBlocks(const unsigned char* data, size_t blocks);
+
+    uint64_t blocks() const;
+
+    // Czy wszystkie różne bloki zmieściły się w tablicy (liczby dokładne)
+    bool exact() const;
+
+    // Różne bloki: dokładnie albo z HyperLogLog po przepełnieniu
+    uint64_t distinctBlocks() const;
+
+    // Względny błąd standardowy części szacowanej distinctBlocks() (0 - liczba dokładna)
+    double distinctRelativeError() const;
+
+    // Bloki powtarzające któryś z wcześniejszych (blocks() - distinctBlocks())
+    uint64_t duplicateBlocks() const;
+
+    // distanceHistogram()[b] - powtórzenia odległe od poprzedniego wystąpienia o [2^b, 2^(b+1)) bloków;
+    // tylko bloki z tablicy
+    const uint64_t* distanceHistogram() const;
+
+    // k najczęściej powtarzanych bloków (co najmniej 2 wystąpienia), malejąco
+    std::vector<Repetition> topRepetitions(size_t k) const;
+
+    // Różne bloki w tablicy i pamięć zajęta przez tablicę i szkice
+    uint64_t tableEntries() const;
+    size_t memoryBytes() const;
+
+    // Nazwa wybranego wariantu porównań grupy ("avx512" / "avx2" / "64-bit")
+    static const char* kernelName();
+
+    // Stan zbioru - definicja w block_hash_set_impl.h, wspólna dla wariantów jąder
+    struct Table;
+
+private:
+    std::unique_ptr<Table> table;
+};
+
+#endif // BLOCK_HASH_SET_H
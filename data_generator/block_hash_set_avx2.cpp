@@ -0,0 +1,22 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "block_hash_set_impl.h"
+#include <immintrin.h>
+
+namespace {
+
+// Dwa porównania po 4 klucze; maska ze znaków wyników
+struct GroupAvx2 {
+    static unsigned match(const uint64_t* keys, uint64_t key) {
+        const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(key));
+        __m256i lo = _mm256_cmpeq_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(keys)), needle);
+        __m256i hi = _mm256_cmpeq_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(keys + 4)), needle);
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lo))) |
+               static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hi))) << 4;
+    }
+};
+
+} // namespace
+
+void blockHashSetAddAvx2(BlockHashSet::Table& table, const unsigned char* data, size_t blocks) {
+    addBlocks<GroupAvx2>(table, data, blocks);
+}
@@ -0,0 +1,18 @@
+// Budowany z -mavx512f (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "block_hash_set_impl.h"
+#include <immintrin.h>
+
+namespace {
+
+// Cała grupa (linia cache) w jednym porównaniu
+struct GroupAvx512 {
+    static unsigned match(const uint64_t* keys, uint64_t key) {
+        return _mm512_cmpeq_epi64_mask(_mm512_load_si512(keys), _mm512_set1_epi64(static_cast<long long>(key)));
+    }
+};
+
+} // namespace
+
+void blockHashSetAddAvx512(BlockHashSet::Table& table, const unsigned char* data, size_t blocks) {
+    addBlocks<GroupAvx512>(table, data, blocks);
+}
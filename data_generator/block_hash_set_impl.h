@@ -0,0 +1,167 @@
+#ifndef BLOCK_HASH_SET_IMPL_H
+#define BLOCK_HASH_SET_IMPL_H
+
+/**
+ * Wewnętrzna część BlockHashSet, wspólna dla wariantów 64-bit / AVX2 / AVX-512.
+ *
+ * Pętla dodawania bloków jest szablonem po typie Group, który porównuje klucz z grupą
+ * 8 kluczy i zwraca maskę bitową trafień. Plik jest dołączany przez jednostki kompilacji
+ * budowane z -mavx2 / -mavx512f, dlatego wszystko poza strukturą stanu i deklaracjami jąder
+ * ma wiązanie wewnętrzne. Wolne miejsca w tablicy mają klucz 0, więc blok zerowy
+ * (częsty - wypełnienie zerami) ma osobny licznik.
+ */
+
+#include "block_hash_set.h"
+#include <cstring>
+#include <vector>
+
+// Grupa kluczy w jednej linii cache
+struct alignas(64) BlockKeyGroup {
+    uint64_t keys[8];
+};
+
+// Linia szkicu count-min: wszystkie wiersze dla bloku w jednej linii cache, po 4 liczniki na wiersz
+struct alignas(64) BlockSketchLine {
+    uint32_t cells[16];
+};
+
+// 16 bajtów - opisy grupy zajmują dwie linie cache
+struct BlockSlotInfo {
+    uint64_t last = 0;  // numer bloku ostatniego wystąpienia
+    uint64_t count = 0;
+};
+
+struct BlockHashSet::Table {
+    std::vector<BlockKeyGroup> groups;
+    std::vector<BlockSlotInfo> slots;
+    size_t groupMask = 0;
+    unsigned shift = 0;         // numer grupy = hash >> shift
+    size_t maxGroups = 0;       // limit pamięci
+    uint64_t maxEntries = 0;    // próg wzrostu (3/4 miejsc)
+    uint64_t entries = 0;
+
+    BlockSlotInfo zero;         // blok zerowy (count == 0 - nie wystąpił)
+
+    uint64_t totalBlocks = 0;
+    bool overflowed = false;
+    uint64_t distances[DISTANCE_BUCKETS] = {};
+
+    // Bloki spoza pełnej tablicy: HyperLogLog (liczba różnych), szkic count-min
+    // i jego kandydaci do najczęstszych
+    uint64_t overflowBlocks = 0;
+    std::vector<uint8_t> registers;
+    std::vector<BlockSketchLine> sketch;
+    size_t sketchLineMask = 0;
+    std::vector<Repetition> candidates;
+    uint64_t candidateFloor = 0; // najmniejsza liczba wśród pełnej listy kandydatów
+
+    size_t sketchBytes = 0;     // zarezerwowane na szkice (alokowane przy przepełnieniu)
+
+    // Podwaja tablicę, jeśli pozwala limit; false - tablica ma już maksymalny rozmiar
+    bool grow();
+
+    // Blok nowy, gdy tablica jest pełna
+    void addOverflow(uint64_t key, uint64_t hash);
+};
+
+// Jądra dla kolejnych zestawów instrukcji
+void blockHashSetAdd64(BlockHashSet::Table& table, const unsigned char* data, size_t blocks);
+void blockHashSetAddAvx2(BlockHashSet::Table& table, const unsigned char* data, size_t blocks);
+void blockHashSetAddAvx512(BlockHashSet::Table& table, const unsigned char* data, size_t blocks);
+
+namespace {
+
+// Finalizator MurmurHash3 - bity klucza mieszane we wszystkie bity haszu
+inline uint64_t blockHash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// Linia szkicu count-min bloku - wspólna dla aktualizacji i prefetchu
+inline size_t blockSketchLine(const BlockHashSet::Table& table, uint64_t hash) {
+    return static_cast<size_t>(((hash ^ (hash >> 29)) * 0x9E3779B97F4A7C15ULL) >> 32) & table.sketchLineMask;
+}
+
+inline void recordRepeat(BlockHashSet::Table& table, BlockSlotInfo& info, uint64_t index) {
+    uint64_t distance = index - info.last;
+    table.distances[63 - __builtin_clzll(distance)]++;
+    info.last = index;
+    info.count++;
+}
+
+template <typename Group>
+inline void addBlock(BlockHashSet::Table& table, uint64_t key, uint64_t hash, uint64_t index) {
+    if (key == 0) {
+        if (table.zero.count == 0) {
+            table.zero = BlockSlotInfo{index, 1};
+        } else {
+            recordRepeat(table, table.zero, index);
+        }
+        return;
+    }
+    size_t group = static_cast<size_t>(hash >> table.shift);
+    while (true) {
+        const uint64_t* keys = table.groups[group].keys;
+        unsigned hit = Group::match(keys, key);
+        if (hit != 0) {
+            recordRepeat(table, table.slots[group * 8 + __builtin_ctz(hit)], index);
+            return;
+        }
+        unsigned empty = Group::match(keys, 0);
+        if (empty != 0) {
+            if (table.entries >= table.maxEntries) {
+                if (table.grow()) {
+                    group = static_cast<size_t>(hash >> table.shift);
+                    continue;
+                }
+                table.addOverflow(key, hash);
+                return;
+            }
+            size_t slot = group * 8 + __builtin_ctz(empty);
+            table.groups[group].keys[slot & 7] = key;
+            table.slots[slot] = BlockSlotInfo{index, 1};
+            table.entries++;
+            return;
+        }
+        group = (group + 1) & table.groupMask;
+    }
+}
+
+// Bloki w paczkach: hasze i prefetch grup całej paczki przed pierwszym porównaniem. Po
+// przepełnieniu większość bloków jest nowa: nie czyta opisów miejsc, tylko szuka w tablicy
+// do grupy z wolnym miejscem i trafia do szkiców - zamiast opisów pobierana jest więc
+// następna grupa, linia count-min i rejestr HyperLogLog.
+template <typename Group>
+void addBlocks(BlockHashSet::Table& table, const unsigned char* data, size_t blocks) {
+    const size_t BATCH = 16;
+    uint64_t keys[BATCH], hashes[BATCH];
+    for (size_t base = 0; base < blocks; base += BATCH) {
+        size_t count = blocks - base < BATCH ? blocks - base : BATCH;
+        for (size_t j = 0; j < count; j++) {
+            std::memcpy(&keys[j], data + 8 * (base + j), 8);
+            hashes[j] = blockHash(keys[j]);
+            size_t group = static_cast<size_t>(hashes[j] >> table.shift);
+            __builtin_prefetch(&table.groups[group]);
+            if (!table.overflowed) {
+                const char* info = reinterpret_cast<const char*>(&table.slots[group * 8]);
+                __builtin_prefetch(info);
+                __builtin_prefetch(info + 64);
+            } else {
+                __builtin_prefetch(&table.groups[(group + 1) & table.groupMask]);
+                __builtin_prefetch(&table.sketch[blockSketchLine(table, hashes[j])]);
+                __builtin_prefetch(&table.registers[hashes[j] & (table.registers.size() - 1)]);
+            }
+        }
+        for (size_t j = 0; j < count; j++) {
+            addBlock<Group>(table, keys[j], hashes[j], table.totalBlocks++);
+        }
+    }
+}
+
+} // namespace
+
+#endif // BLOCK_HASH_SET_IMPL_H
@@ -0,0 +1,54 @@
+#include "markov_model.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Buduje model Markowa i zapisuje go do pliku, który generatory tekstu wczytują
+ * przez zmienną środowiskową MARKOV_MODEL (zamiast budować go przy starcie).
+ * Bez pliku korpusu używany jest wbudowany korpus; plik korpusu to jedno zdanie na linię.
+ */
+int main(int argc, char* argv[]) {
+    std::string outputPath = "markov.model";
+    std::string corpusPath;
+
+    if (argc > 1) {
+        outputPath = argv[1];
+    }
+    if (argc > 2) {
+        corpusPath = argv[2];
+    }
+
+    std::vector<std::string> corpus;
+    if (corpusPath.empty()) {
+        corpus = MarkovModel::defaultCorpus();
+    } else {
+        std::ifstream file(corpusPath);
+        if (!file.is_open()) {
+            std::cerr << "Błąd: Nie można otworzyć pliku korpusu " << corpusPath << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                corpus.push_back(line);
+            }
+        }
+    }
+
+    std::shared_ptr<const MarkovModel> model = MarkovModel::fromCorpus(corpus);
+    if (model->empty()) {
+        std::cerr << "Błąd: Korpus nie zawiera żadnego bigramu" << std::endl;
+        return 1;
+    }
+    if (!model->save(outputPath)) {
+        return 1;
+    }
+
+    std::cout << "Zapisano model: " << outputPath << std::endl;
+    std::cout << "  Zdania korpusu: " << corpus.size() << std::endl;
+    std::cout << "  Tokeny: " << model->tokenCount() << std::endl;
+    std::cout << "Użycie: MARKOV_MODEL=" << outputPath << " ./generate_text ..." << std::endl;
+    return 0;
+}
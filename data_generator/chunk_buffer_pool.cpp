@@ -0,0 +1,149 @@
+#include "chunk_buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Zmapowany i wypełniony stronami bufor; nullptr bez pamięci
+unsigned char* mapBuffer(size_t capacity) {
+#ifdef MAP_HUGETLB
+    // Zarezerwowane duże strony (vm.nr_hugepages) - zwykle ich nie ma, wtedy mmap od razu odmawia
+    void* address = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if (address != MAP_FAILED) {
+        return static_cast<unsigned char*>(address);
+    }
+#endif
+    void* mapped = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    unsigned char* data = static_cast<unsigned char*>(mapped);
+    // THP przed pierwszym dotknięciem, żeby strony od razu były duże
+#ifdef MADV_HUGEPAGE
+    madvise(data, capacity, MADV_HUGEPAGE);
+#endif
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(data, capacity, MADV_POPULATE_WRITE) == 0) {
+        return data;
+    }
+#endif
+    // Starsze jądra - dotknięcie każdej strony
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < capacity; offset += pageSize) {
+        data[offset] = 0;
+    }
+    return data;
+}
+
+// Domyślny limit: połowa pamięci fizycznej (reszta dla page cache zapisu i innych procesów)
+size_t defaultLimit() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 2048ULL * 1024 * 1024;
+    }
+    size_t half = static_cast<size_t>(pages) * static_cast<size_t>(pageSize) / 2;
+    return std::max(half / ChunkBufferPool::GRANULE * ChunkBufferPool::GRANULE, ChunkBufferPool::GRANULE);
+}
+
+} // namespace
+
+ChunkBufferPool& ChunkBufferPool::shared() {
+    // Inicjalizacja statycznej zmiennej lokalnej jest bezpieczna wątkowo - pula powstaje raz
+    static ChunkBufferPool instance([]() -> size_t {
+        const char* megabytes = std::getenv("CIPHERDATA_BUFFER_MB");
+        if (megabytes == nullptr || *megabytes == '\0') {
+            return defaultLimit();
+        }
+        return static_cast<size_t>(std::strtoull(megabytes, nullptr, 10)) * 1024 * 1024;
+    }());
+    return instance;
+}
+
+ChunkBufferPool::ChunkBufferPool(size_t limitBytes) : limitBytes(limitBytes) {}
+
+ChunkBufferPool::~ChunkBufferPool() {
+    for (const Buffer& buffer : buffers) {
+        munmap(buffer.data, buffer.capacity);
+    }
+}
+
+unsigned char* ChunkBufferPool::lease(size_t size) {
+    return take(size, true);
+}
+
+unsigned char* ChunkBufferPool::tryLease(size_t size) {
+    return take(size, false);
+}
+
+unsigned char* ChunkBufferPool::take(size_t size, bool required) {
+    const size_t capacity = roundUp(std::max<size_t>(size, 1), GRANULE);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Najmniejszy wolny bufor, który wystarczy
+    Buffer* best = nullptr;
+    for (Buffer& buffer : buffers) {
+        if (!buffer.leased && buffer.capacity >= capacity && (!best || buffer.capacity < best->capacity)) {
+            best = &buffer;
+        }
+    }
+    if (best) {
+        best->leased = true;
+        return best->data;
+    }
+
+    // Miejsce na nowy bufor robią wolne bufory innych rozmiarów
+    while (limitBytes > 0 && mappedBytes + capacity > limitBytes) {
+        auto victim = std::find_if(buffers.begin(), buffers.end(), [](const Buffer& b) { return !b.leased; });
+        if (victim == buffers.end()) {
+            break;
+        }
+        munmap(victim->data, victim->capacity);
+        mappedBytes -= victim->capacity;
+        buffers.erase(victim);
+    }
+    if (limitBytes > 0 && mappedBytes + capacity > limitBytes) {
+        if (required) {
+            std::cerr << "Błąd: Bufor chunka (" << capacity / (1024 * 1024) << " MB) nie mieści się w limicie pamięci "
+                      << limitBytes / (1024 * 1024) << " MB (zajęte " << mappedBytes / (1024 * 1024)
+                      << " MB) - zwiększ CIPHERDATA_BUFFER_MB" << std::endl;
+        }
+        return nullptr;
+    }
+
+    unsigned char* data = mapBuffer(capacity);
+    if (!data) {
+        std::cerr << "Błąd: Brak pamięci na bufor chunka (" << capacity / (1024 * 1024) << " MB)" << std::endl;
+        return nullptr;
+    }
+    buffers.push_back(Buffer{data, capacity, true});
+    mappedBytes += capacity;
+    peak = std::max(peak, mappedBytes);
+    return data;
+}
+
+void ChunkBufferPool::giveBack(unsigned char* data) {
+    if (!data) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Buffer& buffer : buffers) {
+        if (buffer.data == data) {
+            buffer.leased = false;
+            return;
+        }
+    }
+}
+
+size_t ChunkBufferPool::peakBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peak;
+}
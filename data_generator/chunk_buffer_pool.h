@@ -0,0 +1,65 @@
+#ifndef CHUNK_BUFFER_POOL_H
+#define CHUNK_BUFFER_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * Wspólna dla procesu pula buforów chunków (po ~100 MB).
+ *
+ * Bufory są mapowane raz, na dużych stronach (MAP_HUGETLB, a bez zarezerwowanych stron
+ * - THP przez MADV_HUGEPAGE) i od razu wypełniane stronami, więc przetwarzanie chunka nie
+ * płaci za alokację, zerowanie i błędy stron. Zwrócony bufor zostaje w puli i trafia do
+ * kolejnego klienta (np. z sinka generowania tekstu do sinka szyfrowania).
+ *
+ * Limit pamięci (CIPHERDATA_BUFFER_MB, domyślnie połowa pamięci fizycznej) ogranicza sumę
+ * rozmiarów zmapowanych buforów, więc szczytowe RSS buforów nie przekracza limitu. Przed
+ * odmową zwalniane są wolne bufory innych rozmiarów. tryLease() odmawia po cichu - klient
+ * zostaje przy buforach, które ma - a lease() (pierwszy bufor klienta, bez którego nie ruszy)
+ * zgłasza błąd: brak miejsca nawet na niego oznacza za mały limit dla tej konfiguracji.
+ */
+class ChunkBufferPool {
+public:
+    static constexpr size_t GRANULE = 2 * 1024 * 1024; // rozmiar dużej strony
+
+    // Pula procesu; limit w MB ze zmiennej CIPHERDATA_BUFFER_MB (0 = bez limitu),
+    // bez niej - połowa pamięci fizycznej
+    static ChunkBufferPool& shared();
+
+    // limitBytes == 0 oznacza brak limitu
+    explicit ChunkBufferPool(size_t limitBytes);
+    ~ChunkBufferPool();
+
+    ChunkBufferPool(const ChunkBufferPool&) = delete;
+    ChunkBufferPool& operator=(const ChunkBufferPool&) = delete;
+
+    // Bufor co najmniej `size` bajtów (wyrównany do GRANULE) w limicie; nullptr z komunikatem
+    // na stderr, gdy nowy bufor przekroczyłby limit albo brak pamięci
+    unsigned char* lease(size_t size);
+
+    // Jak lease(), ale bez komunikatu, gdy nowy bufor przekroczyłby limit
+    unsigned char* tryLease(size_t size);
+
+    void giveBack(unsigned char* buffer);
+
+    size_t limit() const { return limitBytes; }
+    size_t peakBytes();
+
+private:
+    struct Buffer {
+        unsigned char* data = nullptr;
+        size_t capacity = 0;
+        bool leased = false;
+    };
+
+    size_t limitBytes;
+    std::mutex mutex;
+    std::vector<Buffer> buffers;
+    size_t mappedBytes = 0;
+    size_t peak = 0;
+
+    unsigned char* take(size_t size, bool required);
+};
+
+#endif // CHUNK_BUFFER_POOL_H
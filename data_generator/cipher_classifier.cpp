@@ -0,0 +1,359 @@
+#include "cipher_classifier.h"
+#include "file_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <unistd.h>
+
+namespace {
+
+const size_t FIXED_HEADER_SIZE = 32;
+
+void put32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+void put64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint32_t get32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+uint64_t get64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+void putFloats(std::vector<unsigned char>& out, const std::vector<float>& values) {
+    size_t offset = out.size();
+    out.resize(offset + 4 * values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        put32(out.data() + offset + 4 * i, bits);
+    }
+}
+
+// Czyta count wartości float spod `offset`; false, gdy dane się kończą
+bool getFloats(const std::vector<unsigned char>& in, size_t& offset, size_t count, std::vector<float>& values) {
+    if (offset + 4 * count > in.size()) {
+        return false;
+    }
+    values.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = get32(in.data() + offset + 4 * i);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+    offset += 4 * count;
+    return true;
+}
+
+// Softmax w miejscu
+void softmax(float* values, size_t count) {
+    float maxValue = *std::max_element(values, values + count);
+    float sum = 0.0f;
+    for (size_t c = 0; c < count; c++) {
+        values[c] = std::exp(values[c] - maxValue);
+        sum += values[c];
+    }
+    for (size_t c = 0; c < count; c++) {
+        values[c] /= sum;
+    }
+}
+
+} // namespace
+
+bool CipherClassifier::train(const std::vector<FeatureTable>& tables, const ClassifierTrainingOptions& options,
+                             std::ostream& log) {
+    if (tables.empty()) {
+        std::cerr << "Błąd: Brak danych uczących" << std::endl;
+        return false;
+    }
+    featureNames = tables[0].names;
+    window = tables[0].windowSize;
+    classNames.clear();
+    std::vector<size_t> labels;
+    for (const auto& table : tables) {
+        if (table.names != featureNames || table.windowSize != window) {
+            std::cerr << "Błąd: Tabele cech mają różne kolumny albo rozmiar okna (" << table.value("source") << ")"
+                      << std::endl;
+            return false;
+        }
+        std::string label = table.value("label");
+        if (label.empty()) {
+            std::cerr << "Błąd: Tabela cech bez etykiety (" << table.value("source") << ")" << std::endl;
+            return false;
+        }
+        size_t index = std::find(classNames.begin(), classNames.end(), label) - classNames.begin();
+        if (index == classNames.size()) {
+            classNames.push_back(label);
+        }
+        labels.insert(labels.end(), table.rows, index);
+    }
+    if (classNames.size() < 2) {
+        std::cerr << "Błąd: Do uczenia potrzebne są co najmniej dwie klasy" << std::endl;
+        return false;
+    }
+
+    // Wiersze wszystkich tabel w jednej macierzy (wierszami)
+    const size_t F = featureNames.size();
+    const size_t C = classNames.size();
+    const size_t N = labels.size();
+    std::vector<float> x(N * F);
+    size_t row = 0;
+    for (const auto& table : tables) {
+        for (uint64_t r = 0; r < table.rows; r++, row++) {
+            for (size_t f = 0; f < F; f++) {
+                x[row * F + f] = table.at(r, f);
+            }
+        }
+    }
+    std::vector<size_t> trainRows(N);
+    std::iota(trainRows.begin(), trainRows.end(), 0);
+
+    // Standaryzacja na zbiorze uczącym; cechy stałe dostają skalę 0
+    std::vector<double> sum(F, 0.0), sumSquares(F, 0.0);
+    for (size_t r : trainRows) {
+        for (size_t f = 0; f < F; f++) {
+            double v = x[r * F + f];
+            sum[f] += v;
+            sumSquares[f] += v * v;
+        }
+    }
+    mean.assign(F, 0.0f);
+    scale.assign(F, 0.0f);
+    for (size_t f = 0; f < F; f++) {
+        double m = sum[f] / static_cast<double>(trainRows.size());
+        double variance = sumSquares[f] / static_cast<double>(trainRows.size()) - m * m;
+        mean[f] = static_cast<float>(m);
+        scale[f] = variance > 1e-18 ? static_cast<float>(1.0 / std::sqrt(variance)) : 0.0f;
+    }
+    for (size_t r = 0; r < N; r++) {
+        for (size_t f = 0; f < F; f++) {
+            x[r * F + f] = (x[r * F + f] - mean[f]) * scale[f];
+        }
+    }
+
+    // Minipartie SGD z malejącym krokiem; gradient entropii krzyżowej to p - one-hot
+    weights.assign(C * F, 0.0f);
+    bias.assign(C, 0.0f);
+    std::vector<float> gradWeights(C * F), gradBias(C), p(C);
+    std::mt19937_64 rng(options.seed);
+    const size_t batchSize = std::max<size_t>(options.batchSize, 1);
+    for (size_t epoch = 0; epoch < options.epochs; epoch++) {
+        std::shuffle(trainRows.begin(), trainRows.end(), rng);
+        const float rate = static_cast<float>(options.learningRate / std::sqrt(1.0 + epoch));
+        double loss = 0.0;
+        size_t correct = 0;
+        for (size_t begin = 0; begin < trainRows.size(); begin += batchSize) {
+            size_t end = std::min(trainRows.size(), begin + batchSize);
+            std::fill(gradWeights.begin(), gradWeights.end(), 0.0f);
+            std::fill(gradBias.begin(), gradBias.end(), 0.0f);
+            for (size_t i = begin; i < end; i++) {
+                const float* features = &x[trainRows[i] * F];
+                const size_t label = labels[trainRows[i]];
+                for (size_t c = 0; c < C; c++) {
+                    p[c] = bias[c] + std::inner_product(features, features + F, &weights[c * F], 0.0f);
+                }
+                softmax(p.data(), C);
+                loss -= std::log(std::max(p[label], 1e-30f));
+                correct += argmax(p.data()) == label;
+                p[label] -= 1.0f;
+                for (size_t c = 0; c < C; c++) {
+                    gradBias[c] += p[c];
+                    for (size_t f = 0; f < F; f++) {
+                        gradWeights[c * F + f] += p[c] * features[f];
+                    }
+                }
+            }
+            const float step = rate / static_cast<float>(end - begin);
+            const float decay = 1.0f - rate * static_cast<float>(options.l2);
+            for (size_t i = 0; i < C * F; i++) {
+                weights[i] = weights[i] * decay - step * gradWeights[i];
+            }
+            for (size_t c = 0; c < C; c++) {
+                bias[c] -= step * gradBias[c];
+            }
+        }
+        if (epoch + 1 == options.epochs || epoch % 10 == 0) {
+            log << "Epoka " << epoch + 1 << ": strata " << std::fixed << std::setprecision(4)
+                << loss / static_cast<double>(trainRows.size()) << ", dokładność uczenia " << std::setprecision(2)
+                << 100.0 * static_cast<double>(correct) / static_cast<double>(trainRows.size()) << "%" << std::endl;
+        }
+    }
+
+    return true;
+}
+
+bool CipherClassifier::evaluate(const std::vector<FeatureTable>& tables, std::ostream& log) const {
+    const size_t F = featureNames.size();
+    const size_t C = classNames.size();
+    std::vector<size_t> confusion(C * C, 0);
+    std::vector<float> rowFeatures(F), p(C);
+    size_t total = 0;
+    size_t correct = 0;
+    for (const auto& table : tables) {
+        if (table.names != featureNames || table.windowSize != window) {
+            std::cerr << "Błąd: Tabela walidacyjna ma inne kolumny albo rozmiar okna niż model ("
+                      << table.value("source") << ")" << std::endl;
+            return false;
+        }
+        size_t actual = std::find(classNames.begin(), classNames.end(), table.value("label")) - classNames.begin();
+        if (actual == C) {
+            std::cerr << "Błąd: Etykieta walidacyjna spoza klas modelu: " << table.value("label") << " ("
+                      << table.value("source") << ")" << std::endl;
+            return false;
+        }
+        for (uint64_t r = 0; r < table.rows; r++) {
+            for (size_t f = 0; f < F; f++) {
+                rowFeatures[f] = table.at(r, f);
+            }
+            predict(rowFeatures.data(), 1, p.data());
+            size_t predicted = argmax(p.data());
+            confusion[actual * C + predicted]++;
+            correct += predicted == actual;
+            total++;
+        }
+    }
+    if (total == 0) {
+        std::cerr << "Błąd: Brak okien walidacyjnych" << std::endl;
+        return false;
+    }
+
+    log << "Dokładność walidacji: " << std::fixed << std::setprecision(2)
+        << 100.0 * static_cast<double>(correct) / static_cast<double>(total) << "% (" << total << " okien z "
+        << tables.size() << " plików)" << std::endl;
+    log << "Macierz pomyłek (wiersze - prawdziwa klasa):" << std::endl << std::setw(12) << "";
+    for (const auto& name : classNames) {
+        log << std::setw(10) << name;
+    }
+    log << std::endl;
+    for (size_t actual = 0; actual < C; actual++) {
+        log << std::setw(12) << classNames[actual];
+        for (size_t predicted = 0; predicted < C; predicted++) {
+            log << std::setw(10) << confusion[actual * C + predicted];
+        }
+        log << std::endl;
+    }
+    return true;
+}
+
+void CipherClassifier::predict(const float* rows, size_t count, float* probabilities) const {
+    const size_t F = featureNames.size();
+    const size_t C = classNames.size();
+    std::vector<float> standardized(F);
+    for (size_t r = 0; r < count; r++) {
+        const float* features = rows + r * F;
+        for (size_t f = 0; f < F; f++) {
+            standardized[f] = (features[f] - mean[f]) * scale[f];
+        }
+        float* out = probabilities + r * C;
+        for (size_t c = 0; c < C; c++) {
+            out[c] = bias[c] + std::inner_product(standardized.begin(), standardized.end(), &weights[c * F], 0.0f);
+        }
+        softmax(out, C);
+    }
+}
+
+size_t CipherClassifier::argmax(const float* probabilities) const {
+    return std::max_element(probabilities, probabilities + classNames.size()) - probabilities;
+}
+
+bool CipherClassifier::save(const std::string& path) const {
+    std::string names;
+    for (const auto& name : classNames) {
+        names += name + "\n";
+    }
+    for (const auto& name : featureNames) {
+        names += name + "\n";
+    }
+    std::vector<unsigned char> encoded(FIXED_HEADER_SIZE + names.size());
+    std::memcpy(encoded.data(), CLASSIFIER_MAGIC, sizeof(CLASSIFIER_MAGIC));
+    put32(encoded.data() + 8, CLASSIFIER_VERSION);
+    put32(encoded.data() + 12, static_cast<uint32_t>(featureNames.size()));
+    put32(encoded.data() + 16, static_cast<uint32_t>(classNames.size()));
+    put32(encoded.data() + 20, static_cast<uint32_t>(names.size()));
+    put64(encoded.data() + 24, window);
+    std::memcpy(encoded.data() + FIXED_HEADER_SIZE, names.data(), names.size());
+    putFloats(encoded, mean);
+    putFloats(encoded, scale);
+    putFloats(encoded, weights);
+    putFloats(encoded, bias);
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można utworzyć pliku " << path << std::endl;
+        return false;
+    }
+    bool ok = pwriteAll(fd, encoded.data(), encoded.size(), 0);
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Błąd: Zapis do pliku " << path << " nie powiódł się" << std::endl;
+    }
+    return ok;
+}
+
+bool CipherClassifier::load(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można otworzyć pliku " << path << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> encoded(static_cast<size_t>(std::max<off_t>(lseek(fd, 0, SEEK_END), 0)));
+    bool ok = preadAll(fd, encoded.data(), encoded.size(), 0) == encoded.size();
+    ::close(fd);
+    if (!ok || encoded.size() < FIXED_HEADER_SIZE ||
+        std::memcmp(encoded.data(), CLASSIFIER_MAGIC, sizeof(CLASSIFIER_MAGIC)) != 0) {
+        std::cerr << "Błąd: " << path << " nie jest modelem klasyfikatora" << std::endl;
+        return false;
+    }
+    uint32_t version = get32(encoded.data() + 8);
+    size_t F = get32(encoded.data() + 12);
+    size_t C = get32(encoded.data() + 16);
+    size_t namesSize = get32(encoded.data() + 20);
+    if (version != CLASSIFIER_VERSION || FIXED_HEADER_SIZE + namesSize > encoded.size()) {
+        std::cerr << "Błąd: Nieobsługiwana wersja modelu klasyfikatora (" << version << ")" << std::endl;
+        return false;
+    }
+    window = get64(encoded.data() + 24);
+
+    std::vector<std::string> names;
+    std::string text(reinterpret_cast<const char*>(encoded.data() + FIXED_HEADER_SIZE), namesSize);
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        names.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    size_t offset = FIXED_HEADER_SIZE + namesSize;
+    ok = names.size() == C + F && getFloats(encoded, offset, F, mean) && getFloats(encoded, offset, F, scale) &&
+         getFloats(encoded, offset, C * F, weights) && getFloats(encoded, offset, C, bias);
+    if (!ok) {
+        std::cerr << "Błąd: Uszkodzony model klasyfikatora " << path << std::endl;
+        return false;
+    }
+    classNames.assign(names.begin(), names.begin() + C);
+    featureNames.assign(names.begin() + C, names.end());
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef CIPHER_CLASSIFIER_H
+#define CIPHER_CLASSIFIER_H
+
+#include "feature_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Klasyfikator okien danych (des / cast / blowfish / rc4 / tekst / gzip / wideo...) na
+ * wektorach cech z feature_extractor.h: wieloklasowa regresja logistyczna (softmax).
+ *
+ * Model to tablice float: średnie i odwrotności odchyleń cech (standaryzacja) oraz wagi
+ * klasy x cechy i wyrazy wolne - predykcja partii okien to jedno mnożenie macierzy.
+ * Plik modelu (little endian): 0 magic "CIPHMODL", 8 wersja u32, 12 liczba cech u32,
+ * 16 liczba klas u32, 20 długość nazw u32, 24 rozmiar okna u64, 32 nazwy klas i cech
+ * ("nazwa\n"), dalej float32: średnie, skale, wagi (wierszami po klasach), wyrazy wolne.
+ */
+
+const char CLASSIFIER_MAGIC[8] = {'C', 'I', 'P', 'H', 'M', 'O', 'D', 'L'};
+const uint32_t CLASSIFIER_VERSION = 1;
+
+struct ClassifierTrainingOptions {
+    size_t epochs = 30;
+    size_t batchSize = 256;
+    double learningRate = 0.1;
+    double l2 = 1e-4;          // regularyzacja wag
+    uint64_t seed = 1;         // kolejność przykładów w epokach
+};
+
+class CipherClassifier {
+public:
+    // Uczy model na wszystkich wierszach tabel cech; etykieta tabeli to metadana "label". Postęp
+    // i dokładność uczenia wypisuje do `log`. False przy niezgodnych tabelach (cechy, rozmiar
+    // okna) albo mniej niż dwóch klasach.
+    bool train(const std::vector<FeatureTable>& tables, const ClassifierTrainingOptions& options, std::ostream& log);
+
+    // Dokładność i macierz pomyłek na tabelach walidacyjnych do `log`. Okna z tego samego pliku
+    // (i klucza) co dane uczące są ze sobą skorelowane, więc tabele walidacyjne powinny pochodzić
+    // z osobnych plików wygenerowanych z innym ziarnem. False przy niezgodnych cechach / oknie
+    // albo etykiecie spoza klas modelu.
+    bool evaluate(const std::vector<FeatureTable>& tables, std::ostream& log) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    const std::vector<std::string>& classes() const { return classNames; }
+    const std::vector<std::string>& features() const { return featureNames; }
+    uint64_t windowSize() const { return window; }
+
+    // rows wierszy cech (wierszami, features().size() kolumn) -> prawdopodobieństwa klas
+    // (wierszami, classes().size() kolumn)
+    void predict(const float* rows, size_t count, float* probabilities) const;
+
+    // Numer najbardziej prawdopodobnej klasy w wierszu prawdopodobieństw
+    size_t argmax(const float* probabilities) const;
+
+private:
+    std::vector<std::string> classNames;
+    std::vector<std::string> featureNames;
+    uint64_t window = 0;
+    std::vector<float> mean;
+    std::vector<float> scale;   // 1 / odchylenie standardowe
+    std::vector<float> weights; // classes x features
+    std::vector<float> bias;
+};
+
+#endif // CIPHER_CLASSIFIER_H
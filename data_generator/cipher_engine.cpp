@@ -0,0 +1,138 @@
+#include "cipher_engine.h"
+#include "cipher_policies.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <openssl/sha.h>
+
+namespace {
+
+// Silnik dla jednej polityki - wirtualne jest tylko wywołanie na cały chunk, pętla po
+// blokach jest specjalizowana pod szyfr (cipher_policies.h)
+template <typename Policy>
+class PolicyCipherEngine final : public CipherEngine {
+private:
+    typename Policy::Key key;
+    bool keyReady;
+
+public:
+    explicit PolicyCipherEngine(const unsigned char key56[7]) : keyReady(Policy::setKey(key, key56)) {}
+
+    bool ready() const { return keyReady; }
+
+    const char* name() const override { return Policy::NAME; }
+
+    bool encrypt(const unsigned char* in, unsigned char* out, size_t size) const override {
+        return encryptWithPolicy<Policy>(key, in, out, size);
+    }
+};
+
+} // namespace
+
+std::unique_ptr<CipherEngine> createCipherEngine(const std::string& algorithm, const unsigned char key56[7]) {
+    std::unique_ptr<CipherEngine> engine;
+    forEachCipherPolicy(CipherPolicies(), [&](auto policy) {
+        using Policy = decltype(policy);
+        if (!engine && algorithm == Policy::NAME) {
+            auto candidate = std::make_unique<PolicyCipherEngine<Policy>>(key56);
+            if (candidate->ready()) {
+                engine = std::move(candidate);
+            }
+        }
+    });
+    return engine;
+}
+
+const std::vector<std::string>& cipherAlgorithms() {
+    static const std::vector<std::string> names = []() {
+        std::vector<std::string> list;
+        forEachCipherPolicy(CipherPolicies(), [&](auto policy) { list.push_back(decltype(policy)::NAME); });
+        return list;
+    }();
+    return names;
+}
+
+const std::vector<std::string>& defaultCipherAlgorithms() {
+    static const std::vector<std::string> names = []() {
+        std::vector<std::string> list;
+        forEachCipherPolicy(DefaultCipherPolicies(), [&](auto policy) { list.push_back(decltype(policy)::NAME); });
+        return list;
+    }();
+    return names;
+}
+
+bool selectCipherAlgorithms(const std::string& spec, std::vector<std::string>& algorithms) {
+    if (spec == "default") {
+        algorithms = defaultCipherAlgorithms();
+        return true;
+    }
+    if (spec == "all") {
+        algorithms = cipherAlgorithms();
+        return true;
+    }
+    algorithms.clear();
+    std::istringstream names(spec);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        const std::vector<std::string>& known = cipherAlgorithms();
+        if (std::find(known.begin(), known.end(), name) == known.end()) {
+            std::cerr << "Nieznany algorytm: " << name << " (dostępne: default, all";
+            for (const auto& algorithm : known) {
+                std::cerr << ", " << algorithm;
+            }
+            std::cerr << ")" << std::endl;
+            return false;
+        }
+        if (std::find(algorithms.begin(), algorithms.end(), name) == algorithms.end()) {
+            algorithms.push_back(name);
+        }
+    }
+    return !algorithms.empty();
+}
+
+unsigned int cipherSeedOffset(const std::string& algorithm) {
+    unsigned int offset = 0;
+    forEachCipherPolicy(CipherPolicies(), [&](auto policy) {
+        if (algorithm == decltype(policy)::NAME) {
+            offset = decltype(policy)::SEED_OFFSET;
+        }
+    });
+    return offset;
+}
+
+void generate56BitKey(unsigned int seed, unsigned char key56[7]) {
+    std::mt19937 keyGen(seed);
+    std::uniform_int_distribution<unsigned char> dist(0, 255);
+    for (int i = 0; i < 7; i++) {
+        key56[i] = dist(keyGen);
+    }
+}
+
+void expandCipherKey(const unsigned char key56[7], unsigned char* out, size_t size) {
+    unsigned char input[7 + 4];
+    memcpy(input, key56, 7);
+    for (uint32_t counter = 0; size > 0; counter++) {
+        for (int i = 0; i < 4; i++) {
+            input[7 + i] = static_cast<unsigned char>(counter >> (8 * i));
+        }
+        unsigned char digest[SHA256_DIGEST_LENGTH];
+        SHA256(input, sizeof(input), digest);
+        const size_t n = std::min(size, sizeof(digest));
+        memcpy(out, digest, n);
+        out += n;
+        size -= n;
+    }
+}
+
+std::string formatKeyHex(const unsigned char key56[7]) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (int i = 0; i < 7; i++) {
+        hex += digits[key56[i] >> 4];
+        hex += digits[key56[i] & 0x0f];
+    }
+    return hex;
+}
@@ -0,0 +1,60 @@
+#ifndef CIPHER_ENGINE_H
+#define CIPHER_ENGINE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Wspólny interfejs szyfrów używanych przez generatory danych (libcipherdata).
+ *
+ * Silnik przygotowuje harmonogram klucza raz, w konstruktorze, i szyfruje
+ * bezpośrednio do bufora należącego do wywołującego (in == out jest dozwolone).
+ * Każde wywołanie encrypt() jest niezależne: RC4 startuje od początku strumienia
+ * klucza, a niepełny ostatni blok ECB jest dopełniany zerami i obcinany - tak samo
+ * jak w dotychczasowych pętlach szyfrujących chunk po chunku.
+ * Metoda encrypt() jest const, więc jeden silnik może być używany z wielu wątków.
+ * False z encrypt() oznacza błąd szyfrowania (OpenSSL EVP) - zawartość `out` jest wtedy
+ * nieokreślona i wywołujący musi uznać plik za nieudany.
+ */
+class CipherEngine {
+public:
+    virtual ~CipherEngine() = default;
+
+    virtual const char* name() const = 0;
+    virtual bool encrypt(const unsigned char* in, unsigned char* out, size_t size) const = 0;
+
+    bool encryptInPlace(unsigned char* data, size_t size) const {
+        return encrypt(data, data, size);
+    }
+};
+
+// Algorytm wybierany raz, po nazwie, spośród cipherAlgorithms(); dla nieznanej nazwy albo szyfru
+// niedostępnego w tej instalacji OpenSSL zwraca nullptr
+std::unique_ptr<CipherEngine> createCipherEngine(const std::string& algorithm, const unsigned char key56[7]);
+
+// Nazwy wszystkich szyfrów (CipherPolicies z cipher_policies.h)
+const std::vector<std::string>& cipherAlgorithms();
+
+// Domyślny zestaw generatorów: "cast", "rc4", "des", "blowfish"
+const std::vector<std::string>& defaultCipherAlgorithms();
+
+// Lista algorytmów z wiersza poleceń: "default", "all" albo nazwy po przecinku
+// (np. "aes128-ctr,chacha20,xor"); false z komunikatem na stderr przy nieznanej nazwie
+bool selectCipherAlgorithms(const std::string& spec, std::vector<std::string>& algorithms);
+
+// Przesunięcie ziarna tekstu jawnego algorytmu względem ziarna bazowego (0 dla nieznanej nazwy)
+unsigned int cipherSeedOffset(const std::string& algorithm);
+
+// Klucz 56-bit wyprowadzany z ziarna tak jak we wszystkich generatorach
+void generate56BitKey(unsigned int seed, unsigned char key56[7]);
+
+// Dłuższy klucz (i IV) dla szyfrów spoza zestawu 56-bit, wyprowadzany z key56: SHA-256 z
+// key56 || licznik (u32 LE), bloki po kolei. Entropia zbioru danych pozostaje 56-bitowa.
+void expandCipherKey(const unsigned char key56[7], unsigned char* out, size_t size);
+
+// Klucz 56-bit szesnastkowo (jak w logach generatorów i metadanych zbiorów danych)
+std::string formatKeyHex(const unsigned char key56[7]);
+
+#endif // CIPHER_ENGINE_H
@@ -0,0 +1,358 @@
+#ifndef CIPHER_POLICIES_H
+#define CIPHER_POLICIES_H
+
+#include "cipher_engine.h"
+#include "des_bitslice.h"
+#include "ecb_kernels.h"
+#include "evp_cipher.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <openssl/des.h>
+#include <openssl/rc4.h>
+
+/**
+ * Szyfry generatorów jako typy-polityki wybierane w czasie kompilacji.
+ *
+ * Polityka opisuje jeden algorytm:
+ *   NAME        - nazwa w wierszu poleceń, ścieżkach i metadanych zbiorów danych
+ *   SEED_OFFSET - przesunięcie ziarna tekstu jawnego względem ziarna bazowego generatora
+ *   BLOCK_SIZE  - rozmiar bloku ECB; 0 oznacza, że polityka szyfruje cały chunk sama
+ *                 (szyfr strumieniowy albo tryb z łańcuchowaniem, np. CBC)
+ *   Key         - harmonogram klucza, przygotowywany raz na plik przez setKey(key, key56)
+ *                 (false, gdy szyfr jest niedostępny w tej instalacji OpenSSL)
+ * oraz encryptBlocks(key, in, out, blocks) dla pełnych bloków (szyfry blokowe, jądra bez
+ * błędów) albo encryptStream(key, in, out, size) startujące zawsze od początku strumienia
+ * klucza / IV i zwracające false, gdy szyfrowanie się nie powiodło (błąd OpenSSL EVP).
+ *
+ * encryptWithPolicy<P>() to pętla chunka skompilowana osobno dla każdej polityki, więc
+ * funkcja bloku jest wywoływana bezpośrednio (i może zostać wstawiona), a nazwa algorytmu
+ * jest porównywana tylko raz - przy tworzeniu silnika (cipher_engine.h). Nowy szyfr to nowy
+ * typ dopisany do DefaultCipherPolicies albo ExtendedCipherPolicies; generatory biorą listę
+ * algorytmów z cipher_engine.h (selectCipherAlgorithms).
+ *
+ * Szyfry spoza dawnego zestawu mają dłuższe klucze wyprowadzone z key56 (expandCipherKey),
+ * więc cały zbiór wciąż odtwarza się z jednego ziarna.
+ */
+
+// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+struct CastPolicy {
+    static constexpr const char* NAME = "cast";
+    static constexpr unsigned int SEED_OFFSET = 0;
+    static constexpr size_t BLOCK_SIZE = 8;
+    using Key = CAST_KEY;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        CAST_set_key(&key, 7, key56);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        castEcbEncryptBlocks(&key, in, out, blocks);
+    }
+};
+
+struct Rc4Policy {
+    static constexpr const char* NAME = "rc4";
+    static constexpr unsigned int SEED_OFFSET = 10000;
+    static constexpr size_t BLOCK_SIZE = 0;
+    using Key = RC4_KEY; // stan po RC4_set_key, kopiowany przy każdym wywołaniu
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        RC4_set_key(&key, 7, key56);
+        return true;
+    }
+
+    static bool encryptStream(const Key& key, const unsigned char* in, unsigned char* out, size_t size) {
+        RC4_KEY state = key;
+        RC4(&state, size, in, out);
+        return true;
+    }
+};
+
+struct DesPolicy {
+    static constexpr const char* NAME = "des";
+    static constexpr unsigned int SEED_OFFSET = 20000;
+    static constexpr size_t BLOCK_SIZE = 8;
+    using Key = std::unique_ptr<BitslicedDes>;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        // DES potrzebuje 8 bajtów - uzupełnienie zerem i ustawienie parzystości
+        unsigned char desKey8[8];
+        memcpy(desKey8, key56, 7);
+        desKey8[7] = 0;
+
+        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
+        key = std::make_unique<BitslicedDes>(desKey8);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        key->encryptBlocks(in, out, blocks);
+    }
+};
+
+struct BlowfishPolicy {
+    static constexpr const char* NAME = "blowfish";
+    static constexpr unsigned int SEED_OFFSET = 30000;
+    static constexpr size_t BLOCK_SIZE = 8;
+    using Key = BF_KEY;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        BF_set_key(&key, 7, key56);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        blowfishEcbEncryptBlocks(&key, in, out, blocks);
+    }
+};
+
+// Szyfr z OpenSSL EVP (evp_cipher.h); Derived podaje NAME, SEED_OFFSET i EVP_NAME
+template <typename Derived>
+struct EvpCipherPolicy {
+    static constexpr size_t BLOCK_SIZE = 0;
+    using Key = EvpCipherKey;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        return setEvpCipherKey(key, Derived::EVP_NAME, key56);
+    }
+
+    static bool encryptStream(const Key& key, const unsigned char* in, unsigned char* out, size_t size) {
+        return evpEncrypt(key, in, out, size);
+    }
+};
+
+struct Aes128EcbPolicy : EvpCipherPolicy<Aes128EcbPolicy> {
+    static constexpr const char* NAME = "aes128-ecb";
+    static constexpr unsigned int SEED_OFFSET = 40000;
+    static constexpr const char* EVP_NAME = "AES-128-ECB";
+};
+
+struct Aes128CbcPolicy : EvpCipherPolicy<Aes128CbcPolicy> {
+    static constexpr const char* NAME = "aes128-cbc";
+    static constexpr unsigned int SEED_OFFSET = 50000;
+    static constexpr const char* EVP_NAME = "AES-128-CBC";
+};
+
+struct Aes128CtrPolicy : EvpCipherPolicy<Aes128CtrPolicy> {
+    static constexpr const char* NAME = "aes128-ctr";
+    static constexpr unsigned int SEED_OFFSET = 60000;
+    static constexpr const char* EVP_NAME = "AES-128-CTR";
+};
+
+struct Aes256EcbPolicy : EvpCipherPolicy<Aes256EcbPolicy> {
+    static constexpr const char* NAME = "aes256-ecb";
+    static constexpr unsigned int SEED_OFFSET = 70000;
+    static constexpr const char* EVP_NAME = "AES-256-ECB";
+};
+
+struct Aes256CbcPolicy : EvpCipherPolicy<Aes256CbcPolicy> {
+    static constexpr const char* NAME = "aes256-cbc";
+    static constexpr unsigned int SEED_OFFSET = 80000;
+    static constexpr const char* EVP_NAME = "AES-256-CBC";
+};
+
+struct Aes256CtrPolicy : EvpCipherPolicy<Aes256CtrPolicy> {
+    static constexpr const char* NAME = "aes256-ctr";
+    static constexpr unsigned int SEED_OFFSET = 90000;
+    static constexpr const char* EVP_NAME = "AES-256-CTR";
+};
+
+// 3DES EDE (trzy klucze) w ECB na bitslicowanym DES - szybciej niż DES-EDE3 z OpenSSL
+struct TripleDesPolicy {
+    static constexpr const char* NAME = "3des";
+    static constexpr unsigned int SEED_OFFSET = 100000;
+    static constexpr size_t BLOCK_SIZE = 8;
+    static constexpr size_t SLICE_BLOCKS = 8192; // trzy etapy na 64 KB naraz, dane zostają w L2
+
+    struct Key {
+        std::unique_ptr<BitslicedDes> encrypt1;
+        std::unique_ptr<BitslicedDes> decrypt2;
+        std::unique_ptr<BitslicedDes> encrypt3;
+    };
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        unsigned char keys[24];
+        expandCipherKey(key56, keys, sizeof(keys));
+        for (int i = 0; i < 3; i++) {
+            DES_set_odd_parity(reinterpret_cast<DES_cblock*>(keys + 8 * i));
+        }
+        key.encrypt1 = std::make_unique<BitslicedDes>(keys);
+        key.decrypt2 = std::make_unique<BitslicedDes>(keys + 8, true);
+        key.encrypt3 = std::make_unique<BitslicedDes>(keys + 16);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        for (size_t i = 0; i < blocks; i += SLICE_BLOCKS) {
+            const size_t n = std::min(SLICE_BLOCKS, blocks - i);
+            key.encrypt1->encryptBlocks(in + 8 * i, out + 8 * i, n);
+            key.decrypt2->encryptBlocks(out + 8 * i, out + 8 * i, n);
+            key.encrypt3->encryptBlocks(out + 8 * i, out + 8 * i, n);
+        }
+    }
+};
+
+// RC2 w ECB, klucz 128-bit (efektywnie 128 bitów, jak domyślne RC2-ECB w EVP)
+struct Rc2Policy {
+    static constexpr const char* NAME = "rc2";
+    static constexpr unsigned int SEED_OFFSET = 110000;
+    static constexpr size_t BLOCK_SIZE = 8;
+    using Key = RC2_KEY;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        unsigned char key16[16];
+        expandCipherKey(key56, key16, sizeof(key16));
+        RC2_set_key(&key, sizeof(key16), key16, 128);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        rc2EcbEncryptBlocks(&key, in, out, blocks);
+    }
+};
+
+// IDEA w ECB, klucz 128-bit
+struct IdeaPolicy {
+    static constexpr const char* NAME = "idea";
+    static constexpr unsigned int SEED_OFFSET = 120000;
+    static constexpr size_t BLOCK_SIZE = 8;
+    using Key = IdeaKey;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        unsigned char key16[16];
+        expandCipherKey(key56, key16, sizeof(key16));
+        ideaSetKey(&key, key16);
+        return true;
+    }
+
+    static void encryptBlocks(const Key& key, const unsigned char* in, unsigned char* out, size_t blocks) {
+        ideaEcbEncryptBlocks(&key, in, out, blocks);
+    }
+};
+
+struct ChaCha20Policy : EvpCipherPolicy<ChaCha20Policy> {
+    static constexpr const char* NAME = "chacha20";
+    static constexpr unsigned int SEED_OFFSET = 130000;
+    static constexpr const char* EVP_NAME = "ChaCha20";
+};
+
+// Powtarzany klucz 56-bit rozwinięty do wspólnej wielokrotności 7 i 64 bajtów - pętla po
+// wzorcu bez dzielenia modulo, którą kompilator wektoryzuje
+struct RepeatingKey {
+    static constexpr size_t PATTERN = 7 * 64;
+    unsigned char pattern[PATTERN];
+};
+
+template <typename Op>
+inline void applyRepeatingKey(const RepeatingKey& key, const unsigned char* in, unsigned char* out, size_t size,
+                              Op op) {
+    size_t i = 0;
+    for (; i + RepeatingKey::PATTERN <= size; i += RepeatingKey::PATTERN) {
+        for (size_t j = 0; j < RepeatingKey::PATTERN; j++) {
+            out[i + j] = op(in[i + j], key.pattern[j]);
+        }
+    }
+    for (size_t j = 0; i + j < size; j++) {
+        out[i + j] = op(in[i + j], key.pattern[j]);
+    }
+}
+
+inline bool setRepeatingKey(RepeatingKey& key, const unsigned char key56[7]) {
+    for (size_t j = 0; j < RepeatingKey::PATTERN; j++) {
+        key.pattern[j] = key56[j % 7];
+    }
+    return true;
+}
+
+// Trywialne zaciemnienie: XOR z powtarzanym kluczem (okres 7 bajtów)
+struct XorPolicy {
+    static constexpr const char* NAME = "xor";
+    static constexpr unsigned int SEED_OFFSET = 140000;
+    static constexpr size_t BLOCK_SIZE = 0;
+    using Key = RepeatingKey;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        return setRepeatingKey(key, key56);
+    }
+
+    static bool encryptStream(const Key& key, const unsigned char* in, unsigned char* out, size_t size) {
+        applyRepeatingKey(key, in, out, size, [](unsigned char a, unsigned char b) {
+            return static_cast<unsigned char>(a ^ b);
+        });
+        return true;
+    }
+};
+
+// Vigenère na bajtach: dodawanie powtarzanego klucza modulo 256
+struct VigenerePolicy {
+    static constexpr const char* NAME = "vigenere";
+    static constexpr unsigned int SEED_OFFSET = 150000;
+    static constexpr size_t BLOCK_SIZE = 0;
+    using Key = RepeatingKey;
+
+    static bool setKey(Key& key, const unsigned char key56[7]) {
+        return setRepeatingKey(key, key56);
+    }
+
+    static bool encryptStream(const Key& key, const unsigned char* in, unsigned char* out, size_t size) {
+        applyRepeatingKey(key, in, out, size, [](unsigned char a, unsigned char b) {
+            return static_cast<unsigned char>(a + b);
+        });
+        return true;
+    }
+};
+
+#pragma GCC diagnostic pop
+
+template <typename... Policies>
+struct CipherList {};
+
+template <typename... First, typename... Second>
+CipherList<First..., Second...> joinCipherLists(CipherList<First...>, CipherList<Second...>);
+
+// Domyślny zestaw generatorów - klucze 56-bit, jak w dotychczasowych zbiorach danych
+using DefaultCipherPolicies = CipherList<CastPolicy, Rc4Policy, DesPolicy, BlowfishPolicy>;
+
+// Szyfry współczesne, pozostałe stare szyfry i trywialne zaciemnianie - wybierane jawnie
+using ExtendedCipherPolicies = CipherList<Aes128EcbPolicy, Aes128CbcPolicy, Aes128CtrPolicy, Aes256EcbPolicy,
+                                          Aes256CbcPolicy, Aes256CtrPolicy, TripleDesPolicy, Rc2Policy, IdeaPolicy,
+                                          ChaCha20Policy, XorPolicy, VigenerePolicy>;
+
+// Wszystkie szyfry, w kolejności cipherAlgorithms()
+using CipherPolicies = decltype(joinCipherLists(DefaultCipherPolicies(), ExtendedCipherPolicies()));
+
+// Wywołuje fn(Policy()) dla każdej polityki z listy, po kolei
+template <typename Fn, typename... Policies>
+void forEachCipherPolicy(CipherList<Policies...>, Fn&& fn) {
+    (fn(Policies()), ...);
+}
+
+// Szyfruje chunk polityką: pełne bloki hurtowo prosto do wyjścia, tylko niepełny ostatni
+// blok jest dopełniany zerami i obcinany po zaszyfrowaniu (in == out jest dozwolone).
+// False tylko po błędzie encryptStream()
+template <typename Policy>
+inline bool encryptWithPolicy(const typename Policy::Key& key, const unsigned char* in, unsigned char* out,
+                              size_t size) {
+    if constexpr (Policy::BLOCK_SIZE == 0) {
+        return Policy::encryptStream(key, in, out, size);
+    } else {
+        const size_t fullBlocks = size / Policy::BLOCK_SIZE;
+        const size_t tail = size % Policy::BLOCK_SIZE;
+        Policy::encryptBlocks(key, in, out, fullBlocks);
+        if (tail > 0) {
+            unsigned char block[Policy::BLOCK_SIZE] = {0};
+            memcpy(block, in + fullBlocks * Policy::BLOCK_SIZE, tail);
+            Policy::encryptBlocks(key, block, block, 1);
+            memcpy(out + fullBlocks * Policy::BLOCK_SIZE, block, tail);
+        }
+        return true;
+    }
+}
+
+#endif // CIPHER_POLICIES_H
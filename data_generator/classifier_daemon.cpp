@@ -0,0 +1,393 @@
+#include "cipher_classifier.h"
+#include "feature_extractor.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Usługa klasyfikacji strumieni danych (model z train_classifier).
+ *
+ * Użycie: classifier_daemon <model> [gniazdo|-] [partia=32] [opóźnienie_ms=5]
+ *   gniazdo       - ścieżka gniazda Unix; połączenia są obsługiwane równolegle w jednej pętli
+ *                   poll(), a ich okna trafiają do wspólnej partii. "-" lub brak - strumień
+ *                   ze stdin, wyniki na stdout
+ *   partia        - najwięcej okien w jednej partii (cechy liczone równolegle, jedna predykcja)
+ *   opóźnienie_ms - najdłuższe czekanie okna na dopełnienie partii: termin najstarszego okna
+ *                   jest limitem czasu poll(), więc partia wychodzi na czas także wtedy, gdy
+ *                   dane wciąż napływają
+ *
+ * Strumień jest dzielony na okna o rozmiarze z modelu; dla każdego pełnego okna wychodzi
+ * linia "<numer okna>\t<klasa>\t<prawdopodobieństwo>". Niepełne okno na końcu strumienia jest
+ * pomijane. Milczący albo nieodbierający wyników klient nie wstrzymuje pozostałych (gniazda
+ * nieblokujące, wyniki buforowane per połączenie). Po każdym strumieniu na stderr trafiają
+ * liczniki: okna, przepustowość oraz opóźnienie P50 / P99 (od odczytu ostatniego bajtu okna
+ * do przekazania wyniku).
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t LATENCY_SAMPLES = 65536; // ostatnie pomiary do percentyli
+
+struct ServiceStats {
+    uint64_t windows = 0;
+    uint64_t batches = 0;
+    uint64_t bytes = 0;
+    double busySeconds = 0.0;             // cechy + predykcja
+    Clock::time_point start = Clock::now();
+    std::vector<double> latencies;        // [ms], pierścień LATENCY_SAMPLES
+    size_t nextLatency = 0;
+
+    void addLatency(double milliseconds) {
+        if (latencies.size() < LATENCY_SAMPLES) {
+            latencies.push_back(milliseconds);
+        } else {
+            latencies[nextLatency] = milliseconds;
+            nextLatency = (nextLatency + 1) % LATENCY_SAMPLES;
+        }
+    }
+
+    double percentile(double q) const {
+        if (latencies.empty()) {
+            return 0.0;
+        }
+        std::vector<double> sorted(latencies);
+        size_t k = std::min(sorted.size() - 1, static_cast<size_t>(q * static_cast<double>(sorted.size())));
+        std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+        return sorted[k];
+    }
+
+    void report(std::ostream& out) const {
+        std::chrono::duration<double> wall = Clock::now() - start;
+        const double gigabytes = static_cast<double>(bytes) / 1e9;
+        out << "Okna: " << windows << " w " << batches << " partiach, dane: " << std::fixed << std::setprecision(3)
+            << gigabytes << " GB" << std::endl;
+        out << "Przepustowość: " << (busySeconds > 0.0 ? gigabytes / busySeconds : 0.0) << " GB/s w pracy, "
+            << (wall.count() > 0.0 ? gigabytes / wall.count() : 0.0) << " GB/s od startu" << std::endl;
+        out << "Opóźnienie: P50 " << percentile(0.50) << " ms, P99 " << percentile(0.99) << " ms" << std::endl;
+    }
+};
+
+// Jedno źródło okien: połączenie gniazda albo stdin / stdout
+struct Client {
+    int in = -1;
+    int out = -1;
+    std::vector<unsigned char> partial; // niepełne okno
+    size_t filled = 0;
+    uint64_t windowIndex = 0;           // numer następnego pełnego okna
+    size_t pending = 0;                 // okna klienta w bieżącej partii
+    std::string output;                 // wyniki czekające na zapis
+    bool ended = false;                 // koniec strumienia (albo błąd)
+    bool failed = false;                // błąd odczytu / zapisu - wyniki są porzucane
+};
+
+// Partia okien ze wszystkich połączeń
+class BatchClassifier {
+public:
+    BatchClassifier(const CipherClassifier& model, size_t batchSize, int maxDelayMs, ServiceStats& stats)
+        : model(model), windowSize(model.windowSize()), batchSize(batchSize), maxDelay(maxDelayMs), stats(stats),
+          buffer(batchSize * windowSize), features(batchSize * model.features().size()),
+          probabilities(batchSize * model.classes().size()) {
+        for (size_t w = 0; w < pool.workerCount(); w++) {
+            extractors.push_back(std::make_unique<FeatureExtractor>());
+        }
+    }
+
+    size_t window() const { return windowSize; }
+
+    // Dodaje pełne okno klienta; pełna partia jest od razu klasyfikowana
+    void add(Client& client, const unsigned char* data, Clock::time_point arrival) {
+        std::memcpy(buffer.data() + entries.size() * windowSize, data, windowSize);
+        entries.push_back({&client, client.windowIndex++, arrival});
+        client.pending++;
+        if (entries.size() == batchSize) {
+            flush();
+        }
+    }
+
+    // Limit czasu poll(): ms do terminu najstarszego okna partii (0 - termin minął), -1 bez okien
+    int timeoutMs() const {
+        if (entries.empty()) {
+            return -1;
+        }
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(entries.front().arrival + maxDelay - Clock::now());
+        return static_cast<int>(std::max<long long>(remaining.count(), 0));
+    }
+
+    // Klasyfikuje partię; wyniki trafiają do Client::output
+    void flush() {
+        const size_t pending = entries.size();
+        if (pending == 0) {
+            return;
+        }
+        Clock::time_point begin = Clock::now();
+        const size_t F = model.features().size();
+        for (size_t k = 0; k < pending; k++) {
+            pool.submit([this, k, F](size_t worker) {
+                extractors[worker]->extract(buffer.data() + k * windowSize, windowSize, features.data() + k * F);
+            });
+        }
+        pool.wait();
+        model.predict(features.data(), pending, probabilities.data());
+
+        const size_t C = model.classes().size();
+        for (size_t k = 0; k < pending; k++) {
+            const float* p = probabilities.data() + k * C;
+            size_t best = model.argmax(p);
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(4) << entries[k].index << "\t" << model.classes()[best] << "\t"
+                 << p[best] << "\n";
+            Client& client = *entries[k].client;
+            if (!client.failed) {
+                client.output += line.str();
+            }
+            client.pending--;
+        }
+
+        Clock::time_point done = Clock::now();
+        for (const Entry& entry : entries) {
+            stats.addLatency(std::chrono::duration<double, std::milli>(done - entry.arrival).count());
+        }
+        stats.windows += pending;
+        stats.batches++;
+        stats.bytes += pending * windowSize;
+        stats.busySeconds += std::chrono::duration<double>(done - begin).count();
+        entries.clear();
+    }
+
+private:
+    struct Entry {
+        Client* client;
+        uint64_t index;
+        Clock::time_point arrival;
+    };
+
+    const CipherClassifier& model;
+    const size_t windowSize;
+    const size_t batchSize;
+    const std::chrono::milliseconds maxDelay;
+    ServiceStats& stats;
+
+    WorkStealingPool pool;
+    std::vector<std::unique_ptr<FeatureExtractor>> extractors;
+    std::vector<unsigned char> buffer; // okna partii jedno za drugim
+    std::vector<float> features;
+    std::vector<float> probabilities;
+    std::vector<Entry> entries;        // po kolejności napływu
+};
+
+// Czyta dostępne dane klienta (co najwyżej do końca bieżącego okna)
+void readClient(Client& client, BatchClassifier& batcher) {
+    const size_t windowSize = batcher.window();
+    ssize_t n = ::read(client.in, client.partial.data() + client.filled, windowSize - client.filled);
+    if (n < 0) {
+        if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+            client.failed = client.ended = true;
+        }
+        return;
+    }
+    if (n == 0) {
+        client.ended = true;
+        return;
+    }
+    client.filled += static_cast<size_t>(n);
+    if (client.filled == windowSize) {
+        batcher.add(client, client.partial.data(), Clock::now());
+        client.filled = 0;
+    }
+}
+
+// Wysyła zbuforowane wyniki, dopóki gniazdo je przyjmuje
+void writeClient(Client& client) {
+    while (!client.output.empty() && !client.failed) {
+        ssize_t n = ::write(client.out, client.output.data(), client.output.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            client.failed = client.ended = true;
+            break;
+        }
+        client.output.erase(0, static_cast<size_t>(n));
+    }
+    if (client.failed) {
+        client.output.clear();
+    }
+}
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int listenUnixSocket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Błąd: Za długa ścieżka gniazda " << path << std::endl;
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można utworzyć gniazda" << std::endl;
+        return -1;
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 16) != 0) {
+        std::cerr << "Błąd: Nie można nasłuchiwać na " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Użycie: " << argv[0] << " <model> [gniazdo|-] [partia=32] [opóźnienie_ms=5]" << std::endl;
+        return 1;
+    }
+    std::string socketPath = argc > 2 ? argv[2] : "-";
+    size_t batchSize = 32;
+    int maxDelayMs = 5;
+    if (argc > 3) {
+        batchSize = std::max<size_t>(std::stoul(argv[3]), 1);
+    }
+    if (argc > 4) {
+        maxDelayMs = std::stoi(argv[4]);
+    }
+
+    CipherClassifier model;
+    if (!model.load(argv[1])) {
+        return 1;
+    }
+    if (model.features() != FeatureExtractor::featureNames() || model.windowSize() == 0) {
+        std::cerr << "Błąd: Model uczony na innym zestawie cech" << std::endl;
+        return 1;
+    }
+    // Klient, który się rozłączy, nie może zakończyć usługi
+    std::signal(SIGPIPE, SIG_IGN);
+
+    ServiceStats stats;
+    BatchClassifier batcher(model, batchSize, maxDelayMs, stats);
+    std::cerr << "Model: " << argv[1] << ", klasy: " << model.classes().size() << ", okno: "
+              << model.windowSize() / 1024 << " KB, partia: " << batchSize << ", opóźnienie: " << maxDelayMs << " ms"
+              << std::endl;
+
+    std::vector<std::unique_ptr<Client>> clients;
+    int listener = -1;
+    if (socketPath == "-") {
+        auto client = std::make_unique<Client>();
+        client->in = STDIN_FILENO;
+        client->out = STDOUT_FILENO;
+        client->partial.resize(batcher.window());
+        clients.push_back(std::move(client));
+    } else {
+        listener = listenUnixSocket(socketPath);
+        if (listener < 0 || !setNonBlocking(listener)) {
+            return 1;
+        }
+        std::cerr << "Nasłuch: " << socketPath << std::endl;
+    }
+
+    bool ok = true;
+    std::vector<pollfd> descriptors;
+    while (listener >= 0 || !clients.empty()) {
+        // Termin najstarszego okna minął - partia wychodzi niepełna, nawet gdy dane wciąż napływają
+        if (batcher.timeoutMs() == 0) {
+            batcher.flush();
+        }
+        for (auto& client : clients) {
+            writeClient(*client);
+        }
+
+        // Zakończone strumienie: wszystkie okna sklasyfikowane i wyniki wysłane
+        for (size_t i = 0; i < clients.size();) {
+            Client& client = *clients[i];
+            if (!client.ended || client.pending > 0 || !client.output.empty()) {
+                i++;
+                continue;
+            }
+            if (client.failed) {
+                std::cerr << "Połączenie przerwane" << std::endl;
+                ok = false;
+            }
+            if (listener >= 0) {
+                ::close(client.in);
+            }
+            stats.report(std::cerr);
+            clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        if (listener < 0 && clients.empty()) {
+            break;
+        }
+
+        descriptors.clear();
+        if (listener >= 0) {
+            descriptors.push_back({listener, POLLIN, 0});
+        }
+        for (auto& client : clients) {
+            descriptors.push_back({client->ended ? -1 : client->in, POLLIN, 0});
+            descriptors.push_back({client->output.empty() ? -1 : client->out, POLLOUT, 0});
+        }
+        int ready = ::poll(descriptors.data(), descriptors.size(), batcher.timeoutMs());
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Błąd: poll: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        size_t next = 0;
+        if (listener >= 0 && (descriptors[next++].revents & POLLIN)) {
+            int connection = ::accept(listener, nullptr, nullptr);
+            if (connection >= 0 && setNonBlocking(connection)) {
+                auto client = std::make_unique<Client>();
+                client->in = client->out = connection;
+                client->partial.resize(batcher.window());
+                clients.push_back(std::move(client));
+            } else if (connection >= 0) {
+                ::close(connection);
+            } else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Błąd: accept: " << std::strerror(errno) << std::endl;
+                break;
+            }
+        }
+        const size_t polled = (descriptors.size() - next) / 2;
+        for (size_t c = 0; c < polled; c++) {
+            Client& client = *clients[c];
+            if (descriptors[next + 2 * c].revents & (POLLIN | POLLHUP | POLLERR)) {
+                readClient(client, batcher);
+                if (client.ended && client.pending > 0) {
+                    // Koniec strumienia - nie ma na co czekać z jego oknami
+                    batcher.flush();
+                }
+            }
+            if (descriptors[next + 2 * c + 1].revents & (POLLOUT | POLLHUP | POLLERR)) {
+                writeClient(client);
+            }
+        }
+    }
+
+    if (listener >= 0) {
+        ::close(listener);
+        ::unlink(socketPath.c_str());
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "dataset_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <zlib.h>
+
+namespace {
+
+const size_t FIXED_HEADER_SIZE = 64;
+const uint32_t ENTRY_HAS_STATS = 1;
+
+void put32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+void put64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+void putDouble(unsigned char* out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put64(out, bits);
+}
+
+uint32_t get32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+uint64_t get64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+double getDouble(const unsigned char* in) {
+    uint64_t bits = get64(in);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+void accumulateByteHistogram(const unsigned char* data, size_t size, uint64_t* histogram) {
+    // Cztery histogramy naraz - kolejne bajty nie czekają na zapis tego samego licznika
+    uint64_t histograms[4][256] = {};
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        histograms[0][data[i]]++;
+        histograms[1][data[i + 1]]++;
+        histograms[2][data[i + 2]]++;
+        histograms[3][data[i + 3]]++;
+    }
+    for (; i < size; i++) {
+        histograms[0][data[i]]++;
+    }
+    for (size_t b = 0; b < 256; b++) {
+        histogram[b] += histograms[0][b] + histograms[1][b] + histograms[2][b] + histograms[3][b];
+    }
+}
+
+DatasetChunkStats computeDatasetChunkStats(const unsigned char* data, size_t size) {
+    DatasetChunkStats stats;
+    if (size == 0) {
+        return stats;
+    }
+    uint64_t histogram[256] = {};
+    accumulateByteHistogram(data, size, histogram);
+
+    const double expected = static_cast<double>(size) / 256.0;
+    for (size_t b = 0; b < 256; b++) {
+        stats.ones += histogram[b] * static_cast<uint64_t>(__builtin_popcount(static_cast<unsigned>(b)));
+        double diff = static_cast<double>(histogram[b]) - expected;
+        stats.byteChiSquare += diff * diff / expected;
+        if (histogram[b] > 0) {
+            double p = static_cast<double>(histogram[b]) / static_cast<double>(size);
+            stats.byteEntropy -= p * std::log2(p);
+        }
+    }
+    return stats;
+}
+
+std::string DatasetHeader::value(const std::string& key) const {
+    for (const auto& entry : metadata) {
+        if (entry.first == key) {
+            return entry.second;
+        }
+    }
+    return "";
+}
+
+bool isDatasetContainer(const unsigned char* data, size_t size) {
+    return size >= sizeof(DATASET_MAGIC) && std::memcmp(data, DATASET_MAGIC, sizeof(DATASET_MAGIC)) == 0;
+}
+
+bool encodeDatasetHeader(const DatasetHeader& header, unsigned char* out) {
+    std::string metadata;
+    for (const auto& entry : header.metadata) {
+        metadata += entry.first + "=" + entry.second + "\n";
+    }
+    if (FIXED_HEADER_SIZE + metadata.size() > DATASET_HEADER_SIZE) {
+        std::cerr << "Błąd: Metadane nie mieszczą się w nagłówku (" << metadata.size() << " B)" << std::endl;
+        return false;
+    }
+
+    std::memset(out, 0, DATASET_HEADER_SIZE);
+    std::memcpy(out, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+    put32(out + 8, DATASET_VERSION);
+    put32(out + 12, static_cast<uint32_t>(DATASET_HEADER_SIZE));
+    put64(out + 16, header.chunkSize);
+    put64(out + 24, header.payloadSize);
+    put64(out + 32, header.chunkCount);
+    put64(out + 40, header.indexOffset);
+    put32(out + 48, static_cast<uint32_t>(DATASET_INDEX_ENTRY_SIZE));
+    put32(out + 52, header.indexCrc);
+    put32(out + 56, static_cast<uint32_t>(metadata.size()));
+    std::memcpy(out + FIXED_HEADER_SIZE, metadata.data(), metadata.size());
+    return true;
+}
+
+bool decodeDatasetHeader(const unsigned char* data, size_t size, DatasetHeader& header) {
+    if (size < DATASET_HEADER_SIZE || !isDatasetContainer(data, size)) {
+        std::cerr << "Błąd: Brak nagłówka kontenera zbioru danych" << std::endl;
+        return false;
+    }
+    uint32_t version = get32(data + 8);
+    uint32_t headerSize = get32(data + 12);
+    uint32_t entrySize = get32(data + 48);
+    uint32_t metadataSize = get32(data + 56);
+    if (version != DATASET_VERSION || headerSize != DATASET_HEADER_SIZE || entrySize != DATASET_INDEX_ENTRY_SIZE ||
+        FIXED_HEADER_SIZE + metadataSize > DATASET_HEADER_SIZE) {
+        std::cerr << "Błąd: Nieobsługiwana wersja kontenera zbioru danych (" << version << ")" << std::endl;
+        return false;
+    }
+
+    header.dataOffset = headerSize;
+    header.chunkSize = get64(data + 16);
+    header.payloadSize = get64(data + 24);
+    header.chunkCount = get64(data + 32);
+    header.indexOffset = get64(data + 40);
+    header.indexCrc = get32(data + 52);
+
+    header.metadata.clear();
+    const char* text = reinterpret_cast<const char*>(data + FIXED_HEADER_SIZE);
+    std::string metadata(text, metadataSize);
+    size_t begin = 0;
+    while (begin < metadata.size()) {
+        size_t end = metadata.find('\n', begin);
+        if (end == std::string::npos) {
+            end = metadata.size();
+        }
+        std::string line = metadata.substr(begin, end - begin);
+        size_t separator = line.find('=');
+        if (separator != std::string::npos) {
+            header.metadata.emplace_back(line.substr(0, separator), line.substr(separator + 1));
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+void encodeDatasetIndexEntry(const DatasetIndexEntry& entry, unsigned char* out) {
+    put64(out, entry.offset);
+    put64(out + 8, entry.size);
+    put32(out + 16, entry.crc);
+    put32(out + 20, entry.hasStats ? ENTRY_HAS_STATS : 0);
+    put64(out + 24, entry.stats.ones);
+    putDouble(out + 32, entry.stats.byteChiSquare);
+    putDouble(out + 40, entry.stats.byteEntropy);
+}
+
+DatasetIndexEntry decodeDatasetIndexEntry(const unsigned char* in) {
+    DatasetIndexEntry entry;
+    entry.offset = get64(in);
+    entry.size = get64(in + 8);
+    entry.crc = get32(in + 16);
+    entry.hasStats = (get32(in + 20) & ENTRY_HAS_STATS) != 0;
+    entry.stats.ones = get64(in + 24);
+    entry.stats.byteChiSquare = getDouble(in + 32);
+    entry.stats.byteEntropy = getDouble(in + 40);
+    return entry;
+}
+
+uint32_t datasetChecksum(const unsigned char* data, size_t size) {
+    uLong crc = crc32(0, Z_NULL, 0);
+    const size_t piece = 1u << 30;
+    while (size > 0) {
+        size_t count = std::min(size, piece);
+        crc = crc32(crc, data, static_cast<uInt>(count));
+        data += count;
+        size -= count;
+    }
+    return static_cast<uint32_t>(crc);
+}
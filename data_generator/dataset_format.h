@@ -0,0 +1,83 @@
+#ifndef DATASET_FORMAT_H
+#define DATASET_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Kontener zbioru danych (.bin) - samoopisujący plik szyfrogramu.
+ *
+ *   [0, 4096)                      nagłówek: pola stałe + metadane "klucz=wartość\n"
+ *   [4096, 4096 + payloadSize)     dane: chunki po chunkSize bajtów (ostatni krótszy)
+ *   [indexOffset, ...)             indeks: wpis DATASET_INDEX_ENTRY_SIZE bajtów na chunk
+ *
+ * Pola stałe nagłówka (little endian):
+ *   0 magic "CIPHDATA", 8 wersja u32, 12 rozmiar nagłówka u32, 16 chunkSize u64,
+ *   24 payloadSize u64, 32 chunkCount u64, 40 indexOffset u64, 48 rozmiar wpisu indeksu u32,
+ *   52 CRC-32 indeksu u32, 56 długość metadanych u32, 60 zarezerwowane, 64 metadane.
+ * Wpis indeksu:
+ *   0 przesunięcie chunka w pliku u64, 8 rozmiar u64, 16 CRC-32 danych u32, 20 flagi u32
+ *   (bit 0 - są statystyki), 24 liczba jedynek u64, 32 chi-kwadrat bajtów f64, 40 entropia f64.
+ *
+ * Dane zaczynają się od granicy 4 KB, więc chunki można zapisywać z O_DIRECT. Nagłówek
+ * z indexOffset == 0 oznacza plik przerwany w trakcie zapisu. Metadane (klucz, ziarna,
+ * parametry generatora) zastępują informacje, które wcześniej były tylko w logach.
+ */
+
+const char DATASET_MAGIC[8] = {'C', 'I', 'P', 'H', 'D', 'A', 'T', 'A'};
+const uint32_t DATASET_VERSION = 1;
+const size_t DATASET_HEADER_SIZE = 4096;
+const size_t DATASET_INDEX_ENTRY_SIZE = 48;
+
+// Szybkie statystyki chunka - do próbkowania i filtrowania bez czytania danych
+struct DatasetChunkStats {
+    uint64_t ones = 0;          // bity 1
+    double byteChiSquare = 0.0; // chi-kwadrat histogramu bajtów (255 stopni swobody)
+    double byteEntropy = 0.0;   // entropia bajtów [bit/bajt]
+};
+
+DatasetChunkStats computeDatasetChunkStats(const unsigned char* data, size_t size);
+
+// Dodaje histogram bajtów danych do `histogram` (256 liczników) - wspólne z StreamStats
+void accumulateByteHistogram(const unsigned char* data, size_t size, uint64_t* histogram);
+
+struct DatasetIndexEntry {
+    uint64_t offset = 0; // położenie chunka w pliku
+    uint64_t size = 0;
+    uint32_t crc = 0;    // CRC-32 (zlib) danych chunka
+    bool hasStats = false;
+    DatasetChunkStats stats;
+};
+
+struct DatasetHeader {
+    uint64_t dataOffset = DATASET_HEADER_SIZE;
+    uint64_t chunkSize = 0;
+    uint64_t payloadSize = 0;
+    uint64_t chunkCount = 0;
+    uint64_t indexOffset = 0; // 0 - plik niedokończony
+    uint32_t indexCrc = 0;
+    std::vector<std::pair<std::string, std::string>> metadata;
+
+    // Wartość metadanej albo "" (gdy brak klucza)
+    std::string value(const std::string& key) const;
+};
+
+// Czy dane zaczynają się od nagłówka kontenera
+bool isDatasetContainer(const unsigned char* data, size_t size);
+
+// Zapisuje nagłówek do DATASET_HEADER_SIZE bajtów; false, gdy metadane się nie mieszczą
+bool encodeDatasetHeader(const DatasetHeader& header, unsigned char* out);
+
+// Odczytuje nagłówek; przy błędzie (wersja, rozmiary) wypisuje komunikat i zwraca false
+bool decodeDatasetHeader(const unsigned char* data, size_t size, DatasetHeader& header);
+
+void encodeDatasetIndexEntry(const DatasetIndexEntry& entry, unsigned char* out);
+DatasetIndexEntry decodeDatasetIndexEntry(const unsigned char* in);
+
+// CRC-32 danych chunka (zlib, porcjami - rozmiar nie jest ograniczony do uInt)
+uint32_t datasetChecksum(const unsigned char* data, size_t size);
+
+#endif // DATASET_FORMAT_H
@@ -0,0 +1,176 @@
+#include "dataset_view.h"
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+DatasetView::~DatasetView() {
+    close();
+}
+
+DatasetView::DatasetView(DatasetView&& other) noexcept {
+    *this = std::move(other);
+}
+
+DatasetView& DatasetView::operator=(DatasetView&& other) noexcept {
+    if (this != &other) {
+        close();
+        filePath = std::move(other.filePath);
+        mapped = other.mapped;
+        fileSize = other.fileSize;
+        opened = other.opened;
+        container = other.container;
+        dataOffset = other.dataOffset;
+        dataSize = other.dataSize;
+        datasetHeader = std::move(other.datasetHeader);
+        chunkIndex = std::move(other.chunkIndex);
+        other.mapped = nullptr;
+        other.close();
+    }
+    return *this;
+}
+
+bool DatasetView::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można otworzyć pliku " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Błąd: Nie można odczytać rozmiaru pliku " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    fileSize = static_cast<uint64_t>(info.st_size);
+    if (fileSize > 0) {
+        void* address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            std::cerr << "Błąd: mmap " << path << std::endl;
+            ::close(fd);
+            fileSize = 0;
+            return false;
+        }
+        mapped = static_cast<unsigned char*>(address);
+        // Podpowiedzi są opcjonalne - błąd madvise (np. brak THP dla plików) niczego nie psuje
+        madvise(mapped, fileSize, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        madvise(mapped, fileSize, MADV_HUGEPAGE);
+#endif
+    }
+    // Mapowanie trzyma plik, deskryptor nie jest już potrzebny
+    ::close(fd);
+    filePath = path;
+    dataSize = fileSize;
+    if (isDatasetContainer(mapped, fileSize) && !openContainer()) {
+        close();
+        return false;
+    }
+    opened = true;
+    return true;
+}
+
+bool DatasetView::openContainer() {
+    if (!decodeDatasetHeader(mapped, fileSize, datasetHeader)) {
+        return false;
+    }
+    const DatasetHeader& h = datasetHeader;
+    if (h.indexOffset == 0) {
+        std::cerr << "Błąd: Niedokończony plik zbioru danych (brak indeksu): " << filePath << std::endl;
+        return false;
+    }
+    const uint64_t indexSize = h.chunkCount * DATASET_INDEX_ENTRY_SIZE;
+    if (h.dataOffset + h.payloadSize != h.indexOffset || h.indexOffset + indexSize > fileSize) {
+        std::cerr << "Błąd: Rozmiar pliku niezgodny z nagłówkiem zbioru danych: " << filePath << std::endl;
+        return false;
+    }
+    if (datasetChecksum(mapped + h.indexOffset, static_cast<size_t>(indexSize)) != h.indexCrc) {
+        std::cerr << "Błąd: Uszkodzony indeks zbioru danych: " << filePath << std::endl;
+        return false;
+    }
+
+    chunkIndex.resize(static_cast<size_t>(h.chunkCount));
+    for (size_t k = 0; k < chunkIndex.size(); k++) {
+        chunkIndex[k] = decodeDatasetIndexEntry(mapped + h.indexOffset + k * DATASET_INDEX_ENTRY_SIZE);
+        const DatasetIndexEntry& entry = chunkIndex[k];
+        if (entry.offset < h.dataOffset || entry.offset + entry.size > h.indexOffset) {
+            std::cerr << "Błąd: Wpis indeksu " << k << " poza danymi: " << filePath << std::endl;
+            return false;
+        }
+    }
+    container = true;
+    dataOffset = h.dataOffset;
+    dataSize = h.payloadSize;
+    return true;
+}
+
+void DatasetView::close() {
+    if (mapped) {
+        munmap(mapped, fileSize);
+    }
+    mapped = nullptr;
+    fileSize = 0;
+    opened = false;
+    filePath.clear();
+    container = false;
+    dataOffset = 0;
+    dataSize = 0;
+    datasetHeader = DatasetHeader();
+    chunkIndex.clear();
+}
+
+DataChunk DatasetView::chunk(uint64_t offset, size_t maxSize) const {
+    DataChunk result;
+    result.offset = offset;
+    if (offset < dataSize) {
+        result.data = data() + offset;
+        result.size = static_cast<size_t>(std::min<uint64_t>(maxSize, dataSize - offset));
+    }
+    return result;
+}
+
+size_t DatasetView::chunkCount(size_t chunkSize) const {
+    return chunkSize == 0 ? 0 : static_cast<size_t>((dataSize + chunkSize - 1) / chunkSize);
+}
+
+DataChunk DatasetView::indexedChunk(size_t k) const {
+    if (k >= chunkIndex.size()) {
+        return DataChunk();
+    }
+    const DatasetIndexEntry& entry = chunkIndex[k];
+    DataChunk result;
+    result.data = mapped + entry.offset;
+    result.size = static_cast<size_t>(entry.size);
+    result.offset = entry.offset - dataOffset;
+    return result;
+}
+
+bool DatasetView::verifyChunk(size_t k) const {
+    DataChunk chunk = indexedChunk(k);
+    return k < chunkIndex.size() && datasetChecksum(chunk.data, chunk.size) == chunkIndex[k].crc;
+}
+
+void DatasetView::prefetch(uint64_t offset, size_t size) const {
+    advise(offset, size, MADV_WILLNEED);
+}
+
+void DatasetView::release(uint64_t offset, size_t size) const {
+    advise(offset, size, MADV_DONTNEED);
+}
+
+void DatasetView::advise(uint64_t offset, size_t size, int advice) const {
+    if (offset >= dataSize || size == 0) {
+        return;
+    }
+    // Przesunięcia w danych -> w pliku (mapowaniu)
+    offset += dataOffset;
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t begin = offset / pageSize * pageSize;
+    uint64_t end = std::min<uint64_t>(offset + size, dataOffset + dataSize);
+    madvise(mapped + begin, static_cast<size_t>(end - begin), advice);
+}
@@ -0,0 +1,98 @@
+#ifndef DATASET_VIEW_H
+#define DATASET_VIEW_H
+
+#include "dataset_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Widok pliku zbioru danych (.bin z szyfrogramem, .txt z tekstem) zmapowanego do pamięci.
+ *
+ * Plik mapowany jest raz, tylko do odczytu, z podpowiedziami MADV_SEQUENTIAL (agresywny
+ * odczyt z wyprzedzeniem) i MADV_HUGEPAGE (duże strony, jeśli jądro obsługuje je dla
+ * plików). Chunki to wskaźniki do mapowania - bez alokacji bufora i kopiowania przez
+ * iostream, a wiele wątków może czytać różne chunki naraz. Dane są ważne, dopóki widok
+ * istnieje; skrócenie pliku w trakcie czytania kończy się sygnałem SIGBUS.
+ *
+ * Plik w kontenerze (dataset_format.h) jest rozpoznawany po nagłówku: data() / size() i
+ * przesunięcia chunków dotyczą wtedy samych danych, bez nagłówka i indeksu, więc czytelnicy
+ * obsługują oba formaty bez zmian. Indeks daje dostęp do chunka k, jego CRC i statystyk
+ * bez czytania reszty pliku.
+ */
+
+// Fragment danych tylko do odczytu (odpowiednik std::span<const unsigned char> dla C++17)
+struct DataChunk {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    uint64_t offset = 0; // położenie w danych (w kontenerze - za nagłówkiem)
+
+    const unsigned char* begin() const { return data; }
+    const unsigned char* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+class DatasetView {
+public:
+    DatasetView() = default;
+    ~DatasetView();
+
+    DatasetView(const DatasetView&) = delete;
+    DatasetView& operator=(const DatasetView&) = delete;
+    DatasetView(DatasetView&& other) noexcept;
+    DatasetView& operator=(DatasetView&& other) noexcept;
+
+    // Mapuje plik; przy błędzie (także niedokończonym albo uszkodzonym kontenerze) wypisuje
+    // komunikat i zwraca false (pusty plik jest poprawny)
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const std::string& path() const { return filePath; }
+    const unsigned char* data() const { return mapped + dataOffset; }
+    uint64_t size() const { return dataSize; }
+
+    // Kontener: nagłówek z metadanymi i indeks chunków (dla zwykłego pliku puste)
+    bool isContainer() const { return container; }
+    const DatasetHeader& header() const { return datasetHeader; }
+    const std::vector<DatasetIndexEntry>& index() const { return chunkIndex; }
+
+    // Chunk `k` z indeksu kontenera (pusty poza indeksem)
+    DataChunk indexedChunk(size_t k) const;
+
+    // Czy CRC chunka `k` zgadza się z indeksem
+    bool verifyChunk(size_t k) const;
+
+    // Chunk [offset, offset + maxSize) obcięty do końca pliku (pusty za końcem)
+    DataChunk chunk(uint64_t offset, size_t maxSize) const;
+
+    // Liczba chunków po chunkSize bajtów (ostatni może być krótszy)
+    size_t chunkCount(size_t chunkSize) const;
+
+    // Zakres będzie zaraz czytany - odczyt z wyprzedzeniem (MADV_WILLNEED)
+    void prefetch(uint64_t offset, size_t size) const;
+
+    // Zakres nie będzie już czytany - strony można zwolnić (MADV_DONTNEED), RSS nie rośnie do rozmiaru pliku
+    void release(uint64_t offset, size_t size) const;
+
+private:
+    std::string filePath;
+    unsigned char* mapped = nullptr;
+    uint64_t fileSize = 0;
+    bool opened = false;
+
+    bool container = false;
+    uint64_t dataOffset = 0; // początek danych w pliku
+    uint64_t dataSize = 0;
+    DatasetHeader datasetHeader;
+    std::vector<DatasetIndexEntry> chunkIndex;
+
+    // Czyta nagłówek i indeks kontenera; false, gdy są niespójne z rozmiarem pliku
+    bool openContainer();
+
+    // madvise dla zakresu rozszerzonego do granic stron
+    void advise(uint64_t offset, size_t size, int advice) const;
+};
+
+#endif // DATASET_VIEW_H
@@ -0,0 +1,120 @@
+#include "dataset_writer.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+bool DatasetWriter::containerFromEnvironment() {
+    const char* format = std::getenv("CIPHERDATA_FORMAT");
+    if (format == nullptr || *format == '\0' || std::strcmp(format, "raw") == 0) {
+        return false;
+    }
+    if (std::strcmp(format, "container") != 0) {
+        std::cerr << "Nieznany format zbioru danych: " << format << " (dostępne: raw, container)" << std::endl;
+    }
+    return std::strcmp(format, "container") == 0;
+}
+
+DatasetWriter::DatasetWriter(AsyncOutputSink& sink, bool container, bool chunkStats)
+    : sink(sink), container(container), chunkStats(container && chunkStats) {}
+
+bool DatasetWriter::open(const std::string& outputPath, uint64_t chunkSize, const Metadata& metadata) {
+    path = outputPath;
+    header = DatasetHeader();
+    header.dataOffset = container ? DATASET_HEADER_SIZE : 0;
+    header.chunkSize = chunkSize;
+    header.metadata = metadata;
+    entries.clear();
+    present.clear();
+
+    file = sink.openFile(path);
+    if (file < 0) {
+        return false;
+    }
+    if (container) {
+        // Nagłówek bez indeksu (indexOffset == 0) - przerwany zapis nie udaje kompletnego pliku
+        unsigned char encoded[DATASET_HEADER_SIZE];
+        if (!encodeDatasetHeader(header, encoded)) {
+            sink.closeFile(file);
+            file = -1;
+            return false;
+        }
+        if (!sink.write(file, encoded, sizeof(encoded), 0)) {
+            sink.closeFile(file);
+            file = -1;
+            return false;
+        }
+    }
+    return true;
+}
+
+void DatasetWriter::submitChunk(uint64_t index, unsigned char* buffer, size_t size) {
+    const uint64_t offset = header.dataOffset + index * header.chunkSize;
+    if (container) {
+        DatasetIndexEntry entry;
+        entry.offset = offset;
+        entry.size = size;
+        entry.crc = datasetChecksum(buffer, size);
+        if (chunkStats) {
+            entry.hasStats = true;
+            entry.stats = computeDatasetChunkStats(buffer, size);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entries.size() <= index) {
+            entries.resize(index + 1);
+            present.resize(index + 1, false);
+        }
+        entries[index] = entry;
+        present[index] = true;
+    }
+    sink.submit(file, buffer, size, offset);
+}
+
+bool DatasetWriter::finish() {
+    if (file < 0) {
+        return false;
+    }
+    if (!container) {
+        bool ok = sink.closeFile(file);
+        file = -1;
+        return ok;
+    }
+
+    // Wszystkie chunki poza ostatnim muszą być pełne - inaczej przesunięcia k * chunkSize się rozjadą
+    bool complete = true;
+    header.payloadSize = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!present[i] || (i + 1 < entries.size() && entries[i].size != header.chunkSize)) {
+            complete = false;
+            break;
+        }
+        header.payloadSize += entries[i].size;
+    }
+    if (!complete) {
+        std::cerr << "  Błąd: Niepełny zbiór chunków w " << path << " - plik bez indeksu" << std::endl;
+        sink.closeFile(file);
+        file = -1;
+        return false;
+    }
+
+    header.chunkCount = entries.size();
+    header.indexOffset = header.dataOffset + header.payloadSize;
+    std::vector<unsigned char> index(entries.size() * DATASET_INDEX_ENTRY_SIZE);
+    for (size_t i = 0; i < entries.size(); i++) {
+        encodeDatasetIndexEntry(entries[i], index.data() + i * DATASET_INDEX_ENTRY_SIZE);
+    }
+    header.indexCrc = datasetChecksum(index.data(), index.size());
+    if (!index.empty()) {
+        sink.write(file, index.data(), index.size(), header.indexOffset);
+    }
+
+    // Ostateczny nagłówek dopiero po danych i indeksie - nadpisuje wstępny, więc ten musi być już zapisany
+    bool ok = sink.flushFile(file);
+    if (ok) {
+        unsigned char encoded[DATASET_HEADER_SIZE];
+        encodeDatasetHeader(header, encoded);
+        sink.write(file, encoded, sizeof(encoded), 0);
+    }
+    ok = sink.closeFile(file) && ok;
+    file = -1;
+    return ok;
+}
@@ -0,0 +1,61 @@
+#ifndef DATASET_WRITER_H
+#define DATASET_WRITER_H
+
+#include "async_output.h"
+#include "dataset_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Zapis zbioru danych w kontenerze (dataset_format.h) przez AsyncOutputSink.
+ *
+ * Chunk k ma w danych przesunięcie k * chunkSize; chunki można zlecać z wielu wątków i w
+ * dowolnej kolejności. submitChunk() liczy CRC-32 (i opcjonalnie statystyki) w wątku
+ * wołającym - tam, gdzie bufor jest jeszcze w cache - a indeks i ostateczny nagłówek
+ * zapisuje finish() po zakończeniu zapisu danych. Domyślny format "raw" to same dane, jak
+ * przed wprowadzeniem kontenera - tego oczekują assess --binary i skrypty Pythona; kontener
+ * trzeba włączyć (CIPHERDATA_FORMAT=container) i czytać przez DatasetView / run_nist_sts.
+ */
+class DatasetWriter {
+public:
+    using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+    // true dla CIPHERDATA_FORMAT=container, false = surowe dane (domyślnie)
+    static bool containerFromEnvironment();
+
+    // chunkStats - zapisuj w indeksie statystyki chunków (computeDatasetChunkStats)
+    DatasetWriter(AsyncOutputSink& sink, bool container, bool chunkStats = false);
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    // Tworzy plik; przy błędzie wypisuje komunikat i zwraca false
+    bool open(const std::string& path, uint64_t chunkSize, const Metadata& metadata);
+
+    // Zleca zapis chunka `index` z bufora sinka (bufor przechodzi do sinka)
+    void submitChunk(uint64_t index, unsigned char* buffer, size_t size);
+
+    // True po nieudanym zapisie (albo gdy plik nie jest otwarty) - dalsze chunki nie mają sensu
+    bool failed() { return file < 0 || sink.failed(file); }
+
+    // Czeka na dane, dopisuje indeks i nagłówek, zamyka plik; false po błędzie zapisu albo przy brakującym chunku
+    bool finish();
+
+private:
+    AsyncOutputSink& sink;
+    bool container;
+    bool chunkStats;
+    int file = -1;
+    std::string path;
+    DatasetHeader header;
+
+    std::mutex mutex;
+    std::vector<DatasetIndexEntry> entries; // po numerze chunka
+    std::vector<bool> present;
+};
+
+#endif // DATASET_WRITER_H
@@ -0,0 +1,106 @@
+#include "des_bitslice.h"
+#include "des_bitslice_impl.h"
+
+namespace {
+
+constexpr uint8_t DES_PC1[56] = {
+    57, 49, 41, 33, 25, 17,  9,
+     1, 58, 50, 42, 34, 26, 18,
+    10,  2, 59, 51, 43, 35, 27,
+    19, 11,  3, 60, 52, 44, 36,
+    63, 55, 47, 39, 31, 23, 15,
+     7, 62, 54, 46, 38, 30, 22,
+    14,  6, 61, 53, 45, 37, 29,
+    21, 13,  5, 28, 20, 12,  4
+};
+
+constexpr uint8_t DES_PC2[48] = {
+    14, 17, 11, 24,  1,  5,
+     3, 28, 15,  6, 21, 10,
+    23, 19, 12,  4, 26,  8,
+    16,  7, 27, 20, 13,  2,
+    41, 52, 31, 37, 47, 55,
+    30, 40, 51, 45, 33, 48,
+    44, 49, 39, 56, 34, 53,
+    46, 42, 50, 36, 29, 32
+};
+
+constexpr uint8_t DES_SHIFTS[16] = {
+     1,  1,  2,  2,  2,  2,  2,  2,  1,  2,  2,  2,  2,  2,  2,  1
+};
+
+struct KernelChoice {
+    BitslicedDes::Kernel kernel;
+    size_t groupBlocks;
+    const char* name;
+};
+
+KernelChoice selectKernel() {
+#ifdef CIPHERDATA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {desBitsliceEncryptAvx512, 512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {desBitsliceEncryptAvx2, 256, "avx2"};
+    }
+#endif
+    return {desBitsliceEncrypt64, 64, "64-bit"};
+}
+
+const KernelChoice& kernelChoice() {
+    static const KernelChoice choice = selectKernel();
+    return choice;
+}
+
+} // namespace
+
+void desBitsliceEncrypt64(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups) {
+    desBitsliceEncryptGroups<uint64_t>(keyMasks, in, out, groups);
+}
+
+BitslicedDes::BitslicedDes(const unsigned char key8[8], bool decrypt) {
+    // Standardowy harmonogram kluczy: PC-1, przesunięcia C/D, PC-2
+    uint64_t key = load64be(key8);
+    uint8_t cd[56];
+    for (int i = 0; i < 56; i++) {
+        cd[i] = (key >> (64 - DES_PC1[i])) & 1;
+    }
+    for (int round = 0; round < 16; round++) {
+        for (int s = 0; s < DES_SHIFTS[round]; s++) {
+            uint8_t c0 = cd[0];
+            uint8_t d0 = cd[28];
+            memmove(cd, cd + 1, 27);
+            memmove(cd + 28, cd + 29, 27);
+            cd[27] = c0;
+            cd[55] = d0;
+        }
+        const int slot = decrypt ? 15 - round : round;
+        for (int i = 0; i < 48; i++) {
+            keyMasks[48 * slot + i] = cd[DES_PC2[i] - 1] ? ~0ULL : 0ULL;
+        }
+    }
+
+    const KernelChoice& choice = kernelChoice();
+    kernel = choice.kernel;
+    groupBlocks = choice.groupBlocks;
+}
+
+void BitslicedDes::encryptBlocks(const unsigned char* in, unsigned char* out, size_t blocks) const {
+    const size_t groups = blocks / groupBlocks;
+    kernel(keyMasks, in, out, groups);
+
+    // Reszta bloków przez dopełnioną grupę
+    const size_t done = groups * groupBlocks;
+    if (done < blocks) {
+        alignas(64) unsigned char group[8 * 512] = {0};
+        const size_t restBytes = 8 * (blocks - done);
+        memcpy(group, in + 8 * done, restBytes);
+        kernel(keyMasks, group, group, 1);
+        memcpy(out + 8 * done, group, restBytes);
+    }
+}
+
+const char* BitslicedDes::kernelName() {
+    return kernelChoice().name;
+}
@@ -0,0 +1,37 @@
+#ifndef DES_BITSLICE_H
+#define DES_BITSLICE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Bitslicowany DES w trybie ECB.
+ *
+ * Bloki są transponowane tak, że jedno słowo niesie ten sam bit wielu bloków,
+ * a S-boksy liczone są jako układy bramek logicznych: 64 bloki naraz na słowach
+ * 64-bitowych, 256 z AVX2 i 512 z AVX-512. Wariant wybierany jest raz, w czasie
+ * działania, według możliwości procesora. Wynik jest identyczny z DES_ecb_encrypt
+ * dla tego samego 8-bajtowego klucza (bity parzystości są pomijane, jak w DES).
+ * Z decrypt = true klucze rund są w odwrotnej kolejności - encryptBlocks() deszyfruje
+ * (środkowy etap 3DES EDE).
+ */
+class BitslicedDes {
+public:
+    using Kernel = void (*)(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups);
+
+private:
+    uint64_t keyMasks[16 * 48]; // bity kluczy rund rozszerzone do 0 lub ~0
+    Kernel kernel;
+    size_t groupBlocks;         // liczba bloków przetwarzanych jednym wywołaniem jądra
+
+public:
+    explicit BitslicedDes(const unsigned char key8[8], bool decrypt = false);
+
+    // Szyfruje `blocks` pełnych bloków 8-bajtowych (in == out jest dozwolone)
+    void encryptBlocks(const unsigned char* in, unsigned char* out, size_t blocks) const;
+
+    // Nazwa wybranego wariantu: "avx512", "avx2" albo "64-bit"
+    static const char* kernelName();
+};
+
+#endif // DES_BITSLICE_H
@@ -0,0 +1,8 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "des_bitslice_impl.h"
+
+typedef uint64_t DesLanes256 __attribute__((vector_size(32)));
+
+void desBitsliceEncryptAvx2(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups) {
+    desBitsliceEncryptGroups<DesLanes256>(keyMasks, in, out, groups);
+}
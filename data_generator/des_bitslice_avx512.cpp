@@ -0,0 +1,8 @@
+// Budowany z -mavx512f (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "des_bitslice_impl.h"
+
+typedef uint64_t DesLanes512 __attribute__((vector_size(64)));
+
+void desBitsliceEncryptAvx512(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups) {
+    desBitsliceEncryptGroups<DesLanes512>(keyMasks, in, out, groups);
+}
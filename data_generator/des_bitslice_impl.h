@@ -0,0 +1,319 @@
+#ifndef DES_BITSLICE_IMPL_H
+#define DES_BITSLICE_IMPL_H
+
+/**
+ * Wewnętrzna część bitslicowanego DES, wspólna dla wariantów 64-bit / AVX2 / AVX-512.
+ *
+ * Jądro jest szablonem po typie słowa T: uint64_t albo wektorze GCC
+ * (uint64_t __attribute__((vector_size(32/64)))). Każdy 64-bitowy pas słowa niesie
+ * 64 bloki, więc T obsługuje 64 * sizeof(T) / 8 bloków naraz. Plik jest dołączany
+ * przez osobne jednostki kompilacji budowane z -mavx2 / -mavx512f, dlatego wszystko
+ * poza deklaracjami jąder ma wiązanie wewnętrzne.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Jądra dla kolejnych zestawów instrukcji; `groups` grup po DES_*_BLOCKS bloków
+void desBitsliceEncrypt64(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups);
+void desBitsliceEncryptAvx2(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups);
+void desBitsliceEncryptAvx512(const uint64_t* keyMasks, const unsigned char* in, unsigned char* out, size_t groups);
+
+namespace {
+
+// Permutacja początkowa IP (numeracja bitów od 1, bit 1 = najstarszy bit bloku)
+constexpr uint8_t DES_IP[64] = {
+    58, 50, 42, 34, 26, 18, 10,  2,
+    60, 52, 44, 36, 28, 20, 12,  4,
+    62, 54, 46, 38, 30, 22, 14,  6,
+    64, 56, 48, 40, 32, 24, 16,  8,
+    57, 49, 41, 33, 25, 17,  9,  1,
+    59, 51, 43, 35, 27, 19, 11,  3,
+    61, 53, 45, 37, 29, 21, 13,  5,
+    63, 55, 47, 39, 31, 23, 15,  7
+};
+
+// Rozszerzenie E: 32 -> 48 bitów
+constexpr uint8_t DES_E[48] = {
+    32,  1,  2,  3,  4,  5,
+     4,  5,  6,  7,  8,  9,
+     8,  9, 10, 11, 12, 13,
+    12, 13, 14, 15, 16, 17,
+    16, 17, 18, 19, 20, 21,
+    20, 21, 22, 23, 24, 25,
+    24, 25, 26, 27, 28, 29,
+    28, 29, 30, 31, 32,  1
+};
+
+// Permutacja P wyjścia S-boksów
+constexpr uint8_t DES_P[32] = {
+    16,  7, 20, 21, 29, 12, 28, 17,
+     1, 15, 23, 26,  5, 18, 31, 10,
+     2,  8, 24, 14, 32, 27,  3,  9,
+    19, 13, 30,  6, 22, 11,  4, 25
+};
+
+// S-boksy S1..S8: 4 wiersze po 16 kolumn
+constexpr uint8_t DES_SBOX[8][64] = {
+    {
+        14,  4, 13,  1,  2, 15, 11,  8,  3, 10,  6, 12,  5,  9,  0,  7,
+         0, 15,  7,  4, 14,  2, 13,  1, 10,  6, 12, 11,  9,  5,  3,  8,
+         4,  1, 14,  8, 13,  6,  2, 11, 15, 12,  9,  7,  3, 10,  5,  0,
+        15, 12,  8,  2,  4,  9,  1,  7,  5, 11,  3, 14, 10,  0,  6, 13
+    },
+    {
+        15,  1,  8, 14,  6, 11,  3,  4,  9,  7,  2, 13, 12,  0,  5, 10,
+         3, 13,  4,  7, 15,  2,  8, 14, 12,  0,  1, 10,  6,  9, 11,  5,
+         0, 14,  7, 11, 10,  4, 13,  1,  5,  8, 12,  6,  9,  3,  2, 15,
+        13,  8, 10,  1,  3, 15,  4,  2, 11,  6,  7, 12,  0,  5, 14,  9
+    },
+    {
+        10,  0,  9, 14,  6,  3, 15,  5,  1, 13, 12,  7, 11,  4,  2,  8,
+        13,  7,  0,  9,  3,  4,  6, 10,  2,  8,  5, 14, 12, 11, 15,  1,
+        13,  6,  4,  9,  8, 15,  3,  0, 11,  1,  2, 12,  5, 10, 14,  7,
+         1, 10, 13,  0,  6,  9,  8,  7,  4, 15, 14,  3, 11,  5,  2, 12
+    },
+    {
+         7, 13, 14,  3,  0,  6,  9, 10,  1,  2,  8,  5, 11, 12,  4, 15,
+        13,  8, 11,  5,  6, 15,  0,  3,  4,  7,  2, 12,  1, 10, 14,  9,
+        10,  6,  9,  0, 12, 11,  7, 13, 15,  1,  3, 14,  5,  2,  8,  4,
+         3, 15,  0,  6, 10,  1, 13,  8,  9,  4,  5, 11, 12,  7,  2, 14
+    },
+    {
+         2, 12,  4,  1,  7, 10, 11,  6,  8,  5,  3, 15, 13,  0, 14,  9,
+        14, 11,  2, 12,  4,  7, 13,  1,  5,  0, 15, 10,  3,  9,  8,  6,
+         4,  2,  1, 11, 10, 13,  7,  8, 15,  9, 12,  5,  6,  3,  0, 14,
+        11,  8, 12,  7,  1, 14,  2, 13,  6, 15,  0,  9, 10,  4,  5,  3
+    },
+    {
+        12,  1, 10, 15,  9,  2,  6,  8,  0, 13,  3,  4, 14,  7,  5, 11,
+        10, 15,  4,  2,  7, 12,  9,  5,  6,  1, 13, 14,  0, 11,  3,  8,
+         9, 14, 15,  5,  2,  8, 12,  3,  7,  0,  4, 10,  1, 13, 11,  6,
+         4,  3,  2, 12,  9,  5, 15, 10, 11, 14,  1,  7,  6,  0,  8, 13
+    },
+    {
+         4, 11,  2, 14, 15,  0,  8, 13,  3, 12,  9,  7,  5, 10,  6,  1,
+        13,  0, 11,  7,  4,  9,  1, 10, 14,  3,  5, 12,  2, 15,  8,  6,
+         1,  4, 11, 13, 12,  3,  7, 14, 10, 15,  6,  8,  0,  5,  9,  2,
+         6, 11, 13,  8,  1,  4, 10,  7,  9,  5,  0, 15, 14,  2,  3, 12
+    },
+    {
+        13,  2,  8,  4,  6, 15, 11,  1, 10,  9,  3, 14,  5,  0, 12,  7,
+         1, 15, 13,  8, 10,  3,  7,  4, 12,  5,  6, 11,  0, 14,  9,  2,
+         7, 11,  4,  1,  9, 12, 14,  2,  0,  6, 10, 13, 15,  3,  5,  8,
+         2,  1, 14,  7,  4, 10,  8, 13, 15, 12,  9,  0,  3,  5,  6, 11
+    }
+};
+
+// Kolejność zmiennych w drzewie multiplekserów dla każdego S-boksu (0 = pierwszy bit wejścia).
+// Wybrana przeszukaniem wszystkich 720 permutacji pod kątem najmniejszej liczby bramek.
+constexpr uint8_t DES_SBOX_VAR_ORDER[8][6] = {
+    {0, 2, 3, 1, 4, 5},
+    {5, 2, 3, 0, 1, 4},
+    {3, 5, 2, 4, 1, 0},
+    {0, 2, 3, 1, 4, 5},
+    {0, 5, 1, 2, 3, 4},
+    {1, 5, 2, 0, 3, 4},
+    {1, 3, 2, 4, 0, 5},
+    {1, 3, 2, 0, 4, 5}
+};
+
+// Tablica prawdy bitu `bit` (0 = najstarszy) wyjścia S-boksu `s` po zmiennych w kolejności DES_SBOX_VAR_ORDER
+constexpr uint64_t desSboxTruthTable(int s, int bit) {
+    uint64_t table = 0;
+    for (int idx = 0; idx < 64; idx++) {
+        int c[6] = {0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < 6; i++) {
+            c[DES_SBOX_VAR_ORDER[s][i]] = (idx >> i) & 1;
+        }
+        int row = c[0] * 2 + c[5];
+        int col = c[1] * 8 + c[2] * 4 + c[3] * 2 + c[4];
+        if ((DES_SBOX[s][16 * row + col] >> (3 - bit)) & 1) {
+            table |= 1ULL << idx;
+        }
+    }
+    return table;
+}
+
+// Odwrotność permutacji o numeracji od 1: wynik[i] = k, gdzie perm[k] == i + 1
+template <size_t N>
+struct InversePermutation {
+    uint8_t index[N] = {};
+    constexpr explicit InversePermutation(const uint8_t (&perm)[N]) {
+        for (size_t k = 0; k < N; k++) {
+            index[perm[k] - 1] = static_cast<uint8_t>(k);
+        }
+    }
+};
+
+constexpr InversePermutation<64> DES_IP_INV(DES_IP);
+constexpr InversePermutation<32> DES_P_INV(DES_P);
+
+/**
+ * Funkcja boolowska N zmiennych o tablicy prawdy TT, rozwinięta w drzewo multiplekserów
+ * po x[N-1], x[N-2], ... Poddrzewa stałe, równe lub wzajemnie zanegowane upraszczają się
+ * do pojedynczej bramki; wspólne poddrzewa różnych bitów wyjścia scala kompilator.
+ */
+template <typename T, uint64_t TT, int N>
+inline T evalBoolFn(const T* x) {
+    if constexpr (N == 1) {
+        if constexpr (TT == 0) return T{};
+        else if constexpr (TT == 3) return ~T{};
+        else if constexpr (TT == 1) return ~x[0];
+        else return x[0];
+    } else {
+        constexpr int HALF = 1 << (N - 1);
+        constexpr uint64_t MASK = (1ULL << HALF) - 1;
+        constexpr uint64_t LO = TT & MASK;
+        constexpr uint64_t HI = (TT >> HALF) & MASK;
+        const T sel = x[N - 1];
+        if constexpr (LO == HI) {
+            return evalBoolFn<T, LO, N - 1>(x);
+        } else if constexpr (LO == (~HI & MASK)) {
+            return evalBoolFn<T, LO, N - 1>(x) ^ sel;
+        } else if constexpr (LO == 0) {
+            return evalBoolFn<T, HI, N - 1>(x) & sel;
+        } else if constexpr (HI == 0) {
+            return evalBoolFn<T, LO, N - 1>(x) & ~sel;
+        } else if constexpr (LO == MASK) {
+            return evalBoolFn<T, HI, N - 1>(x) | ~sel;
+        } else if constexpr (HI == MASK) {
+            return evalBoolFn<T, LO, N - 1>(x) | sel;
+        } else {
+            const T lo = evalBoolFn<T, LO, N - 1>(x);
+            const T hi = evalBoolFn<T, HI, N - 1>(x);
+            return lo ^ ((lo ^ hi) & sel);
+        }
+    }
+}
+
+// Jeden S-boks rundy: wejście z E(R) xor klucz, wyjście przez P bezpośrednio do L
+template <typename T, int S>
+inline void desSboxStep(const T* r, T* l, const uint64_t* keyMasks) {
+    T in[6];
+    for (int c = 0; c < 6; c++) {
+        in[c] = r[DES_E[6 * S + c] - 1] ^ keyMasks[6 * S + c];
+    }
+    T x[6];
+    for (int i = 0; i < 6; i++) {
+        x[i] = in[DES_SBOX_VAR_ORDER[S][i]];
+    }
+    l[DES_P_INV.index[4 * S + 0]] ^= evalBoolFn<T, desSboxTruthTable(S, 0), 6>(x);
+    l[DES_P_INV.index[4 * S + 1]] ^= evalBoolFn<T, desSboxTruthTable(S, 1), 6>(x);
+    l[DES_P_INV.index[4 * S + 2]] ^= evalBoolFn<T, desSboxTruthTable(S, 2), 6>(x);
+    l[DES_P_INV.index[4 * S + 3]] ^= evalBoolFn<T, desSboxTruthTable(S, 3), 6>(x);
+}
+
+// L ^= f(R, K)
+template <typename T>
+inline void desFeistel(const T* r, T* l, const uint64_t* keyMasks) {
+    desSboxStep<T, 0>(r, l, keyMasks);
+    desSboxStep<T, 1>(r, l, keyMasks);
+    desSboxStep<T, 2>(r, l, keyMasks);
+    desSboxStep<T, 3>(r, l, keyMasks);
+    desSboxStep<T, 4>(r, l, keyMasks);
+    desSboxStep<T, 5>(r, l, keyMasks);
+    desSboxStep<T, 6>(r, l, keyMasks);
+    desSboxStep<T, 7>(r, l, keyMasks);
+}
+
+// Transpozycja 64x64 bitów w każdym 64-bitowym pasie (bit 0 = najstarszy bit słowa)
+template <typename T>
+inline void transpose64(T* a) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            T t = (a[k] ^ (a[k | j] >> j)) & m;
+            a[k] ^= t;
+            a[k | j] ^= t << j;
+        }
+    }
+}
+
+template <typename T>
+constexpr size_t lanesOf() {
+    return sizeof(T) / sizeof(uint64_t);
+}
+
+inline uint64_t load64be(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return __builtin_bswap64(v);
+}
+
+inline void store64be(unsigned char* p, uint64_t v) {
+    v = __builtin_bswap64(v);
+    memcpy(p, &v, 8);
+}
+
+// Pas g słowa rows[r] to blok 64 * g + r
+template <typename T>
+inline void loadRows(T* rows, const unsigned char* in) {
+    for (int r = 0; r < 64; r++) {
+        if constexpr (lanesOf<T>() == 1) {
+            rows[r] = load64be(in + 8 * r);
+        } else {
+            for (size_t g = 0; g < lanesOf<T>(); g++) {
+                rows[r][g] = load64be(in + 8 * (64 * g + r));
+            }
+        }
+    }
+}
+
+template <typename T>
+inline void storeRows(const T* rows, unsigned char* out) {
+    for (int r = 0; r < 64; r++) {
+        if constexpr (lanesOf<T>() == 1) {
+            store64be(out + 8 * r, rows[r]);
+        } else {
+            for (size_t g = 0; g < lanesOf<T>(); g++) {
+                store64be(out + 8 * (64 * g + r), rows[r][g]);
+            }
+        }
+    }
+}
+
+/**
+ * Szyfruje `groups` grup po 64 * lanesOf<T>() bloków. keyMasks: 16 rund x 48 bitów klucza,
+ * każdy bit rozszerzony do 0 lub ~0. Po transpozycji słowo a[i] zawiera bit i+1 (numeracja DES)
+ * wszystkich bloków, więc permutacje IP, E, P i IP^-1 są tylko przenumerowaniem słów.
+ */
+template <typename T>
+inline void desBitsliceEncryptGroups(const uint64_t* keyMasks, const unsigned char* in,
+                                     unsigned char* out, size_t groups) {
+    const size_t groupBytes = 8 * 64 * lanesOf<T>();
+    for (size_t grp = 0; grp < groups; grp++) {
+        T a[64];
+        loadRows(a, in + grp * groupBytes);
+        transpose64(a);
+
+        T left[32], right[32];
+        for (int k = 0; k < 32; k++) {
+            left[k] = a[DES_IP[k] - 1];
+            right[k] = a[DES_IP[32 + k] - 1];
+        }
+
+        T* l = left;
+        T* r = right;
+        for (int round = 0; round < 16; round++) {
+            desFeistel(r, l, keyMasks + 48 * round);
+            T* tmp = l;
+            l = r;
+            r = tmp;
+        }
+
+        // Wyjście przed IP^-1 to R16 || L16
+        for (int i = 0; i < 64; i++) {
+            int k = DES_IP_INV.index[i];
+            a[i] = k < 32 ? right[k] : left[k - 32];
+        }
+
+        transpose64(a);
+        storeRows(a, out + grp * groupBytes);
+    }
+}
+
+} // namespace
+
+#endif // DES_BITSLICE_IMPL_H
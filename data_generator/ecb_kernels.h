@@ -0,0 +1,36 @@
+#ifndef ECB_KERNELS_H
+#define ECB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <openssl/blowfish.h>
+#include <openssl/cast.h>
+#include <openssl/rc2.h>
+
+/**
+ * Masowe szyfrowanie ECB dla Blowfish, CAST, RC2 i IDEA (DES: des_bitslice.h).
+ *
+ * Funkcje szyfrują `blocks` pełnych bloków 8-bajtowych bezpośrednio z `in` do `out`
+ * (in == out jest dozwolone), bez kopiowania każdego bloku przez bufor pośredni.
+ * Blowfish i CAST przetwarzają kilka niezależnych bloków naraz (przeplatane rundy),
+ * co ukrywa opóźnienia odczytów z S-boksów; RC2 i IDEA - tyle bloków, ile pasów ma
+ * wektor (ecb_kernels_impl.h, wariant wybierany w czasie działania). Wynik jest identyczny z *_ecb_encrypt
+ * (IDEA: z IDEA_ecb_encrypt - systemowy OpenSSL bywa budowany bez IDEA, stąd własny
+ * harmonogram klucza). Niepełny ostatni blok obsługuje wywołujący.
+ */
+
+struct IdeaKey {
+    uint16_t subkeys[52];
+};
+
+void ideaSetKey(IdeaKey* key, const unsigned char key16[16]);
+
+void blowfishEcbEncryptBlocks(const BF_KEY* key, const unsigned char* in, unsigned char* out, size_t blocks);
+void castEcbEncryptBlocks(const CAST_KEY* key, const unsigned char* in, unsigned char* out, size_t blocks);
+void rc2EcbEncryptBlocks(const RC2_KEY* key, const unsigned char* in, unsigned char* out, size_t blocks);
+void ideaEcbEncryptBlocks(const IdeaKey* key, const unsigned char* in, unsigned char* out, size_t blocks);
+
+// Wariant jąder RC2 / IDEA: "avx512", "avx2" albo "128-bit"
+const char* wideEcbKernelName();
+
+#endif // ECB_KERNELS_H
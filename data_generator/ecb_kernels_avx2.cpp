@@ -0,0 +1,13 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "ecb_kernels_impl.h"
+
+typedef uint16_t Rc2Lanes256 __attribute__((vector_size(32)));
+typedef uint32_t IdeaLanes256 __attribute__((vector_size(32)));
+
+void rc2EncryptAvx2(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    rc2EncryptGroups<Rc2Lanes256>(key, in, out, groups);
+}
+
+void ideaEncryptAvx2(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    ideaEncryptGroups<IdeaLanes256>(key, in, out, groups);
+}
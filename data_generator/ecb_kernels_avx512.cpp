@@ -0,0 +1,13 @@
+// Budowany z -mavx512bw (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "ecb_kernels_impl.h"
+
+typedef uint16_t Rc2Lanes512 __attribute__((vector_size(64)));
+typedef uint32_t IdeaLanes512 __attribute__((vector_size(64)));
+
+void rc2EncryptAvx512(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    rc2EncryptGroups<Rc2Lanes512>(key, in, out, groups);
+}
+
+void ideaEncryptAvx512(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    ideaEncryptGroups<IdeaLanes512>(key, in, out, groups);
+}
@@ -0,0 +1,161 @@
+#ifndef ECB_KERNELS_IMPL_H
+#define ECB_KERNELS_IMPL_H
+
+/**
+ * Wewnętrzna część jąder RC2 i IDEA z ecb_kernels.h, wspólna dla wariantów ogólnego / AVX2 / AVX-512.
+ *
+ * Jądra są szablonami po typie wektora GCC (vector_size): każdy pas niesie jedno słowo
+ * 16-bitowe innego bloku, więc jeden przebieg szyfruje tyle bloków, ile pasów ma wektor.
+ * Bloki są rozkładane na cztery wektory słów (transpozycja przez bufor na stosie), rundy
+ * liczone są na całych wektorach, a wynik składany z powrotem. Plik jest dołączany przez
+ * osobne jednostki kompilacji budowane z -mavx2 / -mavx512bw, dlatego wszystko poza
+ * deklaracjami jąder ma wiązanie wewnętrzne.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Jądra dla kolejnych zestawów instrukcji; `groups` grup po *_BLOCKS bloków
+// rc2: 64 słowa klucza RC2 (16-bit); idea: 52 podklucze IDEA
+void rc2EncryptGeneric(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+void rc2EncryptAvx2(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+void rc2EncryptAvx512(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+void ideaEncryptGeneric(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+void ideaEncryptAvx2(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+void ideaEncryptAvx512(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups);
+
+namespace {
+
+// Rozkłada `lanes` bloków na cztery tablice słów 16-bitowych (big = IDEA, little = RC2)
+template <typename Word>
+inline void gatherWords(const unsigned char* in, size_t lanes, bool bigEndian, Word* words) {
+    for (size_t j = 0; j < lanes; j++) {
+        for (size_t w = 0; w < 4; w++) {
+            const unsigned char* p = in + 8 * j + 2 * w;
+            words[w * lanes + j] = bigEndian ? static_cast<Word>((p[0] << 8) | p[1])
+                                             : static_cast<Word>(p[0] | (p[1] << 8));
+        }
+    }
+}
+
+template <typename Word>
+inline void scatterWords(const Word* words, size_t lanes, bool bigEndian, unsigned char* out) {
+    for (size_t j = 0; j < lanes; j++) {
+        for (size_t w = 0; w < 4; w++) {
+            unsigned char* p = out + 8 * j + 2 * w;
+            const unsigned int v = words[w * lanes + j];
+            p[bigEndian ? 0 : 1] = static_cast<unsigned char>(v >> 8);
+            p[bigEndian ? 1 : 0] = static_cast<unsigned char>(v);
+        }
+    }
+}
+
+// Odczyt K[index] w każdym pasie: przy 32 pasach jedna permutacja z dwóch wektorów
+// (vpermt2w), węższe wektory - pas po pasie przez pamięć
+template <typename V>
+inline V rc2KeyLookup(const uint16_t* key, const V* table, V index) {
+    constexpr size_t LANES = sizeof(V) / sizeof(uint16_t);
+    if constexpr (LANES == 32) {
+        return __builtin_shuffle(table[0], table[1], index);
+    } else {
+        alignas(64) uint16_t lanes[LANES];
+        memcpy(lanes, &index, sizeof(V));
+        for (size_t j = 0; j < LANES; j++) {
+            lanes[j] = key[lanes[j]];
+        }
+        V value;
+        memcpy(&value, lanes, sizeof(V));
+        return value;
+    }
+}
+
+// RC2 (RFC 2268): V - wektor uint16_t
+template <typename V>
+inline void rc2EncryptGroups(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    constexpr size_t LANES = sizeof(V) / sizeof(uint16_t);
+    constexpr int SHIFTS[4] = {1, 2, 3, 5};
+
+    // Tablica klucza w rejestrach - dla 32 pasów (AVX-512BW) całe 64 słowa to dwa wektory
+    V table[2] = {};
+    if constexpr (LANES == 32) {
+        memcpy(table, key, sizeof(table));
+    }
+
+    for (size_t g = 0; g < groups; g++, in += 8 * LANES, out += 8 * LANES) {
+        alignas(64) uint16_t words[4 * LANES];
+        gatherWords(in, LANES, false, words);
+        V r[4];
+        memcpy(r, words, sizeof(r));
+
+        int n = 0;
+        for (int round = 0; round < 16; round++) {
+#pragma GCC unroll 4
+            for (int w = 0; w < 4; w++, n++) {
+                // R[i] += K[j] + (R[i-1] & R[i-2]) + (~R[i-1] & R[i-3]), potem obrót
+                const V& a = r[(w + 3) & 3];
+                V x = r[w] + key[n] + (a & r[(w + 2) & 3]) + (~a & r[(w + 1) & 3]);
+                r[w] = (x << SHIFTS[w]) | (x >> (16 - SHIFTS[w]));
+            }
+            if (round == 4 || round == 10) {
+                // Mash: R[i] += K[R[i-1] & 63]
+                for (int w = 0; w < 4; w++) {
+                    r[w] += rc2KeyLookup<V>(key, table, r[(w + 3) & 3] & 63);
+                }
+            }
+        }
+
+        memcpy(words, r, sizeof(r));
+        scatterWords(words, LANES, false, out);
+    }
+}
+
+// Mnożenie IDEA modulo 2^16 + 1 (0 oznacza 2^16) na pasach 32-bitowych, bez skoków
+template <typename V>
+inline V ideaMul(V a, V b) {
+    V p = a * b;
+    V lo = p & 0xffff;
+    V hi = p >> 16;
+    V product = lo - hi - static_cast<V>(lo < hi); // lo < hi daje -1 w pasie
+    V zero = static_cast<V>(p == 0);                // a == 0 albo b == 0
+    V special = 1 - a - b;
+    return ((product & ~zero) | (special & zero)) & 0xffff;
+}
+
+// IDEA: V - wektor uint32_t (iloczyn 16 x 16 bitów mieści się w pasie)
+template <typename V>
+inline void ideaEncryptGroups(const uint16_t* key, const unsigned char* in, unsigned char* out, size_t groups) {
+    constexpr size_t LANES = sizeof(V) / sizeof(uint32_t);
+
+    for (size_t g = 0; g < groups; g++, in += 8 * LANES, out += 8 * LANES) {
+        alignas(64) uint32_t words[4 * LANES];
+        gatherWords(in, LANES, true, words);
+        V x[4];
+        memcpy(x, words, sizeof(x));
+
+        const uint16_t* z = key;
+        for (int round = 0; round < 8; round++, z += 6) {
+            V a = ideaMul<V>(x[0], V{} + z[0]);
+            V b = (x[1] + z[1]) & 0xffff;
+            V c = (x[2] + z[2]) & 0xffff;
+            V d = ideaMul<V>(x[3], V{} + z[3]);
+            V t0 = ideaMul<V>(a ^ c, V{} + z[4]);
+            V t1 = ideaMul<V>(((b ^ d) + t0) & 0xffff, V{} + z[5]);
+            t0 = (t0 + t1) & 0xffff;
+            x[0] = a ^ t1;
+            x[1] = c ^ t1;
+            x[2] = b ^ t0;
+            x[3] = d ^ t0;
+        }
+        // Ostatnia półrunda bez zamiany środkowych słów
+        V y[4] = {ideaMul<V>(x[0], V{} + z[0]), (x[2] + z[1]) & 0xffff, (x[1] + z[2]) & 0xffff,
+                  ideaMul<V>(x[3], V{} + z[3])};
+
+        memcpy(words, y, sizeof(y));
+        scatterWords(words, LANES, true, out);
+    }
+}
+
+} // namespace
+
+#endif // ECB_KERNELS_IMPL_H
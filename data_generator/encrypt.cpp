@@ -1,18 +1,9 @@
+#include "cipher_engine.h"
 #include <iostream>
 #include <vector>
 #include <random>
 #include <iomanip>
 #include <cstring>
-#include <openssl/evp.h>
-#include <openssl/rand.h>
-#include <openssl/des.h>
-#include <openssl/blowfish.h>
-#include <openssl/cast.h>
-#include <openssl/rc4.h>
-
-// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL (funkcje nadal działają)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
 class DataEncryptor {
 private:
@@ -56,96 +47,12 @@ public:
         printHex(std::vector<unsigned char>(key56, key56 + 7), "Klucz 56-bit");
     }
     
-    std::vector<unsigned char> encryptCAST() {
+    std::vector<unsigned char> encrypt(const std::string& algorithm) {
         std::vector<unsigned char> encrypted(randomData.size());
-        CAST_KEY castKey;
-        
-        // CAST przyjmuje klucz do 128 bitów, użyjemy 56 bitów
-        CAST_set_key(&castKey, 7, key56);
-        
-        unsigned char iv[CAST_BLOCK];
-        memset(iv, 0, CAST_BLOCK);
-        
-        // CAST w trybie ECB (prostszy do implementacji)
-        for (size_t i = 0; i < randomData.size(); i += CAST_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(CAST_BLOCK), 
-                                       randomData.size() - i);
-            unsigned char input[CAST_BLOCK] = {0};
-            unsigned char output[CAST_BLOCK];
-            
-            memcpy(input, &randomData[i], blockSize);
-            CAST_ecb_encrypt(input, output, &castKey, CAST_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
+        std::unique_ptr<CipherEngine> engine = createCipherEngine(algorithm, key56);
+        if (engine) {
+            engine->encrypt(randomData.data(), encrypted.data(), randomData.size());
         }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptRC4() {
-        std::vector<unsigned char> encrypted(randomData.size());
-        RC4_KEY rc4Key;
-        
-        RC4_set_key(&rc4Key, 7, key56);
-        RC4(&rc4Key, randomData.size(), randomData.data(), encrypted.data());
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptDES() {
-        std::vector<unsigned char> encrypted(randomData.size());
-        DES_key_schedule desKey;
-        
-        // DES używa 56-bitowego klucza (7 bajtów, ale potrzebuje 8 bajtów)
-        unsigned char desKey8[8];
-        memcpy(desKey8, key56, 7);
-        desKey8[7] = 0; // Uzupełnienie do 8 bajtów
-        
-        // Ustawienie parzystości bitów klucza (wymagane przez DES)
-        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
-        DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(desKey8), &desKey);
-        
-        unsigned char iv[8];
-        memset(iv, 0, 8);
-        
-        // DES w trybie ECB
-        for (size_t i = 0; i < randomData.size(); i += 8) {
-            size_t blockSize = std::min(static_cast<size_t>(8), 
-                                       randomData.size() - i);
-            unsigned char input[8] = {0};
-            unsigned char output[8];
-            
-            memcpy(input, &randomData[i], blockSize);
-            DES_ecb_encrypt(reinterpret_cast<const_DES_cblock*>(input),
-                          reinterpret_cast<DES_cblock*>(output),
-                          &desKey, DES_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptBlowfish() {
-        std::vector<unsigned char> encrypted(randomData.size());
-        BF_KEY bfKey;
-        
-        // Blowfish może używać kluczy od 32 do 448 bitów
-        BF_set_key(&bfKey, 7, key56);
-        
-        unsigned char iv[BF_BLOCK];
-        memset(iv, 0, BF_BLOCK);
-        
-        // Blowfish w trybie ECB
-        for (size_t i = 0; i < randomData.size(); i += BF_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(BF_BLOCK), 
-                                       randomData.size() - i);
-            unsigned char input[BF_BLOCK] = {0};
-            unsigned char output[BF_BLOCK];
-            
-            memcpy(input, &randomData[i], blockSize);
-            BF_ecb_encrypt(input, output, &bfKey, BF_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
         return encrypted;
     }
     
@@ -153,19 +60,19 @@ public:
         generateData(dataSize);
         
         std::cout << "\n=== Szyfrowanie algorytmem CAST ===" << std::endl;
-        auto castEncrypted = encryptCAST();
+        auto castEncrypted = encrypt("cast");
         printHex(castEncrypted, "Zaszyfrowane");
         
         std::cout << "\n=== Szyfrowanie algorytmem RC4 ===" << std::endl;
-        auto rc4Encrypted = encryptRC4();
+        auto rc4Encrypted = encrypt("rc4");
         printHex(rc4Encrypted, "Zaszyfrowane");
         
         std::cout << "\n=== Szyfrowanie algorytmem DES ===" << std::endl;
-        auto desEncrypted = encryptDES();
+        auto desEncrypted = encrypt("des");
         printHex(desEncrypted, "Zaszyfrowane");
         
         std::cout << "\n=== Szyfrowanie algorytmem Blowfish ===" << std::endl;
-        auto blowfishEncrypted = encryptBlowfish();
+        auto blowfishEncrypted = encrypt("blowfish");
         printHex(blowfishEncrypted, "Zaszyfrowane");
     }
 };
@@ -190,5 +97,3 @@ int main(int argc, char* argv[]) {
     
     return 0;
 }
-
-#pragma GCC diagnostic pop
@@ -0,0 +1,61 @@
+#include "evp_cipher.h"
+#include "cipher_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <openssl/err.h>
+
+namespace {
+
+// EVP_EncryptUpdate przyjmuje długość jako int - chunk idzie kawałkami (wielokrotność bloku)
+const size_t EVP_PIECE = 64 * 1024 * 1024;
+
+} // namespace
+
+bool setEvpCipherKey(EvpCipherKey& key, const char* evpName, const unsigned char key56[7]) {
+    key.cipher.reset(EVP_CIPHER_fetch(nullptr, evpName, nullptr));
+    ERR_clear_error();
+    if (!key.cipher) {
+        return false;
+    }
+
+    const size_t keyLength = EVP_CIPHER_get_key_length(key.cipher.get());
+    const size_t ivLength = EVP_CIPHER_get_iv_length(key.cipher.get());
+    unsigned char material[EVP_MAX_KEY_LENGTH + EVP_MAX_IV_LENGTH];
+    expandCipherKey(key56, material, keyLength + ivLength);
+    memcpy(key.key, material, keyLength);
+    memcpy(key.iv, material + keyLength, ivLength);
+    return true;
+}
+
+bool evpEncrypt(const EvpCipherKey& key, const unsigned char* in, unsigned char* out, size_t size) {
+    // Kontekst na wywołanie (kilka mikrosekund na chunk) - klucz pozostaje niezmienny i wspólny
+    std::unique_ptr<EVP_CIPHER_CTX, void (*)(EVP_CIPHER_CTX*)> ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    bool ok = ctx && EVP_EncryptInit_ex2(ctx.get(), key.cipher.get(), key.key, key.iv, nullptr) == 1 &&
+              EVP_CIPHER_CTX_set_padding(ctx.get(), 0) == 1;
+
+    // Tryby strumieniowe (CTR, ChaCha20) mają blok 1 - wtedy nie ma niepełnego bloku
+    const size_t blockSize = EVP_CIPHER_get_block_size(key.cipher.get());
+    const size_t full = size - size % blockSize;
+    int written = 0;
+    for (size_t done = 0; ok && done < full; done += EVP_PIECE) {
+        const size_t piece = std::min(EVP_PIECE, full - done);
+        ok = EVP_EncryptUpdate(ctx.get(), out + done, &written, in + done, static_cast<int>(piece)) == 1 &&
+             static_cast<size_t>(written) == piece;
+    }
+    if (ok && full < size) {
+        // Ostatni blok dopełniony zerami, po zaszyfrowaniu obcięty (CBC łańcuchuje go dalej)
+        unsigned char block[EVP_MAX_BLOCK_LENGTH] = {0};
+        memcpy(block, in + full, size - full);
+        ok = EVP_EncryptUpdate(ctx.get(), block, &written, block, static_cast<int>(blockSize)) == 1 &&
+             static_cast<size_t>(written) == blockSize;
+        memcpy(out + full, block, size - full);
+    }
+    if (!ok) {
+        std::cerr << "Błąd: Szyfrowanie OpenSSL " << EVP_CIPHER_get0_name(key.cipher.get()) << " nie powiodło się"
+                  << std::endl;
+        ERR_clear_error();
+    }
+    return ok;
+}
@@ -0,0 +1,32 @@
+#ifndef EVP_CIPHER_H
+#define EVP_CIPHER_H
+
+#include <cstddef>
+#include <memory>
+#include <openssl/evp.h>
+
+/**
+ * Szyfry z OpenSSL EVP dla polityk z cipher_policies.h (AES z AES-NI, ChaCha20 z wektorowym
+ * asemblerem OpenSSL).
+ *
+ * Klucz i IV są wyprowadzane z klucza 56-bit zbioru danych (expandCipherKey z cipher_engine.h),
+ * więc zbiór da się odtworzyć z metadanych "algorithm" i "key56". Każde wywołanie evpEncrypt()
+ * startuje od tego samego IV / licznika, tak jak RC4 od początku strumienia klucza; w trybach
+ * blokowych (ECB, CBC) niepełny ostatni blok jest dopełniany zerami i obcinany.
+ */
+
+struct EvpCipherKey {
+    std::unique_ptr<EVP_CIPHER, void (*)(EVP_CIPHER*)> cipher{nullptr, EVP_CIPHER_free};
+    unsigned char key[EVP_MAX_KEY_LENGTH] = {0};
+    unsigned char iv[EVP_MAX_IV_LENGTH] = {0};
+};
+
+// Pobiera szyfr `evpName` (np. "AES-128-CTR") i wyprowadza klucz oraz IV z key56. False, gdy OpenSSL nie udostępnia szyfru.
+bool setEvpCipherKey(EvpCipherKey& key, const char* evpName, const unsigned char key56[7]);
+
+// Szyfruje `size` bajtów (in == out jest dozwolone); metoda bezpieczna dla wielu wątków.
+// False (z komunikatem na stderr), gdy którekolwiek wywołanie EVP się nie powiedzie - `out`
+// jest wtedy nieokreślone
+bool evpEncrypt(const EvpCipherKey& key, const unsigned char* in, unsigned char* out, size_t size);
+
+#endif // EVP_CIPHER_H
@@ -0,0 +1,94 @@
+#include "dataset_view.h"
+#include "feature_extractor.h"
+#include "feature_table.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * Tabela cech okien zbioru danych - wejście do uczenia klasyfikatora szyfrów.
+ *
+ * Użycie: extract_features <plik> <wyjście> [okno_KB=64] [etykieta] [wątki=0] [max_okien=0]
+ *   plik      - zbiór danych (kontener albo surowy plik) czytany przez DatasetView
+ *   wyjście   - tabela kolumnowa (feature_table.h), wiersz na każde pełne okno
+ *   etykieta  - domyślnie "algorithm" z metadanych kontenera
+ *   wątki     - 0 = wszystkie rdzenie; max_okien - 0 = cały plik
+ */
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Użycie: " << argv[0] << " <plik> <wyjście> [okno_KB=64] [etykieta] [wątki=0] [max_okien=0]"
+                  << std::endl;
+        return 1;
+    }
+    std::string inputPath = argv[1];
+    std::string outputPath = argv[2];
+    size_t windowKB = 64;
+    std::string label;
+    size_t threads = 0;
+    size_t maxWindows = 0;
+
+    if (argc > 3) {
+        windowKB = std::stoul(argv[3]);
+        if (windowKB == 0) {
+            std::cerr << "Błąd: Rozmiar okna musi być dodatni" << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 4) {
+        label = argv[4];
+    }
+    if (argc > 5) {
+        threads = std::stoul(argv[5]);
+    }
+    if (argc > 6) {
+        maxWindows = std::stoul(argv[6]);
+    }
+
+    DatasetView view;
+    if (!view.open(inputPath)) {
+        return 1;
+    }
+    if (label.empty()) {
+        label = view.isContainer() ? view.header().value("algorithm") : "";
+    }
+    if (label.empty()) {
+        label = "unknown";
+    }
+
+    const size_t windowSize = windowKB * 1024;
+    size_t windows = static_cast<size_t>(view.size() / windowSize);
+    if (maxWindows > 0) {
+        windows = std::min(windows, maxWindows);
+    }
+    if (windows == 0) {
+        std::cerr << "Błąd: Plik " << inputPath << " jest krótszy niż jedno okno (" << windowKB << " KB)" << std::endl;
+        return 1;
+    }
+
+    const size_t columns = FeatureExtractor::featureCount();
+    std::cout << "=== Ekstrakcja cech ===" << std::endl;
+    std::cout << "Plik: " << inputPath << ", okno: " << windowKB << " KB, okien: " << windows
+              << ", cech: " << columns << ", etykieta: " << label << std::endl;
+
+    WorkStealingPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    FeatureTable table = extractWindowFeatures(view, windowSize, windows, pool);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    table.metadata = {{"label", label}, {"source", inputPath}, {"window_kb", std::to_string(windowKB)}};
+    if (!saveFeatureTable(outputPath, table)) {
+        return 1;
+    }
+
+    const double gigabytes = static_cast<double>(windows) * static_cast<double>(windowSize) / 1e9;
+    const double throughput = gigabytes / elapsed.count();
+    std::cout << "Czas: " << std::fixed << std::setprecision(2) << elapsed.count() << " s, przepustowość: "
+              << std::setprecision(3) << throughput << " GB/s (" << throughput / pool.workerCount()
+              << " GB/s na rdzeń, wątków: " << pool.workerCount() << ", jądra: " << featureKernelName() << ")"
+              << std::endl;
+    std::cout << "Zapisano: " << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "fan_out_pipeline.h"
+#include "chunk_buffer_pool.h"
+#include <algorithm>
+#include <thread>
+
+FanOutPipeline::FanOutPipeline(size_t chunkCapacity, size_t maxInFlight)
+    : chunkCapacity(chunkCapacity), maxInFlight(std::max<size_t>(1, maxInFlight)) {}
+
+FanOutPipeline::Slot* FanOutPipeline::findReady(size_t index) {
+    for (Slot& slot : slots) {
+        if (slot.ready && slot.index == index) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void FanOutPipeline::producerLoop(size_t producer, size_t chunkCount, const ProduceFn& produce,
+                                  size_t consumerCount) {
+    while (true) {
+        Slot* slot = nullptr;
+        size_t index = 0;
+        {
+            // Slot i numer chunka pobierane razem - sloty trafiają do chunków w kolejności numerów,
+            // więc najstarszy oczekiwany chunk zawsze ma swój bufor
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return aborted || nextToProduce >= chunkCount || !freeSlots.empty(); });
+            if (aborted || nextToProduce >= chunkCount) {
+                return;
+            }
+            slot = &slots[freeSlots.back()];
+            freeSlots.pop_back();
+            index = nextToProduce++;
+        }
+
+        size_t size = produce(producer, index, slot->data, chunkCapacity);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot->index = index;
+            slot->size = size;
+            slot->remainingConsumers = consumerCount;
+            slot->ready = true;
+        }
+        changed.notify_all();
+    }
+}
+
+void FanOutPipeline::consumerLoop(size_t chunkCount, const ConsumeFn& consume) {
+    for (size_t index = 0; index < chunkCount; index++) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return aborted || (slot = findReady(index)) != nullptr; });
+            if (aborted) {
+                return;
+            }
+        }
+
+        // Dane slotu są tylko czytane - wszyscy konsumenci pracują na nim równolegle
+        bool ok = consume(index, slot->data, slot->size);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ok) {
+                aborted = true;
+            }
+            if (--slot->remainingConsumers == 0) {
+                slot->ready = false;
+                freeSlots.push_back(static_cast<size_t>(slot - slots.data()));
+            }
+        }
+        changed.notify_all();
+
+        if (!ok) {
+            return;
+        }
+    }
+}
+
+bool FanOutPipeline::run(size_t chunkCount, size_t producers, const ProduceFn& produce,
+                         const std::vector<ConsumeFn>& consumers) {
+    if (consumers.empty()) {
+        return true;
+    }
+
+    // Bufory z puli procesu (już zmapowane i wypełnione stronami), w limicie pamięci; bez
+    // pierwszego (lease() zgłasza błąd) potok nie rusza
+    ChunkBufferPool& pool = ChunkBufferPool::shared();
+    slots.clear();
+    freeSlots.clear();
+    for (size_t i = 0; i < maxInFlight; i++) {
+        unsigned char* data = i == 0 ? pool.lease(chunkCapacity) : pool.tryLease(chunkCapacity);
+        if (!data) {
+            break;
+        }
+        slots.emplace_back();
+        slots.back().data = data;
+        freeSlots.push_back(i);
+    }
+    if (slots.empty()) {
+        return false;
+    }
+    nextToProduce = 0;
+    aborted = false;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::max<size_t>(1, producers); i++) {
+        threads.emplace_back(&FanOutPipeline::producerLoop, this, i, chunkCount, std::cref(produce), consumers.size());
+    }
+    for (const ConsumeFn& consume : consumers) {
+        threads.emplace_back(&FanOutPipeline::consumerLoop, this, chunkCount, std::cref(consume));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (Slot& slot : slots) {
+        pool.giveBack(slot.data);
+    }
+    slots.clear();
+    return !aborted;
+}
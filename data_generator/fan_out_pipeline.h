@@ -0,0 +1,65 @@
+#ifndef FAN_OUT_PIPELINE_H
+#define FAN_OUT_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * Potok "wygeneruj raz, przetwórz wiele razy".
+ *
+ * Producenci wypełniają kolejne chunki (0, 1, 2, ...) w buforach z puli o stałej
+ * liczbie slotów; każdy gotowy chunk czytają wszyscy konsumenci, każdy w swoim
+ * wątku i w kolejności numerów chunków. Slot wraca do puli, gdy ostatni konsument
+ * skończy z nim pracę, więc pamięć jest ograniczona do maxInFlight chunków
+ * niezależnie od rozmiaru danych. Konsumenci dostają dane tylko do odczytu.
+ * Bufory slotów pochodzą z ChunkBufferPool na czas run(); przy limicie pamięci puli
+ * slotów może być mniej niż maxInFlight, a bez miejsca na jeden run() zwraca false.
+ *
+ * Sloty są przydzielane producentom w kolejności numerów chunków, dlatego przy
+ * jednym producencie produce() wywoływane jest ściśle po kolei - można w nim
+ * trzymać stan przenoszony między chunkami (np. łańcuch ziaren).
+ */
+class FanOutPipeline {
+public:
+    // Wypełnia chunk o numerze `index`; zwraca liczbę zapisanych bajtów (<= capacity).
+    // `producer` (0..producers-1) pozwala trzymać stan roboczy per wątek producenta
+    using ProduceFn = std::function<size_t(size_t producer, size_t index, unsigned char* buffer, size_t capacity)>;
+    // Przetwarza chunk; false przerywa cały potok
+    using ConsumeFn = std::function<bool(size_t index, const unsigned char* data, size_t size)>;
+
+    FanOutPipeline(size_t chunkCapacity, size_t maxInFlight);
+
+    FanOutPipeline(const FanOutPipeline&) = delete;
+    FanOutPipeline& operator=(const FanOutPipeline&) = delete;
+
+    // Przetwarza `chunkCount` chunków; zwraca false, jeśli któryś konsument przerwał potok
+    bool run(size_t chunkCount, size_t producers, const ProduceFn& produce, const std::vector<ConsumeFn>& consumers);
+
+private:
+    struct Slot {
+        unsigned char* data = nullptr;
+        size_t size = 0;
+        size_t index = 0;
+        size_t remainingConsumers = 0;
+        bool ready = false;
+    };
+
+    size_t chunkCapacity;
+    size_t maxInFlight;
+    std::vector<Slot> slots;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<size_t> freeSlots;
+    size_t nextToProduce = 0;
+    bool aborted = false;
+
+    void producerLoop(size_t producer, size_t chunkCount, const ProduceFn& produce, size_t consumerCount);
+    void consumerLoop(size_t chunkCount, const ConsumeFn& consume);
+    Slot* findReady(size_t index);
+};
+
+#endif // FAN_OUT_PIPELINE_H
@@ -0,0 +1,299 @@
+#include "feature_extractor.h"
+#include "dataset_view.h"
+#include "feature_extractor_impl.h"
+#include "nist_tests.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+const size_t BIGRAM_CELLS = 65536;
+const size_t BLOCK_FREQUENCY_LENGTH = 128;
+const uint64_t BLOCK_HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+// Okna w jednym zadaniu puli - mniej zadań, a wątek zostaje przy sąsiednich danych
+const size_t WINDOWS_PER_TASK = 16;
+
+struct FeatureKernelChoice {
+    void (*lagMatches)(const unsigned char* data, size_t size, size_t maxLag, uint64_t* matches);
+    const char* name;
+};
+
+FeatureKernelChoice selectFeatureKernel() {
+#ifdef CIPHERDATA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {featureLagMatchesAvx2, "avx2"};
+    }
+#endif
+    return {featureLagMatches64, "64-bit"};
+}
+
+const FeatureKernelChoice& featureKernel() {
+    static const FeatureKernelChoice choice = selectFeatureKernel();
+    return choice;
+}
+
+std::vector<std::string> makeFeatureNames() {
+    std::vector<std::string> names;
+    char name[32];
+    for (int b = 0; b < 256; b++) {
+        std::snprintf(name, sizeof(name), "byte_%03d", b);
+        names.push_back(name);
+    }
+    names.push_back("byte_entropy");
+    names.push_back("byte_chi_square");
+    names.push_back("bigram_chi_square");
+    names.push_back("block8_repeat_fraction");
+    names.push_back("block8_max_multiplicity");
+    for (size_t lag = 1; lag <= FeatureExtractor::MAX_LAG; lag++) {
+        std::snprintf(name, sizeof(name), "autocorr_%02zu", lag);
+        names.push_back(name);
+    }
+    names.push_back("nist_frequency_p");
+    names.push_back("nist_block_frequency_p");
+    names.push_back("nist_runs_p");
+    names.push_back("nist_cusum_forward_p");
+    names.push_back("nist_cusum_backward_p");
+    names.push_back("nist_longest_run_p");
+    names.push_back("ones_fraction");
+    return names;
+}
+
+// p-wartość z wyniku testu albo 0, gdy okno jest za krótkie dla testu
+float pValueAt(const std::vector<double>& pValues, size_t k) {
+    return k < pValues.size() ? static_cast<float>(pValues[k]) : 0.0f;
+}
+
+} // namespace
+
+void featureLagMatches64(const unsigned char* data, size_t size, size_t maxLag, uint64_t* matches) {
+    // Bajt zerowy w x ^ y = zgodność; wykrywany bez przeniesień między bajtami, a bity 0x80
+    // zgodnych bajtów sumuje mnożenie (bez popcount, który bez -mpopcnt jest wywołaniem funkcji)
+    const uint64_t low = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t ones = 0x0101010101010101ULL;
+    for (size_t lag = 1; lag <= maxLag && lag < size; lag++) {
+        const size_t count = size - lag;
+        uint64_t sum = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            uint64_t a, b;
+            std::memcpy(&a, data + i, 8);
+            std::memcpy(&b, data + i + lag, 8);
+            uint64_t x = a ^ b;
+            sum += ((~(((x & low) + low) | x | low) >> 7) * ones) >> 56;
+        }
+        for (; i < count; i++) {
+            sum += data[i] == data[i + lag];
+        }
+        matches[lag - 1] += sum;
+    }
+}
+
+const char* featureKernelName() {
+    return featureKernel().name;
+}
+
+FeatureExtractor::FeatureExtractor() : bigramCounts(BIGRAM_CELLS, 0) {}
+
+const std::vector<std::string>& FeatureExtractor::featureNames() {
+    static const std::vector<std::string> names = makeFeatureNames();
+    return names;
+}
+
+unsigned FeatureExtractor::resetBlockSlots(size_t blocks) {
+    // Tablica co najmniej 2x większa od liczby bloków - krótkie ciągi próbkowania
+    size_t capacity = 16;
+    while (capacity < 2 * blocks) {
+        capacity *= 2;
+    }
+    if (blockSlots.size() != capacity) {
+        blockSlots.assign(capacity, BlockSlot{0, 0, 0});
+        generation = 0;
+    }
+    if (++generation == 0) {
+        std::fill(blockSlots.begin(), blockSlots.end(), BlockSlot{0, 0, 0});
+        generation = 1;
+    }
+    return 64 - static_cast<unsigned>(__builtin_ctzll(capacity));
+}
+
+void FeatureExtractor::scanWindow(const unsigned char* data, size_t size, WindowCounts& counts) {
+    // Cztery histogramy jak w accumulateByteHistogram - kolejne bajty nie czekają na ten sam licznik
+    uint64_t histograms[4][256] = {};
+
+    // sum c^2 par rośnie przyrostowo: licznik c -> c + 1 dodaje 2c + 1
+    uint64_t squares = 0;
+    auto addPair = [&](unsigned char first, unsigned char second) {
+        uint32_t& count = bigramCounts[static_cast<size_t>(first) << 8 | second];
+        squares += 2 * static_cast<uint64_t>(count) + 1;
+        count++;
+    };
+
+    const unsigned shift = resetBlockSlots(size / 8);
+    const size_t mask = blockSlots.size() - 1;
+    size_t repeats = 0;
+    uint32_t maxCount = 0;
+    auto addBlock = [&](const unsigned char* p) {
+        uint64_t block;
+        std::memcpy(&block, p, 8);
+        size_t slot = static_cast<size_t>((block * BLOCK_HASH_MULTIPLIER) >> shift);
+        while (blockSlots[slot].generation == generation && blockSlots[slot].block != block) {
+            slot = (slot + 1) & mask;
+        }
+        BlockSlot& entry = blockSlots[slot];
+        if (entry.generation == generation) {
+            entry.count++;
+            repeats++;
+        } else {
+            entry = BlockSlot{block, generation, 1};
+        }
+        maxCount = std::max(maxCount, entry.count);
+    };
+
+    // Słowo 8 bajtów: 8 bajtów histogramu, 8 par (ostatnia z pierwszym bajtem następnego słowa), 1 blok
+    size_t i = 0;
+    for (; i + 8 < size; i += 8) {
+        const unsigned char* p = data + i;
+        histograms[0][p[0]]++;
+        histograms[1][p[1]]++;
+        histograms[2][p[2]]++;
+        histograms[3][p[3]]++;
+        histograms[0][p[4]]++;
+        histograms[1][p[5]]++;
+        histograms[2][p[6]]++;
+        histograms[3][p[7]]++;
+        for (size_t j = 0; j < 8; j++) {
+            addPair(p[j], p[j + 1]);
+        }
+        addBlock(p);
+    }
+    for (; i < size; i++) {
+        histograms[i & 3][data[i]]++;
+        if (i + 1 < size) {
+            addPair(data[i], data[i + 1]);
+        }
+        if (i % 8 == 0 && i + 8 <= size) {
+            addBlock(data + i);
+        }
+    }
+
+    // Zerowanie liczników par: przy dużym oknie cała tablica, przy małym tylko zapisane komórki
+    if (size >= BIGRAM_CELLS / 8) {
+        std::fill(bigramCounts.begin(), bigramCounts.end(), 0);
+    } else {
+        for (size_t k = 0; k + 1 < size; k++) {
+            bigramCounts[static_cast<size_t>(data[k]) << 8 | data[k + 1]] = 0;
+        }
+    }
+
+    for (size_t b = 0; b < 256; b++) {
+        counts.histogram[b] = histograms[0][b] + histograms[1][b] + histograms[2][b] + histograms[3][b];
+    }
+    counts.bigramSquares = squares;
+    counts.blockRepeats = repeats;
+    counts.maxBlockCount = maxCount;
+}
+
+void FeatureExtractor::extract(const unsigned char* data, size_t size, float* out) {
+    float* column = out;
+
+    WindowCounts counts;
+    scanWindow(data, size, counts);
+    const uint64_t* histogram = counts.histogram;
+    const double bytes = static_cast<double>(std::max<size_t>(size, 1));
+    const double expected = bytes / 256.0;
+    double entropy = 0.0, chiSquare = 0.0;
+    uint64_t ones = 0;
+    for (size_t b = 0; b < 256; b++) {
+        double p = static_cast<double>(histogram[b]) / bytes;
+        *column++ = static_cast<float>(p);
+        if (histogram[b] > 0) {
+            entropy -= p * std::log2(p);
+        }
+        double diff = static_cast<double>(histogram[b]) - expected;
+        chiSquare += diff * diff / expected;
+        ones += histogram[b] * static_cast<uint64_t>(__builtin_popcount(static_cast<unsigned>(b)));
+    }
+    *column++ = static_cast<float>(entropy);
+    *column++ = static_cast<float>(chiSquare);
+
+    // sum (c - e)^2 / e = sum c^2 / e - N
+    double bigramChiSquare = 0.0;
+    if (size >= 2) {
+        const double pairs = static_cast<double>(size - 1);
+        const double expectedPairs = pairs / static_cast<double>(BIGRAM_CELLS);
+        bigramChiSquare = static_cast<double>(counts.bigramSquares) / expectedPairs - pairs;
+    }
+    *column++ = static_cast<float>(bigramChiSquare);
+
+    const size_t blocks = size / 8;
+    *column++ = blocks > 0 ? static_cast<float>(static_cast<double>(counts.blockRepeats) / blocks) : 0.0f;
+    *column++ = blocks > 0 ? static_cast<float>(static_cast<double>(counts.maxBlockCount) / blocks) : 0.0f;
+
+    uint64_t matches[MAX_LAG] = {};
+    featureKernel().lagMatches(data, size, MAX_LAG, matches);
+    for (size_t lag = 1; lag <= MAX_LAG; lag++) {
+        *column++ = lag < size ? static_cast<float>(static_cast<double>(matches[lag - 1]) / (size - lag)) : 0.0f;
+    }
+
+    const size_t n = 8 * size;
+    std::vector<double> cusum = nistCumulativeSumsPacked(data, n);
+    *column++ = pValueAt(nistFrequencyPacked(data, n), 0);
+    *column++ = pValueAt(nistBlockFrequencyPacked(data, n, BLOCK_FREQUENCY_LENGTH), 0);
+    *column++ = pValueAt(nistRunsPacked(data, n), 0);
+    *column++ = pValueAt(cusum, 0);
+    *column++ = pValueAt(cusum, 1);
+    *column++ = pValueAt(nistLongestRunOfOnesPacked(data, n), 0);
+    *column++ = static_cast<float>(static_cast<double>(ones) / std::max<double>(static_cast<double>(n), 1.0));
+}
+
+FeatureTable extractWindowFeatures(const DatasetView& view, size_t windowSize, size_t maxWindows,
+                                   WorkStealingPool& pool) {
+    FeatureTable table;
+    table.names = FeatureExtractor::featureNames();
+    table.windowSize = windowSize;
+    size_t windows = windowSize > 0 ? static_cast<size_t>(view.size() / windowSize) : 0;
+    if (maxWindows > 0) {
+        windows = std::min(windows, maxWindows);
+    }
+    if (windows == 0) {
+        return table;
+    }
+
+    std::vector<std::unique_ptr<FeatureExtractor>> extractors;
+    for (size_t w = 0; w < pool.workerCount(); w++) {
+        extractors.push_back(std::make_unique<FeatureExtractor>());
+    }
+
+    // Wiersze liczone po kolei w pamięci, do kolumn przepisywane po zakończeniu
+    const size_t columns = table.columns();
+    std::vector<float> rows(windows * columns);
+    for (size_t first = 0; first < windows; first += WINDOWS_PER_TASK) {
+        size_t last = std::min(windows, first + WINDOWS_PER_TASK);
+        pool.submit([&, first, last](size_t worker) {
+            uint64_t offset = static_cast<uint64_t>(first) * windowSize;
+            size_t bytes = (last - first) * windowSize;
+            view.prefetch(offset, bytes);
+            for (size_t w = first; w < last; w++) {
+                DataChunk window = view.chunk(static_cast<uint64_t>(w) * windowSize, windowSize);
+                extractors[worker]->extract(window.data, window.size, rows.data() + w * columns);
+            }
+            view.release(offset, bytes);
+        });
+    }
+    pool.wait();
+
+    table.rows = windows;
+    table.values.resize(windows * columns);
+    for (size_t r = 0; r < windows; r++) {
+        for (size_t c = 0; c < columns; c++) {
+            table.values[c * windows + r] = rows[r * columns + c];
+        }
+    }
+    return table;
+}
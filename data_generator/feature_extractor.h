@@ -0,0 +1,84 @@
+#ifndef FEATURE_EXTRACTOR_H
+#define FEATURE_EXTRACTOR_H
+
+#include "feature_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Wektor cech okna danych (np. 64 KB szyfrogramu) dla klasyfikatora szyfrów.
+ *
+ * Kolumny (featureNames()):
+ *   byte_000..byte_255       częstości bajtów
+ *   byte_entropy             entropia bajtów [bit/bajt]
+ *   byte_chi_square          chi-kwadrat histogramu bajtów (255 stopni swobody)
+ *   bigram_chi_square        chi-kwadrat par sąsiednich bajtów (65535 stopni swobody)
+ *   block8_repeat_fraction   udział bloków 8-bajtowych (wyrównanych) powtarzających wcześniejszy
+ *                            blok okna - wyciek ECB dla szyfrów 64-bitowych
+ *   block8_max_multiplicity  najczęstszy blok 8-bajtowy: liczba wystąpień / liczba bloków
+ *   autocorr_01..autocorr_64 udział i z data[i] == data[i + lag] (losowe: 1/256; okres klucza XOR)
+ *   nist_*_p                 p-wartości Frequency, BlockFrequency (M = 128), Runs, CumulativeSums
+ *                            (przód i tył), LongestRunOfOnes - jak w nist_tests.h
+ *   ones_fraction            udział bitów 1
+ *
+ * Histogram, pary bajtów i bloki liczy jedna pętla po oknie (każde słowo 8 bajtów jest czytane
+ * raz), pozostałe jądra pracują na danych już w cache (okno mieści się w L2). Zgodności
+ * przesunięć i testy NIST liczą warianty AVX2 wybierane w czasie działania.
+ * Obiekt trzyma tablice robocze (pary bajtów, bloki), więc każdy wątek używa własnego.
+ */
+class FeatureExtractor {
+public:
+    static const size_t MAX_LAG = 64;
+
+    FeatureExtractor();
+
+    FeatureExtractor(const FeatureExtractor&) = delete;
+    FeatureExtractor& operator=(const FeatureExtractor&) = delete;
+
+    static const std::vector<std::string>& featureNames();
+    static size_t featureCount() { return featureNames().size(); }
+
+    // Zapisuje featureCount() cech okna do `out`
+    void extract(const unsigned char* data, size_t size, float* out);
+
+private:
+    // Pary bajtów: liczniki zerowane po każdym oknie tylko tam, gdzie okno coś zapisało
+    std::vector<uint32_t> bigramCounts;
+
+    // Bloki 8-bajtowe: adresowanie otwarte, znacznik pokolenia zamiast czyszczenia tablicy
+    struct BlockSlot {
+        uint64_t block;
+        uint32_t generation;
+        uint32_t count;
+    };
+    std::vector<BlockSlot> blockSlots;
+    uint32_t generation = 0;
+
+    // Wynik jednego przebiegu po oknie
+    struct WindowCounts {
+        uint64_t histogram[256];
+        uint64_t bigramSquares;  // suma kwadratów liczników par bajtów
+        size_t blockRepeats;     // bloki powtarzające wcześniejszy blok okna
+        uint32_t maxBlockCount;  // liczba wystąpień najczęstszego bloku
+    };
+
+    // Histogram bajtów, pary bajtów i bloki 8-bajtowe liczone w jednej pętli po oknie
+    void scanWindow(const unsigned char* data, size_t size, WindowCounts& counts);
+    // Przygotowuje tablicę bloków dla `blocks` bloków; zwraca przesunięcie haszu
+    unsigned resetBlockSlots(size_t blocks);
+};
+
+class DatasetView;
+class WorkStealingPool;
+
+// Tabela cech kolejnych pełnych okien danych widoku (najwyżej maxWindows, 0 = wszystkie),
+// liczona równolegle na puli - każdy wątek ma własny FeatureExtractor. Bez metadanych.
+FeatureTable extractWindowFeatures(const DatasetView& view, size_t windowSize, size_t maxWindows,
+                                   WorkStealingPool& pool);
+
+// Nazwa wybranego wariantu jąder ("avx2" / "64-bit")
+const char* featureKernelName();
+
+#endif // FEATURE_EXTRACTOR_H
@@ -0,0 +1,60 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "feature_extractor_impl.h"
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+
+// Liczniki bajtowe przepełniają się po 255 porównaniach
+constexpr size_t BYTE_COUNTER_STEPS = 255;
+
+inline uint64_t horizontalSum64(__m256i v) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+}
+
+} // namespace
+
+void featureLagMatchesAvx2(const unsigned char* data, size_t size, size_t maxLag, uint64_t* matches) {
+    // vpcmpeqb daje -1 dla zgodnych bajtów: odejmowanie zlicza je w bajtach, vpsadbw sumuje co 255 kroków.
+    // Cztery przesunięcia naraz dzielą odczyt data[i] i pętlę.
+    size_t lag = 1;
+    for (; lag + 3 <= maxLag && lag + 3 < size; lag += 4) {
+        const size_t count = size - (lag + 3);
+        __m256i total[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                            _mm256_setzero_si256()};
+        size_t i = 0;
+        while (i + 32 <= count) {
+            __m256i counters[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                                   _mm256_setzero_si256()};
+            const size_t end = std::min(count & ~size_t(31), i + 32 * BYTE_COUNTER_STEPS);
+            for (; i < end; i += 32) {
+                const unsigned char* p = data + i;
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                for (size_t k = 0; k < 4; k++) {
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + lag + k));
+                    counters[k] = _mm256_sub_epi8(counters[k], _mm256_cmpeq_epi8(a, b));
+                }
+            }
+            for (size_t k = 0; k < 4; k++) {
+                total[k] = _mm256_add_epi64(total[k], _mm256_sad_epu8(counters[k], _mm256_setzero_si256()));
+            }
+        }
+        for (size_t k = 0; k < 4; k++) {
+            uint64_t sum = horizontalSum64(total[k]);
+            // Ogon wspólnej części i pozycje, które ma tylko krótsze przesunięcie
+            for (size_t j = i; j + lag + k < size; j++) {
+                sum += data[j] == data[j + lag + k];
+            }
+            matches[lag + k - 1] += sum;
+        }
+    }
+    // Pozostałe przesunięcia (maxLag niepodzielne przez 4 albo krótkie dane)
+    for (; lag <= maxLag && lag < size; lag++) {
+        uint64_t sum = 0;
+        for (size_t j = 0; j + lag < size; j++) {
+            sum += data[j] == data[j + lag];
+        }
+        matches[lag - 1] += sum;
+    }
+}
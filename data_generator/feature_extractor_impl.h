@@ -0,0 +1,14 @@
+#ifndef FEATURE_EXTRACTOR_IMPL_H
+#define FEATURE_EXTRACTOR_IMPL_H
+
+/**
+ * Wewnętrzne jądra feature_extractor dla kolejnych zestawów instrukcji.
+ */
+
+#include "feature_extractor.h"
+
+// matches[lag - 1] += liczba i (i + lag < size), dla których data[i] == data[i + lag], lag = 1..maxLag
+void featureLagMatches64(const unsigned char* data, size_t size, size_t maxLag, uint64_t* matches);
+void featureLagMatchesAvx2(const unsigned char* data, size_t size, size_t maxLag, uint64_t* matches);
+
+#endif // FEATURE_EXTRACTOR_IMPL_H
@@ -0,0 +1,184 @@
+#include "feature_table.h"
+#include "file_io.h"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+const size_t FIXED_HEADER_SIZE = 48;
+const size_t DATA_ALIGNMENT = 4096;
+
+void put32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+void put64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint32_t get32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+uint64_t get64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+// Dzieli tekst na linie (bez pustej linii po ostatnim '\n')
+std::vector<std::string> splitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        lines.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return lines;
+}
+
+} // namespace
+
+long FeatureTable::columnIndex(const std::string& name) const {
+    for (size_t c = 0; c < names.size(); c++) {
+        if (names[c] == name) {
+            return static_cast<long>(c);
+        }
+    }
+    return -1;
+}
+
+std::string FeatureTable::value(const std::string& key) const {
+    for (const auto& entry : metadata) {
+        if (entry.first == key) {
+            return entry.second;
+        }
+    }
+    return "";
+}
+
+bool saveFeatureTable(const std::string& path, const FeatureTable& table) {
+    if (table.values.size() != table.columns() * table.rows) {
+        std::cerr << "Błąd: Tabela cech ma " << table.values.size() << " wartości zamiast "
+                  << table.columns() * table.rows << std::endl;
+        return false;
+    }
+    std::string metadata;
+    for (const auto& entry : table.metadata) {
+        metadata += entry.first + "=" + entry.second + "\n";
+    }
+    std::string names;
+    for (const auto& name : table.names) {
+        names += name + "\n";
+    }
+    const size_t textEnd = FIXED_HEADER_SIZE + metadata.size() + names.size();
+    const uint64_t dataOffset = (textEnd + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+
+    std::vector<unsigned char> header(dataOffset, 0);
+    std::memcpy(header.data(), FEATURE_TABLE_MAGIC, sizeof(FEATURE_TABLE_MAGIC));
+    put32(header.data() + 8, FEATURE_TABLE_VERSION);
+    put32(header.data() + 12, static_cast<uint32_t>(table.columns()));
+    put64(header.data() + 16, table.rows);
+    put64(header.data() + 24, table.windowSize);
+    put64(header.data() + 32, dataOffset);
+    put32(header.data() + 40, static_cast<uint32_t>(metadata.size()));
+    put32(header.data() + 44, static_cast<uint32_t>(names.size()));
+    std::memcpy(header.data() + FIXED_HEADER_SIZE, metadata.data(), metadata.size());
+    std::memcpy(header.data() + FIXED_HEADER_SIZE + metadata.size(), names.data(), names.size());
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można utworzyć pliku " << path << std::endl;
+        return false;
+    }
+    bool ok = pwriteAll(fd, header.data(), header.size(), 0);
+
+    // Kolumna po kolumnie, każda zamieniana na little endian w osobnym buforze
+    std::vector<unsigned char> encoded(table.rows * 4);
+    for (size_t c = 0; c < table.columns() && ok; c++) {
+        const float* column = table.column(c);
+        for (uint64_t r = 0; r < table.rows; r++) {
+            uint32_t bits;
+            std::memcpy(&bits, &column[r], sizeof(bits));
+            put32(encoded.data() + 4 * r, bits);
+        }
+        ok = pwriteAll(fd, encoded.data(), encoded.size(), static_cast<off_t>(dataOffset + c * encoded.size()));
+    }
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Błąd: Zapis do pliku " << path << " nie powiódł się" << std::endl;
+    }
+    return ok;
+}
+
+bool loadFeatureTable(const std::string& path, FeatureTable& table) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Błąd: Nie można otworzyć pliku " << path << std::endl;
+        return false;
+    }
+    unsigned char fixed[FIXED_HEADER_SIZE];
+    if (preadAll(fd, fixed, sizeof(fixed), 0) != sizeof(fixed) ||
+        std::memcmp(fixed, FEATURE_TABLE_MAGIC, sizeof(FEATURE_TABLE_MAGIC)) != 0) {
+        std::cerr << "Błąd: " << path << " nie jest tabelą cech" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    uint32_t version = get32(fixed + 8);
+    uint32_t columns = get32(fixed + 12);
+    uint64_t dataOffset = get64(fixed + 32);
+    uint32_t metadataSize = get32(fixed + 40);
+    uint32_t namesSize = get32(fixed + 44);
+    if (version != FEATURE_TABLE_VERSION || FIXED_HEADER_SIZE + metadataSize + namesSize > dataOffset) {
+        std::cerr << "Błąd: Nieobsługiwana wersja tabeli cech (" << version << ")" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    table.rows = get64(fixed + 16);
+    table.windowSize = get64(fixed + 24);
+
+    std::string text(metadataSize + namesSize, '\0');
+    bool ok = preadAll(fd, reinterpret_cast<unsigned char*>(&text[0]), text.size(), FIXED_HEADER_SIZE) == text.size();
+    table.metadata.clear();
+    for (const auto& line : splitLines(text.substr(0, metadataSize))) {
+        size_t separator = line.find('=');
+        if (separator != std::string::npos) {
+            table.metadata.emplace_back(line.substr(0, separator), line.substr(separator + 1));
+        }
+    }
+    table.names = splitLines(text.substr(metadataSize));
+    ok = ok && table.names.size() == columns;
+
+    std::vector<unsigned char> encoded(table.rows * 4);
+    table.values.assign(static_cast<size_t>(columns) * table.rows, 0.0f);
+    for (size_t c = 0; c < columns && ok; c++) {
+        ok = preadAll(fd, encoded.data(), encoded.size(), static_cast<off_t>(dataOffset + c * encoded.size())) ==
+             encoded.size();
+        float* column = table.values.data() + c * table.rows;
+        for (uint64_t r = 0; r < table.rows && ok; r++) {
+            uint32_t bits = get32(encoded.data() + 4 * r);
+            std::memcpy(&column[r], &bits, sizeof(bits));
+        }
+    }
+    ::close(fd);
+    if (!ok) {
+        std::cerr << "Błąd: Uszkodzona albo skrócona tabela cech " << path << std::endl;
+    }
+    return ok;
+}
@@ -0,0 +1,49 @@
+#ifndef FEATURE_TABLE_H
+#define FEATURE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Tabela cech okien (feature_extractor.h) w pliku kolumnowym - wejście do uczenia klasyfikatora.
+ *
+ *   [0, dataOffset)   nagłówek: pola stałe, metadane "klucz=wartość\n", nazwy kolumn "nazwa\n"
+ *   [dataOffset, ...) kolumny: rowCount wartości float32 (little endian) kolumna po kolumnie
+ *
+ * Pola stałe (little endian): 0 magic "CIPHFEAT", 8 wersja u32, 12 liczba kolumn u32,
+ * 16 liczba wierszy u64, 24 rozmiar okna u64, 32 dataOffset u64, 40 długość metadanych u32,
+ * 44 długość nazw u32, 48 metadane i nazwy. dataOffset jest wielokrotnością 4 KB, więc
+ * kolumny można mapować i czytać wprost jako tablice float (np. numpy.memmap z przesunięciem).
+ */
+
+const char FEATURE_TABLE_MAGIC[8] = {'C', 'I', 'P', 'H', 'F', 'E', 'A', 'T'};
+const uint32_t FEATURE_TABLE_VERSION = 1;
+
+struct FeatureTable {
+    std::vector<std::string> names;                              // nazwy kolumn
+    std::vector<std::pair<std::string, std::string>> metadata;   // np. label, źródło
+    uint64_t windowSize = 0;                                     // bajty danych na wiersz
+    uint64_t rows = 0;
+    std::vector<float> values;                                   // kolumnowo: values[c * rows + r]
+
+    size_t columns() const { return names.size(); }
+    const float* column(size_t c) const { return values.data() + c * rows; }
+    float at(uint64_t row, size_t c) const { return values[c * rows + row]; }
+
+    // Indeks kolumny o danej nazwie albo -1
+    long columnIndex(const std::string& name) const;
+
+    // Wartość metadanej albo "" (gdy brak klucza)
+    std::string value(const std::string& key) const;
+};
+
+// Zapisuje tabelę; przy błędzie wypisuje komunikat i zwraca false
+bool saveFeatureTable(const std::string& path, const FeatureTable& table);
+
+// Wczytuje tabelę; przy błędzie (format, wersja, skrócony plik) wypisuje komunikat i zwraca false
+bool loadFeatureTable(const std::string& path, FeatureTable& table);
+
+#endif // FEATURE_TABLE_H
@@ -0,0 +1,30 @@
+#include "file_io.h"
+#include <cerrno>
+#include <unistd.h>
+
+bool pwriteAll(int fd, const unsigned char* data, size_t size, off_t offset) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = pwrite(fd, data + written, size - written, offset + static_cast<off_t>(written));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+size_t preadAll(int fd, unsigned char* data, size_t size, off_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = pread(fd, data + total, size - total, offset + static_cast<off_t>(total));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+    return total;
+}
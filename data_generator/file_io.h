@@ -0,0 +1,18 @@
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include <cstddef>
+#include <sys/types.h>
+
+/**
+ * Zapis i odczyt pozycyjny (pwrite/pread) - wiele wątków może pracować
+ * na tym samym deskryptorze, każdy na swoim zakresie pliku.
+ */
+
+// Zapisuje cały bufor pod zadanym przesunięciem (ponawia przy częściowym zapisie / EINTR)
+bool pwriteAll(int fd, const unsigned char* data, size_t size, off_t offset);
+
+// Czyta do `size` bajtów od przesunięcia; zwraca liczbę przeczytanych bajtów (mniej tylko na końcu pliku)
+size_t preadAll(int fd, unsigned char* data, size_t size, off_t offset);
+
+#endif // FILE_IO_H
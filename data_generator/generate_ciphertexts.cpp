@@ -1,3 +1,10 @@
+#include "async_output.h"
+#include "chunk_buffer_pool.h"
+#include "cipher_engine.h"
+#include "dataset_writer.h"
+#include "plaintext_source.h"
+#include "stream_stats.h"
+#include "work_stealing_pool.h"
 #include <iostream>
 #include <vector>
 #include <random>
@@ -8,16 +15,8 @@
 #include <sstream>
 #include <thread>
 #include <mutex>
-#include <openssl/evp.h>
-#include <openssl/rand.h>
-#include <openssl/des.h>
-#include <openssl/blowfish.h>
-#include <openssl/cast.h>
-#include <openssl/rc4.h>
-
-// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <atomic>
+#include <memory>
 
 class CiphertextGenerator {
 private:
@@ -26,105 +25,12 @@ private:
     const size_t FILE_SIZE_GB = 8;
     const size_t FILE_SIZE_BYTES = FILE_SIZE_GB * 1024ULL * 1024ULL * 1024ULL;
     const size_t CHUNK_SIZE = 100 * 1024 * 1024; // 100 MB chunków dla efektywnego przetwarzania
+    std::string plaintextMode; // źródło losowego tekstu jawnego
+    bool writeFiles;           // false = tylko statystyki, bez zapisu 8 GB na dysk
+    bool collectStats;         // statystyki strumienia liczone w locie z zaszyfrowanych chunków
     std::mutex coutMutex; // Mutex dla synchronizacji wyjścia konsoli
-    
-    void generate56BitKey(unsigned int seed) {
-        std::mt19937 keyGen(seed);
-        std::uniform_int_distribution<unsigned char> dist(0, 255);
-        for (int i = 0; i < 7; i++) {
-            key56[i] = dist(keyGen);
-        }
-    }
-    
-    void generateRandomData(std::vector<unsigned char>& data, size_t size, unsigned int seed) {
-        data.resize(size);
-        std::mt19937 localGen(seed);
-        std::uniform_int_distribution<unsigned char> dist(0, 255);
-        for (size_t i = 0; i < size; i++) {
-            data[i] = dist(localGen);
-        }
-    }
-    
-    std::vector<unsigned char> encryptCAST(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        CAST_KEY castKey;
-        
-        CAST_set_key(&castKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += CAST_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(CAST_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[CAST_BLOCK] = {0};
-            unsigned char output[CAST_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            CAST_ecb_encrypt(input, output, &castKey, CAST_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptRC4(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        RC4_KEY rc4Key;
-        
-        RC4_set_key(&rc4Key, 7, key56);
-        RC4(&rc4Key, data.size(), data.data(), encrypted.data());
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptDES(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        DES_key_schedule desKey;
-        
-        unsigned char desKey8[8];
-        memcpy(desKey8, key56, 7);
-        desKey8[7] = 0;
-        
-        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
-        DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(desKey8), &desKey);
-        
-        for (size_t i = 0; i < data.size(); i += 8) {
-            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
-            unsigned char input[8] = {0};
-            unsigned char output[8];
-            
-            memcpy(input, &data[i], blockSize);
-            DES_ecb_encrypt(reinterpret_cast<const_DES_cblock*>(input),
-                          reinterpret_cast<DES_cblock*>(output),
-                          &desKey, DES_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptBlowfish(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        BF_KEY bfKey;
-        
-        BF_set_key(&bfKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += BF_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(BF_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[BF_BLOCK] = {0};
-            unsigned char output[BF_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            BF_ecb_encrypt(input, output, &bfKey, BF_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    bool writeChunkToFile(std::ofstream& file, const std::vector<unsigned char>& data) {
-        file.write(reinterpret_cast<const char*>(data.data()), data.size());
-        return file.good();
-    }
+    WorkStealingPool pool; // wspólna pula dla chunków wszystkich algorytmów
+    std::unique_ptr<AsyncOutputSink> sink; // pierścień buforów chunków i asynchroniczny zapis
     
     void createDirectory(const std::string& dir) {
         std::filesystem::create_directories(dir);
@@ -137,101 +43,189 @@ private:
         return std::to_string(bytes / (1024ULL * 1024ULL * 1024ULL)) + " GB";
     }
 
+    // Stan jednego pliku wyjściowego współdzielony przez zadania-chunki w puli
+    struct FileJob {
+        std::string alg;
+        std::string filepath;
+        std::unique_ptr<CipherEngine> engine;
+        std::unique_ptr<DatasetWriter> writer; // kontener (albo surowy plik) przez sink
+        std::unique_ptr<PlaintextSource> source; // tekst jawny liczony z (ziarno, offset chunka)
+        std::vector<StreamStats> workerStats; // akumulator per wątek roboczy, łączone w finishFile()
+        std::atomic<size_t> bytesWritten{0};
+        std::atomic<bool> failed{false};
+        size_t lastProgressReport = 0; // chronione przez coutMutex
+    };
+
+    void encryptChunk(FileJob& job, size_t offset, size_t worker) {
+        // Po błędzie zapisu pliku pozostałe chunki nie są już szyfrowane
+        if (job.failed || (writeFiles && job.writer->failed())) {
+            job.failed = true;
+            return;
+        }
+        size_t chunkSize = std::min(CHUNK_SIZE, FILE_SIZE_BYTES - offset);
+        // Wolny bufor pierścienia - czeka, gdy wszystkie są jeszcze w zapisie
+        unsigned char* chunk = sink->acquire();
+        if (chunk == nullptr) {
+            job.failed = true;
+            return;
+        }
+
+        // Dane zależą tylko od przesunięcia chunka, więc kolejność wykonania nie ma znaczenia
+        job.source->fill(chunk, chunkSize, offset);
+
+        // Szyfruj dane algorytmem (silnik jest niezmienny - bezpieczny dla wielu wątków);
+        // chunk po błędzie szyfrowania nie może trafić do pliku
+        if (!job.engine->encryptInPlace(chunk, chunkSize)) {
+            sink->release(chunk);
+            job.failed = true;
+            return;
+        }
+
+        if (collectStats) {
+            job.workerStats[worker].add(chunk, chunkSize, offset);
+        }
+
+        // Zapis chunka (i CRC do indeksu kontenera) idzie w tle; błąd zgłosi finishFile()
+        if (writeFiles) {
+            job.writer->submitChunk(offset / CHUNK_SIZE, chunk, chunkSize);
+        } else {
+            sink->release(chunk);
+        }
+
+        size_t bytesWritten = job.bytesWritten.fetch_add(chunkSize) + chunkSize;
+
+        // Wyświetl postęp co 500 MB lub na końcu
+        size_t progressInterval = 500 * 1024 * 1024; // 500 MB
+        std::lock_guard<std::mutex> lock(coutMutex);
+        if (bytesWritten - job.lastProgressReport >= progressInterval ||
+            bytesWritten >= FILE_SIZE_BYTES) {
+            double progress = (static_cast<double>(bytesWritten) / FILE_SIZE_BYTES) * 100.0;
+            std::cout << "  [" << job.alg << "] Postęp: " << std::fixed << std::setprecision(1) << progress
+                      << "% (" << formatBytes(bytesWritten) << " / "
+                      << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
+            job.lastProgressReport = bytesWritten;
+        }
+    }
+
 public:
-    CiphertextGenerator(unsigned int baseSeed) : generator(baseSeed) {
-        generate56BitKey(baseSeed);
+    // threads == 0 oznacza wszystkie rdzenie; plaintextMode: "mt19937" albo "philox" (plaintext_source.h)
+    CiphertextGenerator(unsigned int baseSeed, size_t threads = 0, const std::string& plaintextMode = "mt19937",
+                        bool writeFiles = true, bool collectStats = false)
+        : generator(baseSeed), plaintextMode(plaintextMode), writeFiles(writeFiles), collectStats(collectStats),
+          pool(threads) {
+        // Bufor na wątek roboczy plus dwa w zapisie - szyfrowanie nie czeka na dysk
+        sink = std::make_unique<AsyncOutputSink>(
+            AsyncOutputOptions::fromEnvironment(CHUNK_SIZE, pool.workerCount() + 2));
+        generate56BitKey(baseSeed, key56);
     }
 
-    void generateCiphertextForAlgorithm(const std::string& alg, const std::string& outputDir, unsigned int baseSeed) {
+    /**
+     * Otwiera plik dla algorytmu i zleca puli po jednym zadaniu na chunk.
+     * Zwraca stan pliku (nullptr przy błędzie); zadania kończy dopiero pool.wait().
+     */
+    std::unique_ptr<FileJob> generateCiphertextForAlgorithm(const std::string& alg, const std::string& outputDir,
+                                                            unsigned int baseSeed) {
         std::string algDir = outputDir + "/" + alg;
         createDirectory(algDir);
 
         std::ostringstream filename;
         filename << algDir << "/" << alg << "_" << baseSeed << ".bin";
-        std::string filepath = filename.str();
+
+        auto job = std::make_unique<FileJob>();
+        job->alg = alg;
+        job->filepath = filename.str();
 
         {
             std::lock_guard<std::mutex> lock(coutMutex);
             std::cout << "Generowanie pliku dla algorytmu: " << alg << std::endl;
-            std::cout << "  Plik: " << filepath << std::endl;
+            std::cout << "  Plik: " << job->filepath << std::endl;
         }
 
-        // Otwórz plik do zapisu
-        std::ofstream file(filepath, std::ios::binary);
-        if (!file.is_open()) {
+        // Harmonogram klucza przygotowywany raz na cały plik
+        job->engine = createCipherEngine(alg, key56);
+        if (!job->engine) {
             std::lock_guard<std::mutex> lock(coutMutex);
-            std::cerr << "  Błąd: Nie można otworzyć pliku " << filepath << std::endl;
-            return;
+            std::cerr << "  Błąd: Nieznany algorytm " << alg << std::endl;
+            return nullptr;
         }
 
-        size_t bytesWritten = 0;
-        unsigned int chunkSeed = baseSeed + (alg == "cast" ? 0 : alg == "rc4" ? 10000 :
-                                              alg == "des" ? 20000 : 30000);
-        size_t lastProgressReport = 0;
-
-        // Generuj i zapisuj w chunkach
-        while (bytesWritten < FILE_SIZE_BYTES) {
-            size_t currentChunkSize = std::min(CHUNK_SIZE, FILE_SIZE_BYTES - bytesWritten);
+        unsigned int chunkSeed = baseSeed + cipherSeedOffset(alg);
+        job->source = createPlaintextSource(plaintextMode, chunkSeed);
 
-            // Generuj dane losowe dla chunka
-            std::vector<unsigned char> randomData;
-            generateRandomData(randomData, currentChunkSize, chunkSeed + bytesWritten);
-
-            // Szyfruj danymi algorytmem
-            std::vector<unsigned char> encrypted;
-            if (alg == "cast") {
-                encrypted = encryptCAST(randomData);
-            } else if (alg == "rc4") {
-                encrypted = encryptRC4(randomData);
-            } else if (alg == "des") {
-                encrypted = encryptDES(randomData);
-            } else if (alg == "blowfish") {
-                encrypted = encryptBlowfish(randomData);
-            }
-
-            // Zapisz chunk do pliku
-            if (!writeChunkToFile(file, encrypted)) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                std::cerr << "  Błąd przy zapisie do pliku " << filepath << std::endl;
-                file.close();
-                return;
+        // Otwórz plik do zapisu; metadane pozwalają odtworzyć plik bez logów generatora
+        if (writeFiles) {
+            job->writer = std::make_unique<DatasetWriter>(*sink, DatasetWriter::containerFromEnvironment(),
+                                                          collectStats);
+            DatasetWriter::Metadata metadata = {
+                {"generator", "generate_ciphertexts"},
+                {"algorithm", alg},
+                {"key56", formatKeyHex(key56)},
+                {"seed", std::to_string(baseSeed)},
+                {"plaintext", plaintextMode},
+                {"plaintext_seed", std::to_string(chunkSeed)},
+            };
+            if (!job->writer->open(job->filepath, CHUNK_SIZE, metadata)) {
+                return nullptr;
             }
+        }
+        if (collectStats) {
+            job->workerStats.assign(pool.workerCount(), StreamStats());
+        }
 
-            bytesWritten += encrypted.size();
-
-            // Wyświetl postęp co 500 MB lub na końcu
-            size_t progressInterval = 500 * 1024 * 1024; // 500 MB
-            if (bytesWritten - lastProgressReport >= progressInterval ||
-                bytesWritten >= FILE_SIZE_BYTES) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                double progress = (static_cast<double>(bytesWritten) / FILE_SIZE_BYTES) * 100.0;
-                std::cout << "  [" << alg << "] Postęp: " << std::fixed << std::setprecision(1) << progress
-                          << "% (" << formatBytes(bytesWritten) << " / "
-                          << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
-                lastProgressReport = bytesWritten;
-            }
+        // Każdy chunk to niezależne zadanie (RC4 startuje od klucza w każdym chunku)
+        FileJob* jobPtr = job.get();
+        for (size_t offset = 0; offset < FILE_SIZE_BYTES; offset += CHUNK_SIZE) {
+            pool.submit([this, jobPtr, offset](size_t worker) { encryptChunk(*jobPtr, offset, worker); });
         }
+        return job;
+    }
 
-        file.close();
+    // Czeka na zapisy pliku, zamyka go i raportuje wynik (oraz statystyki strumienia)
+    void finishFile(FileJob& job) {
+        bool closed = !writeFiles || job.writer->finish();
+        size_t bytesWritten = job.bytesWritten;
 
         std::lock_guard<std::mutex> lock(coutMutex);
-        if (bytesWritten == FILE_SIZE_BYTES) {
-            std::cout << "  ✓ [" << alg << "] Zapisano: " << filepath
-                      << " (" << formatBytes(bytesWritten) << ")" << std::endl;
+        if (closed && !job.failed && bytesWritten == FILE_SIZE_BYTES) {
+            if (writeFiles) {
+                std::cout << "  ✓ [" << job.alg << "] Zapisano: " << job.filepath
+                          << " (" << formatBytes(bytesWritten) << ")" << std::endl;
+            } else {
+                std::cout << "  ✓ [" << job.alg << "] Przetworzono " << formatBytes(bytesWritten)
+                          << " bez zapisu na dysk" << std::endl;
+            }
         } else {
-            std::cerr << "  ✗ [" << alg << "] Nie udało się zapisać pełnego pliku" << std::endl;
+            std::cerr << "  ✗ [" << job.alg << "] Nie udało się " << (writeFiles ? "zapisać" : "przetworzyć")
+                      << " pełnego pliku" << std::endl;
+            return;
+        }
+
+        if (collectStats) {
+            for (size_t worker = 1; worker < job.workerStats.size(); worker++) {
+                job.workerStats[0].merge(job.workerStats[worker]);
+            }
+            StreamStatsSummary summary = job.workerStats[0].summarize();
+            summary.print(std::cout, job.alg);
+            summary.saveJson(job.filepath.substr(0, job.filepath.size() - 4) + ".stats.json");
         }
     }
     
-    void generateCiphertexts(const std::string& outputDir = "ciphertexts", unsigned int seed = 12345) {
+    // algorithms - nazwy z cipher_policies.h (selectCipherAlgorithms)
+    void generateCiphertexts(const std::string& outputDir = "ciphertexts", unsigned int seed = 12345,
+                             const std::vector<std::string>& algorithms = defaultCipherAlgorithms()) {
         // Utwórz katalog główny
         createDirectory(outputDir);
 
-        // Algorytmy do przetworzenia
-        std::vector<std::string> algorithms = {"cast", "rc4", "des", "blowfish"};
-
         std::cout << "Generowanie szyfrogramów..." << std::endl;
         std::cout << "Rozmiar każdego pliku: " << formatBytes(FILE_SIZE_BYTES) << std::endl;
+        std::cout << "Wyjście: " << (!collectStats ? "pliki" : writeFiles ? "pliki i statystyki"
+                                                                          : "tylko statystyki (bez plików)")
+                  << std::endl;
+        std::cout << "Źródło tekstu jawnego: " << plaintextMode;
+        if (plaintextMode == "philox") {
+            std::cout << " (" << philoxKernelName() << ")";
+        }
+        std::cout << std::endl;
         std::cout << "Klucz 56-bit: ";
         for (int i = 0; i < 7; i++) {
             std::cout << std::hex << std::setw(2) << std::setfill('0')
@@ -239,29 +233,44 @@ public:
         }
         std::cout << std::dec << std::endl << std::endl;
 
-        // Uruchom każdy algorytm w osobnym wątku
-        std::vector<std::thread> threads;
+        std::cout << "Wątki robocze: " << pool.workerCount() << std::endl;
+        std::cout << "Zapis: " << sink->backendName() << std::endl << std::endl;
+
+        // Chunki wszystkich algorytmów trafiają do jednej puli - wolniejsze szyfry
+        // (DES) dostają rdzenie zwolnione przez szybsze (RC4)
+        std::vector<std::unique_ptr<FileJob>> jobs;
         for (const auto& alg : algorithms) {
-            threads.emplace_back(&CiphertextGenerator::generateCiphertextForAlgorithm,
-                                this, alg, outputDir, seed);
+            jobs.push_back(generateCiphertextForAlgorithm(alg, outputDir, seed));
         }
 
-        // Poczekaj na zakończenie wszystkich wątków
-        for (auto& thread : threads) {
-            thread.join();
+        pool.wait();
+
+        for (auto& job : jobs) {
+            if (job) {
+                finishFile(*job);
+            }
         }
 
         size_t totalWritten = algorithms.size() * FILE_SIZE_BYTES;
         std::cout << std::endl;
         std::cout << "Zakończono generowanie szyfrogramów." << std::endl;
-        std::cout << "Łącznie zapisano: " << formatBytes(totalWritten) << std::endl;
+        std::cout << "Łącznie " << (writeFiles ? "zapisano" : "przetworzono") << ": " << formatBytes(totalWritten)
+                  << std::endl;
         std::cout << "Pliki znajdują się w katalogu: " << outputDir << std::endl;
+        ChunkBufferPool& buffers = ChunkBufferPool::shared();
+        std::cout << "Pamięć buforów chunków: szczyt " << formatBytes(buffers.peakBytes())
+                  << (buffers.limit() > 0 ? ", limit " + formatBytes(buffers.limit()) : std::string(", bez limitu"))
+                  << std::endl;
     }
 };
 
 int main(int argc, char* argv[]) {
     unsigned int seed = 12345;
     std::string outputDir = "ciphertexts";
+    size_t threads = 0; // 0 = wszystkie rdzenie
+    std::string plaintextMode = "mt19937"; // "philox" - szybsze źródło, ale inne zbiory niż dotąd
+    std::string outputMode = "files"; // "stats" - pliki i statystyki, "stats-only" - same statystyki
+    std::vector<std::string> algorithms = defaultCipherAlgorithms(); // "all" albo np. "aes128-ctr,chacha20"
     
     if (argc > 1) {
         seed = std::stoul(argv[1]);
@@ -269,16 +278,37 @@ int main(int argc, char* argv[]) {
     if (argc > 2) {
         outputDir = argv[2];
     }
+    if (argc > 3) {
+        threads = std::stoul(argv[3]);
+    }
+    if (argc > 4) {
+        plaintextMode = argv[4];
+    }
+    if (!createPlaintextSource(plaintextMode, seed)) {
+        std::cerr << "Nieznane źródło tekstu jawnego: " << plaintextMode
+                  << " (dostępne: mt19937, philox)" << std::endl;
+        return 1;
+    }
+    if (argc > 5) {
+        outputMode = argv[5];
+        if (outputMode != "files" && outputMode != "stats" && outputMode != "stats-only") {
+            std::cerr << "Nieznany tryb wyjścia: " << outputMode << " (dostępne: files, stats, stats-only)"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 6 && !selectCipherAlgorithms(argv[6], algorithms)) {
+        return 1;
+    }
     
     std::cout << "=== Generator szyfrogramów (8 GB każdy) ===" << std::endl;
     std::cout << "Ziarno generatora: " << seed << std::endl;
     std::cout << "Katalog wyjściowy: " << outputDir << std::endl;
     std::cout << std::endl;
     
-    CiphertextGenerator generator(seed);
-    generator.generateCiphertexts(outputDir, seed);
+    CiphertextGenerator generator(seed, threads, plaintextMode, outputMode != "stats-only", outputMode != "files");
+    generator.generateCiphertexts(outputDir, seed, algorithms);
     
     return 0;
 }
 
-#pragma GCC diagnostic pop
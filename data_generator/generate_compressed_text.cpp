@@ -1,18 +1,18 @@
+#include "async_output.h"
+#include "dataset_view.h"
+#include "parallel_gzip.h"
 #include "text_generator.h"
+#include "work_stealing_pool.h"
 #include <iostream>
 #include <vector>
-#include <fstream>
 #include <filesystem>
-#include <iomanip>
-#include <cstring>
 #include <functional>
-#include <zlib.h>
-#include <fcntl.h>
-#include <unistd.h>
+#include <iomanip>
+#include <memory>
 
 /**
  * Moduł kompresujący dane tekstowe do pliku o rozmiarze 8 GB.
- * Czyta tekst z pliku lub generuje go, kompresuje strumieniowo (gzip)
+ * Czyta tekst z pliku lub generuje go, kompresuje równolegle (ParallelGzipWriter)
  * i zapisuje do pliku .gz do momentu osiągnięcia ~8 GB skompresowanych danych.
  */
 
@@ -20,7 +20,7 @@ namespace {
 
 const size_t FILE_SIZE_GB = 8;
 const size_t FILE_SIZE_BYTES = FILE_SIZE_GB * 1024ULL * 1024ULL * 1024ULL;
-const size_t CHUNK_INPUT = 4 * 1024 * 1024;   // 4 MB wejścia na iterację
+const size_t CHUNK_INPUT = 4 * 1024 * 1024;   // 4 MB wejścia na blok deflate
 
 std::string formatBytes(size_t bytes) {
     if (bytes < 1024) return std::to_string(bytes) + " B";
@@ -41,130 +41,107 @@ void createDirectory(const std::string& dir) {
 
 class TextCompressor {
 public:
-    TextCompressor() = default;
+    // threads == 0 oznacza wszystkie rdzenie
+    explicit TextCompressor(size_t threads = 0) : pool(threads) {}
 
     /**
      * Kompresuje dane z pliku wejściowego do pliku .gz o rozmiarze do ~8 GB.
      */
     bool compressFileTo8GB(const std::string& inputPath, const std::string& outputPath) {
-        std::ifstream in(inputPath, std::ios::binary);
-        if (!in.is_open()) {
-            std::cerr << "Błąd: Nie można otworzyć pliku wejściowego: " << inputPath << std::endl;
+        DatasetView input;
+        if (!input.open(inputPath)) {
             return false;
         }
         createDirectory(outputPath);
+        // Bloki deflate czytają wprost z mapowania pliku - bez bufora wejściowego i kopiowania
         return compressStreamTo8GB(
-            [&in](unsigned char* buf, size_t maxLen) -> size_t {
-                in.read(reinterpret_cast<char*>(buf), maxLen);
-                return static_cast<size_t>(in.gcount());
+            [&input](ParallelGzipWriter& writer, AsyncOutputSink& sink, int file, uint64_t target,
+                     const ParallelGzipWriter::ProgressFn& progress) {
+                return writer.compress(input.data(), input.size(), sink, file, target, progress);
             },
-            outputPath,
-            "plik: " + inputPath
+            outputPath
         );
     }
 
     /**
      * Generuje tekst, kompresuje go strumieniowo i zapisuje do pliku .gz ~8 GB.
+     * textMode "seekable" - bloki tekstu są chunkami adresowalnymi (TextGenerator) i powstają
+     * równolegle; "sequential" - łańcuch ziaren jak dawniej, generowany w jednym wątku.
      */
-    bool generateAndCompressTo8GB(const std::string& outputPath, unsigned int seed) {
+    bool generateAndCompressTo8GB(const std::string& outputPath, unsigned int seed,
+                                  const std::string& textMode = "sequential") {
         std::cout << "=== Kompresja danych tekstowych do pliku 8 GB ===" << std::endl;
         std::cout << "Ziarno: " << seed << std::endl;
         std::cout << "Wyjście: " << outputPath << std::endl;
+        std::cout << "Tekst: " << textMode << ", wątki: " << pool.workerCount() << std::endl;
         std::cout << "Cel: ~" << FILE_SIZE_GB << " GB skompresowanych danych (gzip)" << std::endl << std::endl;
 
         createDirectory(outputPath);
-        TextGenerator gen(seed);
-        size_t totalGenerated = 0;
+        bool seekable = textMode == "seekable";
+        std::vector<std::unique_ptr<TextGenerator>> gens;
+        for (size_t i = 0; i < (seekable ? pool.workerCount() : 1); i++) {
+            gens.push_back(std::make_unique<TextGenerator>(seed));
+        }
         unsigned int runSeed = seed;
-        bool ok = compressStreamTo8GB(
-            [this, &gen, &totalGenerated, &runSeed](unsigned char* buf, size_t maxLen) -> size_t {
-                gen.generateTextToBuffer(bufferForGenerator, maxLen, runSeed);
-                size_t n = bufferForGenerator.size();
-                if (n > 0) {
-                    memcpy(buf, bufferForGenerator.data(), n);
-                    totalGenerated += n;
-                }
-                return n;
+        ParallelGzipWriter::FillFn fill = [&gens, &runSeed, seekable, seed](
+                                              size_t worker, uint64_t offset, unsigned char* buf, size_t maxLen) {
+            // Tekst generowany prosto do bufora wejściowego kompresji; chunki
+            // adresowalne mają rozmiar bloku, więc każdy blok to jeden pełny chunk
+            if (seekable) {
+                gens[worker]->generateSeekableRange(seed, CHUNK_INPUT, offset, buf, maxLen);
+            } else {
+                gens[0]->generateText(buf, maxLen, runSeed);
+            }
+            return maxLen;
+        };
+        return compressStreamTo8GB(
+            [&fill, seekable](ParallelGzipWriter& writer, AsyncOutputSink& sink, int file, uint64_t target,
+                              const ParallelGzipWriter::ProgressFn& progress) {
+                return writer.compress(fill, seekable, sink, file, target, progress);
             },
-            outputPath,
-            "generator (ziarno " + std::to_string(seed) + ")"
+            outputPath
         );
-        if (ok)
-            std::cout << "Wygenerowano i skompresowano łącznie " << formatBytes(totalGenerated) << " danych wejściowych." << std::endl;
-        return ok;
     }
 
 private:
-    std::vector<unsigned char> bufferForGenerator;
-
-    using ReadChunkFn = std::function<size_t(unsigned char* buf, size_t maxLen)>;
+    WorkStealingPool pool;
 
-    bool compressStreamTo8GB(ReadChunkFn readChunk, const std::string& outputPath, const std::string& sourceDesc) {
-        (void)sourceDesc;
-        int fd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
-        if (fd < 0) {
-            std::cerr << "Błąd: Nie można utworzyć pliku wyjściowego: " << outputPath << std::endl;
-            return false;
-        }
+    // Źródło wejścia wybiera wariant ParallelGzipWriter::compress (FillFn albo dane w pamięci)
+    using CompressFn = std::function<bool(ParallelGzipWriter& writer, AsyncOutputSink& sink, int file,
+                                          uint64_t targetBytes, const ParallelGzipWriter::ProgressFn& progress)>;
 
-        gzFile gz = gzdopen(fd, "wb");
-        if (!gz) {
-            close(fd);
-            std::cerr << "Błąd: gzdopen" << std::endl;
+    bool compressStreamTo8GB(const CompressFn& compress, const std::string& outputPath) {
+        // Skompresowany blok wejścia jest mniejszy od CHUNK_INPUT; większe wyjście sink dzieli na bufory
+        AsyncOutputSink sink(AsyncOutputOptions::fromEnvironment(CHUNK_INPUT, 8));
+        int file = sink.openFile(outputPath);
+        if (file < 0) {
             return false;
         }
 
-        gzsetparams(gz, 6, Z_DEFAULT_STRATEGY);
-
-        std::vector<unsigned char> inBuf(CHUNK_INPUT);
         const size_t progressInterval = 500 * 1024 * 1024; // 500 MB
         size_t lastReport = 0;
-
-        while (true) {
-            off_t currentSize = lseek(fd, 0, SEEK_END);
-            if (currentSize < 0) {
-                std::cerr << "Błąd lseek" << std::endl;
-                gzclose(gz);
-                return false;
-            }
-            if (static_cast<size_t>(currentSize) >= FILE_SIZE_BYTES)
-                break;
-
-            size_t toRead = CHUNK_INPUT;
-            size_t n = readChunk(inBuf.data(), toRead);
-            if (n == 0)
-                break;
-
-            int written = gzwrite(gz, inBuf.data(), static_cast<unsigned>(n));
-            if (written <= 0 || static_cast<size_t>(written) != n) {
-                std::cerr << "Błąd zapisu gzwrite przy " << formatBytes(static_cast<size_t>(currentSize)) << std::endl;
-                gzclose(gz);
-                return false;
-            }
-
-            if (gzflush(gz, Z_SYNC_FLUSH) != Z_OK) {
-                std::cerr << "Błąd gzflush" << std::endl;
-                gzclose(gz);
-                return false;
-            }
-
-            currentSize = lseek(fd, 0, SEEK_END);
-            size_t totalWritten = static_cast<size_t>(currentSize);
-
+        auto progress = [&lastReport, progressInterval](uint64_t totalWritten) {
             if (totalWritten - lastReport >= progressInterval || totalWritten >= FILE_SIZE_BYTES) {
                 double pct = 100.0 * static_cast<double>(totalWritten) / FILE_SIZE_BYTES;
                 std::cout << "  Postęp: " << std::fixed << std::setprecision(1) << pct << "% ("
                           << formatBytes(totalWritten) << " / " << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
                 lastReport = totalWritten;
             }
-        }
+        };
+
+        // Rozmiar wyjścia liczony przez kompresor - bez lseek po każdym bloku
+        ParallelGzipWriter writer(pool, CHUNK_INPUT, 6);
+        bool ok = compress(writer, sink, file, FILE_SIZE_BYTES, progress);
 
-        if (gzclose(gz) != Z_OK) {
-            std::cerr << "Błąd przy zamykaniu pliku gzip." << std::endl;
+        if (!sink.closeFile(file)) {
+            std::cerr << "Błąd przy zapisie pliku gzip." << std::endl;
             return false;
         }
-        size_t finalSize = static_cast<size_t>(std::filesystem::file_size(outputPath));
-        std::cout << "  Zapisano: " << outputPath << " (" << formatBytes(finalSize) << ")" << std::endl;
+        if (!ok) {
+            return false;
+        }
+        std::cout << "  Zapisano: " << outputPath << " (" << formatBytes(writer.outputBytes()) << ")" << std::endl;
+        std::cout << "  Skompresowano łącznie " << formatBytes(writer.inputBytes()) << " danych wejściowych." << std::endl;
         return true;
     }
 };
@@ -174,6 +151,8 @@ int main(int argc, char* argv[]) {
     std::string outputDir = "compressed_text";
     std::string outputFile;
     std::string inputFile;
+    size_t threads = 0;                // 0 = wszystkie rdzenie
+    std::string textMode = "sequential"; // "seekable" - tekst równolegle, ale inny niż dotąd (bez pliku wejściowego)
 
     if (argc > 1) {
         std::string a1 = argv[1];
@@ -190,17 +169,26 @@ int main(int argc, char* argv[]) {
     }
     if (argc > 3)
         outputDir = argv[3];
+    if (argc > 4)
+        threads = std::stoul(argv[4]);
+    if (argc > 5) {
+        textMode = argv[5];
+        if (textMode != "seekable" && textMode != "sequential") {
+            std::cerr << "Nieznany tryb tekstu: " << textMode << " (dostępne: sequential, seekable)" << std::endl;
+            return 1;
+        }
+    }
 
     if (outputFile.empty())
         outputFile = outputDir + "/compressed_" + std::to_string(seed) + ".gz";
 
-    TextCompressor compressor;
+    TextCompressor compressor(threads);
 
     if (!inputFile.empty()) {
         if (!compressor.compressFileTo8GB(inputFile, outputFile))
             return 1;
     } else {
-        if (!compressor.generateAndCompressTo8GB(outputFile, seed))
+        if (!compressor.generateAndCompressTo8GB(outputFile, seed, textMode))
             return 1;
     }
 
@@ -1,4 +1,9 @@
 #include "text_generator.h"
+#include "async_output.h"
+#include "cipher_engine.h"
+#include "dataset_view.h"
+#include "dataset_writer.h"
+#include "work_stealing_pool.h"
 #include <iostream>
 #include <vector>
 #include <random>
@@ -9,112 +14,19 @@
 #include <sstream>
 #include <thread>
 #include <mutex>
-#include <openssl/des.h>
-#include <openssl/blowfish.h>
-#include <openssl/cast.h>
-#include <openssl/rc4.h>
-
-// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <atomic>
+#include <memory>
 
 class TextEncryptor {
 private:
     unsigned char key56[7]; // 56 bits = 7 bytes
     std::mutex coutMutex;
+    WorkStealingPool pool; // wspólna pula dla chunków wszystkich algorytmów
+    std::unique_ptr<AsyncOutputSink> sink; // pierścień buforów chunków i asynchroniczny zapis
     const size_t FILE_SIZE_GB = 8;
     const size_t FILE_SIZE_BYTES = FILE_SIZE_GB * 1024ULL * 1024ULL * 1024ULL;
     const size_t CHUNK_SIZE = 100 * 1024 * 1024; // 100 MB chunków
     
-    void generate56BitKey(unsigned int seed) {
-        std::mt19937 keyGen(seed);
-        std::uniform_int_distribution<unsigned char> dist(0, 255);
-        for (int i = 0; i < 7; i++) {
-            key56[i] = dist(keyGen);
-        }
-    }
-    
-    std::vector<unsigned char> encryptCAST(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        CAST_KEY castKey;
-        
-        CAST_set_key(&castKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += CAST_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(CAST_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[CAST_BLOCK] = {0};
-            unsigned char output[CAST_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            CAST_ecb_encrypt(input, output, &castKey, CAST_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptRC4(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        RC4_KEY rc4Key;
-        
-        RC4_set_key(&rc4Key, 7, key56);
-        RC4(&rc4Key, data.size(), data.data(), encrypted.data());
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptDES(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        DES_key_schedule desKey;
-        
-        unsigned char desKey8[8];
-        memcpy(desKey8, key56, 7);
-        desKey8[7] = 0;
-        
-        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
-        DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(desKey8), &desKey);
-        
-        for (size_t i = 0; i < data.size(); i += 8) {
-            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
-            unsigned char input[8] = {0};
-            unsigned char output[8];
-            
-            memcpy(input, &data[i], blockSize);
-            DES_ecb_encrypt(reinterpret_cast<const_DES_cblock*>(input),
-                          reinterpret_cast<DES_cblock*>(output),
-                          &desKey, DES_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptBlowfish(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        BF_KEY bfKey;
-        
-        BF_set_key(&bfKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += BF_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(BF_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[BF_BLOCK] = {0};
-            unsigned char output[BF_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            BF_ecb_encrypt(input, output, &bfKey, BF_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    bool writeChunkToFile(std::ofstream& file, const std::vector<unsigned char>& data) {
-        file.write(reinterpret_cast<const char*>(data.data()), data.size());
-        return file.good();
-    }
-    
     void createDirectory(const std::string& dir) {
         std::filesystem::create_directories(dir);
     }
@@ -126,12 +38,69 @@ private:
         return std::to_string(bytes / (1024ULL * 1024ULL * 1024ULL)) + " GB";
     }
     
-    void encryptTextFile(const std::string& inputPath, const std::string& outputPath, 
-                       const std::string& algorithm) {
+    // Stan jednego szyfrowania (plik wejściowy -> plik wyjściowy) współdzielony przez zadania-chunki
+    struct FileJob {
+        std::string algorithm;
+        std::string outputPath;
+        std::unique_ptr<CipherEngine> engine;
+        const DatasetView* input = nullptr; // wspólne mapowanie pliku wejściowego
+        std::unique_ptr<DatasetWriter> writer; // kontener (albo surowy plik) przez sink
+        size_t totalBytes = 0;
+        std::atomic<size_t> bytesProcessed{0};
+        std::atomic<bool> failed{false};
+        size_t lastProgressReport = 0; // chronione przez coutMutex
+    };
+
+    void encryptChunk(FileJob& job, size_t offset, size_t /*worker*/) {
+        // Po błędzie zapisu pliku pozostałe chunki nie są już szyfrowane
+        if (job.failed || job.writer->failed()) {
+            job.failed = true;
+            return;
+        }
+        // Tekst czytany wprost z mapowania pliku - bez kopii do bufora
+        DataChunk text = job.input->chunk(offset, std::min(CHUNK_SIZE, job.totalBytes - offset));
+        unsigned char* encrypted = sink->acquire();
+        if (encrypted == nullptr) {
+            job.failed = true;
+            return;
+        }
+
+        // Szyfruj chunk (silnik jest niezmienny - bezpieczny dla wielu wątków);
+        // chunk po błędzie szyfrowania nie może trafić do pliku
+        if (!job.engine->encrypt(text.data, encrypted, text.size)) {
+            sink->release(encrypted);
+            job.failed = true;
+            return;
+        }
+
+        // Zapis pod tym samym przesunięciem (i CRC do indeksu kontenera) idzie w tle; błąd zgłosi finishFile()
+        job.writer->submitChunk(offset / CHUNK_SIZE, encrypted, text.size);
+
+        size_t bytesProcessed = job.bytesProcessed.fetch_add(text.size) + text.size;
+
+        // Wyświetl postęp
+        const size_t progressInterval = 500 * 1024 * 1024; // 500 MB
+        std::lock_guard<std::mutex> lock(coutMutex);
+        if (bytesProcessed - job.lastProgressReport >= progressInterval ||
+            bytesProcessed >= FILE_SIZE_BYTES) {
+            double progress = (static_cast<double>(bytesProcessed) / FILE_SIZE_BYTES) * 100.0;
+            std::cout << "  [" << job.algorithm << "] Postęp: " << std::fixed << std::setprecision(1) << progress
+                      << "% (" << formatBytes(bytesProcessed) << " / "
+                      << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
+            job.lastProgressReport = bytesProcessed;
+        }
+    }
+
+    /**
+     * Otwiera pliki i zleca puli po jednym zadaniu na chunk (co najwyżej FILE_SIZE_BYTES wejścia).
+     * Zwraca stan szyfrowania (nullptr przy błędzie); zadania kończy dopiero pool.wait().
+     */
+    std::unique_ptr<FileJob> encryptTextFile(const DatasetView& input, const std::string& outputPath,
+                                             const std::string& algorithm, unsigned int seed) {
         {
             std::lock_guard<std::mutex> lock(coutMutex);
             std::cout << "Szyfrowanie pliku algorytmem: " << algorithm << std::endl;
-            std::cout << "  Wejście: " << inputPath << std::endl;
+            std::cout << "  Wejście: " << input.path() << std::endl;
             std::cout << "  Wyjście: " << outputPath << std::endl;
         }
         
@@ -140,93 +109,91 @@ private:
         if (path.has_parent_path()) {
             createDirectory(path.parent_path().string());
         }
-        
-        std::ifstream inputFile(inputPath, std::ios::binary);
-        if (!inputFile.is_open()) {
+
+        auto job = std::make_unique<FileJob>();
+        job->algorithm = algorithm;
+        job->outputPath = outputPath;
+
+        // Harmonogram klucza przygotowywany raz na cały plik
+        job->engine = createCipherEngine(algorithm, key56);
+        if (!job->engine) {
             std::lock_guard<std::mutex> lock(coutMutex);
-            std::cerr << "  Błąd: Nie można otworzyć pliku wejściowego " << inputPath << std::endl;
-            return;
+            std::cerr << "  Błąd: Nieznany algorytm " << algorithm << std::endl;
+            return nullptr;
         }
         
-        std::ofstream outputFile(outputPath, std::ios::binary);
-        if (!outputFile.is_open()) {
-            std::lock_guard<std::mutex> lock(coutMutex);
-            std::cerr << "  Błąd: Nie można otworzyć pliku wyjściowego " << outputPath << std::endl;
-            inputFile.close();
-            return;
+        job->input = &input;
+        job->writer = std::make_unique<DatasetWriter>(*sink, DatasetWriter::containerFromEnvironment());
+        DatasetWriter::Metadata metadata = {
+            {"generator", "generate_encrypted_text"},
+            {"algorithm", algorithm},
+            {"key56", formatKeyHex(key56)},
+            {"seed", std::to_string(seed)},
+            {"plaintext", "file"},
+            {"plaintext_file", input.path()},
+        };
+        if (!job->writer->open(outputPath, CHUNK_SIZE, metadata)) {
+            return nullptr;
         }
-        
-        size_t bytesProcessed = 0;
-        size_t lastProgressReport = 0;
-        const size_t progressInterval = 500 * 1024 * 1024; // 500 MB
-        
-        while (inputFile.good() && bytesProcessed < FILE_SIZE_BYTES) {
-            size_t remaining = FILE_SIZE_BYTES - bytesProcessed;
-            size_t currentChunkSize = std::min(CHUNK_SIZE, remaining);
-            
-            // Przeczytaj chunk z pliku tekstowego
-            std::vector<unsigned char> textChunk(currentChunkSize);
-            inputFile.read(reinterpret_cast<char*>(textChunk.data()), currentChunkSize);
-            size_t bytesRead = inputFile.gcount();
-            
-            if (bytesRead == 0) break;
-            
-            // Dostosuj rozmiar jeśli przeczytano mniej
-            if (bytesRead < currentChunkSize) {
-                textChunk.resize(bytesRead);
-            }
-            
-            // Szyfruj chunk
-            std::vector<unsigned char> encrypted;
-            if (algorithm == "cast") {
-                encrypted = encryptCAST(textChunk);
-            } else if (algorithm == "rc4") {
-                encrypted = encryptRC4(textChunk);
-            } else if (algorithm == "des") {
-                encrypted = encryptDES(textChunk);
-            } else if (algorithm == "blowfish") {
-                encrypted = encryptBlowfish(textChunk);
-            }
-            
-            // Zapisz zaszyfrowany chunk
-            if (!writeChunkToFile(outputFile, encrypted)) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                std::cerr << "  Błąd przy zapisie do pliku " << outputPath << std::endl;
-                break;
-            }
-            
-            bytesProcessed += bytesRead;
-            
-            // Wyświetl postęp
-            if (bytesProcessed - lastProgressReport >= progressInterval ||
-                bytesProcessed >= FILE_SIZE_BYTES) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                double progress = (static_cast<double>(bytesProcessed) / FILE_SIZE_BYTES) * 100.0;
-                std::cout << "  [" << algorithm << "] Postęp: " << std::fixed << std::setprecision(1) << progress
-                          << "% (" << formatBytes(bytesProcessed) << " / "
-                          << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
-                lastProgressReport = bytesProcessed;
-            }
+
+        // Granice chunków takie same jak przy czytaniu sekwencyjnym: co CHUNK_SIZE od początku
+        job->totalBytes = static_cast<size_t>(std::min<uint64_t>(input.size(), FILE_SIZE_BYTES));
+        FileJob* jobPtr = job.get();
+        for (size_t offset = 0; offset < job->totalBytes; offset += CHUNK_SIZE) {
+            pool.submit([this, jobPtr, offset](size_t worker) { encryptChunk(*jobPtr, offset, worker); });
         }
-        
-        inputFile.close();
-        outputFile.close();
-        
+        return job;
+    }
+
+    // Czeka na zapisy, zamyka plik po zakończeniu zadań i raportuje wynik
+    void finishFile(FileJob& job) {
+        bool closed = job.writer->finish();
+        size_t bytesProcessed = job.bytesProcessed;
+
         std::lock_guard<std::mutex> lock(coutMutex);
-        if (bytesProcessed > 0) {
-            std::cout << "  ✓ [" << algorithm << "] Zapisano: " << outputPath
+        if (closed && !job.failed && bytesProcessed > 0) {
+            std::cout << "  ✓ [" << job.algorithm << "] Zapisano: " << job.outputPath
                       << " (" << formatBytes(bytesProcessed) << ")" << std::endl;
         } else {
-            std::cerr << "  ✗ [" << algorithm << "] Nie udało się zaszyfrować pliku" << std::endl;
+            std::cerr << "  ✗ [" << job.algorithm << "] Nie udało się zaszyfrować pliku" << std::endl;
+        }
+    }
+
+    // Szyfruje plik wszystkimi algorytmami naraz - chunki wszystkich algorytmów dzielą jedną pulę
+    void encryptWithAllAlgorithms(const std::string& inputPath, const std::string& outputDir,
+                                  const std::vector<std::string>& algorithms, unsigned int seed) {
+        // Plik wejściowy mapowany raz - wszystkie algorytmy czytają te same strony
+        DatasetView input;
+        if (!input.open(inputPath)) {
+            return;
+        }
+
+        std::vector<std::unique_ptr<FileJob>> jobs;
+        for (const auto& alg : algorithms) {
+            std::string outputPath = outputDir + "/" + alg + "/encrypted_" + alg + "_" + std::to_string(seed) + ".bin";
+            jobs.push_back(encryptTextFile(input, outputPath, alg, seed));
+        }
+
+        pool.wait();
+
+        for (auto& job : jobs) {
+            if (job) {
+                finishFile(*job);
+            }
         }
     }
 
 public:
-    TextEncryptor(unsigned int seed) {
-        generate56BitKey(seed);
+    // threads == 0 oznacza wszystkie rdzenie
+    TextEncryptor(unsigned int seed, size_t threads = 0) : pool(threads) {
+        // Bufor na wątek roboczy plus dwa w zapisie - szyfrowanie nie czeka na dysk
+        sink = std::make_unique<AsyncOutputSink>(
+            AsyncOutputOptions::fromEnvironment(CHUNK_SIZE, pool.workerCount() + 2));
+        generate56BitKey(seed, key56);
     }
     
-    void encryptExistingFile(const std::string& inputPath, const std::string& outputDir = "encrypted_text", unsigned int seed = 12345) {
+    void encryptExistingFile(const std::string& inputPath, const std::string& outputDir = "encrypted_text", unsigned int seed = 12345,
+                             const std::vector<std::string>& algorithms = defaultCipherAlgorithms()) {
         // Utwórz katalog główny
         createDirectory(outputDir);
         
@@ -244,9 +211,6 @@ public:
             std::cout << std::dec << std::endl << std::endl;
         }
         
-        // Algorytmy do przetworzenia
-        std::vector<std::string> algorithms = {"cast", "rc4", "des", "blowfish"};
-        
         // Utwórz katalogi dla każdego algorytmu
         for (const auto& alg : algorithms) {
             std::string algDir = outputDir + "/" + alg;
@@ -259,18 +223,8 @@ public:
             std::cout << std::endl;
         }
         
-        // Szyfruj każdy algorytm w osobnym wątku
-        std::vector<std::thread> threads;
-        for (const auto& alg : algorithms) {
-            std::string outputPath = outputDir + "/" + alg + "/encrypted_" + alg + "_" + std::to_string(seed) + ".bin";
-            threads.emplace_back(&TextEncryptor::encryptTextFile,
-                                this, inputPath, outputPath, alg);
-        }
-        
-        // Poczekaj na zakończenie wszystkich wątków
-        for (auto& thread : threads) {
-            thread.join();
-        }
+        // Szyfruj wszystkimi algorytmami równolegle (chunki rozdzielane między wszystkie rdzenie)
+        encryptWithAllAlgorithms(inputPath, outputDir, algorithms, seed);
         
         {
             std::lock_guard<std::mutex> lock(coutMutex);
@@ -281,7 +235,8 @@ public:
         }
     }
     
-    void generateAndEncrypt(const std::string& outputDir = "encrypted_text", unsigned int seed = 12345) {
+    void generateAndEncrypt(const std::string& outputDir = "encrypted_text", unsigned int seed = 12345,
+                            const std::vector<std::string>& algorithms = defaultCipherAlgorithms()) {
         // Utwórz katalog główny
         createDirectory(outputDir);
         
@@ -312,27 +267,14 @@ public:
             std::cout << std::endl;
         }
         
-        // Algorytmy do przetworzenia
-        std::vector<std::string> algorithms = {"cast", "rc4", "des", "blowfish"};
-        
         // Utwórz katalogi dla każdego algorytmu
         for (const auto& alg : algorithms) {
             std::string algDir = outputDir + "/" + alg;
             createDirectory(algDir);
         }
         
-        // Szyfruj każdy algorytm w osobnym wątku
-        std::vector<std::thread> threads;
-        for (const auto& alg : algorithms) {
-            std::string outputPath = outputDir + "/" + alg + "/encrypted_" + alg + "_" + std::to_string(seed) + ".bin";
-            threads.emplace_back(&TextEncryptor::encryptTextFile,
-                                this, textFilePath, outputPath, alg);
-        }
-        
-        // Poczekaj na zakończenie wszystkich wątków
-        for (auto& thread : threads) {
-            thread.join();
-        }
+        // Szyfruj wszystkimi algorytmami równolegle (chunki rozdzielane między wszystkie rdzenie)
+        encryptWithAllAlgorithms(textFilePath, outputDir, algorithms, seed);
         
         {
             std::lock_guard<std::mutex> lock(coutMutex);
@@ -348,6 +290,7 @@ int main(int argc, char* argv[]) {
     unsigned int seed = 12345;
     std::string outputDir = "encrypted_text";
     std::string inputFile = "";
+    std::vector<std::string> algorithms = defaultCipherAlgorithms(); // "all" albo np. "aes128-ctr,chacha20"
     
     if (argc > 1) {
         // Jeśli pierwszy argument to plik (zawiera .txt lub .bin), użyj go jako wejścia
@@ -365,21 +308,24 @@ int main(int argc, char* argv[]) {
             seed = std::stoul(argv[2]);
         }
     }
-    if (argc > 3) {
+    if (argc > 3 && !inputFile.empty()) {
         outputDir = argv[3];
     }
+    // Lista algorytmów jest ostatnim argumentem - po katalogu, więc tryb z plikiem przesuwa ją o jeden
+    const int algorithmsArg = inputFile.empty() ? 3 : 4;
+    if (argc > algorithmsArg && !selectCipherAlgorithms(argv[algorithmsArg], algorithms)) {
+        return 1;
+    }
     
     TextEncryptor encryptor(seed);
     
     if (!inputFile.empty()) {
         // Szyfruj istniejący plik
-        encryptor.encryptExistingFile(inputFile, outputDir, seed);
+        encryptor.encryptExistingFile(inputFile, outputDir, seed, algorithms);
     } else {
         // Generuj i szyfruj
-        encryptor.generateAndEncrypt(outputDir, seed);
+        encryptor.generateAndEncrypt(outputDir, seed, algorithms);
     }
     
     return 0;
 }
-
-#pragma GCC diagnostic pop
@@ -1,22 +1,23 @@
 #include "text_generator.h"
+#include "async_output.h"
+#include "chunk_buffer_pool.h"
+#include "cipher_engine.h"
+#include "dataset_writer.h"
+#include "fan_out_pipeline.h"
+#include "stream_stats.h"
 #include <iostream>
 #include <vector>
 #include <random>
 #include <iomanip>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <filesystem>
 #include <sstream>
 #include <thread>
 #include <mutex>
-#include <openssl/des.h>
-#include <openssl/blowfish.h>
-#include <openssl/cast.h>
-#include <openssl/rc4.h>
-
-// Wyciszenie ostrzeżeń o przestarzałych funkcjach OpenSSL
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <memory>
+#include <algorithm>
+#include <atomic>
 
 class FakeTextCiphertextGenerator {
 private:
@@ -26,94 +27,26 @@ private:
     const size_t FILE_SIZE_BYTES = FILE_SIZE_GB * 1024ULL * 1024ULL * 1024ULL;
     const size_t CHUNK_SIZE = 100 * 1024 * 1024; // 100 MB chunków
     
-    void generate56BitKey(unsigned int seed) {
-        std::mt19937 keyGen(seed);
-        std::uniform_int_distribution<unsigned char> dist(0, 255);
-        for (int i = 0; i < 7; i++) {
-            key56[i] = dist(keyGen);
-        }
-    }
-    
-    std::vector<unsigned char> encryptCAST(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        CAST_KEY castKey;
-        
-        CAST_set_key(&castKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += CAST_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(CAST_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[CAST_BLOCK] = {0};
-            unsigned char output[CAST_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            CAST_ecb_encrypt(input, output, &castKey, CAST_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptRC4(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        RC4_KEY rc4Key;
-        
-        RC4_set_key(&rc4Key, 7, key56);
-        RC4(&rc4Key, data.size(), data.data(), encrypted.data());
-        
-        return encrypted;
-    }
-    
-    std::vector<unsigned char> encryptDES(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        DES_key_schedule desKey;
-        
-        unsigned char desKey8[8];
-        memcpy(desKey8, key56, 7);
-        desKey8[7] = 0;
-        
-        DES_set_odd_parity(reinterpret_cast<DES_cblock*>(desKey8));
-        DES_set_key_unchecked(reinterpret_cast<const_DES_cblock*>(desKey8), &desKey);
-        
-        for (size_t i = 0; i < data.size(); i += 8) {
-            size_t blockSize = std::min(static_cast<size_t>(8), data.size() - i);
-            unsigned char input[8] = {0};
-            unsigned char output[8];
-            
-            memcpy(input, &data[i], blockSize);
-            DES_ecb_encrypt(reinterpret_cast<const_DES_cblock*>(input),
-                          reinterpret_cast<DES_cblock*>(output),
-                          &desKey, DES_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
+    size_t maxInFlight;   // chunki tekstu jednocześnie w pamięci (łącznie we wszystkich potokach)
+    // "seekable" - wspólny tekst z chunków adresowalnych (wielu producentów),
+    // "shared" - wspólny tekst z łańcuchem ziaren, "per-algorithm" - osobny tekst na algorytm
+    std::string plaintextMode;
+    size_t producers; // wątki generujące tekst w trybie seekable
+    bool writeFiles;   // false = tylko statystyki, bez zapisu 8 GB na dysk
+    bool collectStats; // statystyki strumienia liczone w locie przez konsumentów
+    std::unique_ptr<AsyncOutputSink> sink; // bufory szyfrogramu i asynchroniczny zapis wszystkich plików
     
-    std::vector<unsigned char> encryptBlowfish(const std::vector<unsigned char>& data) {
-        std::vector<unsigned char> encrypted(data.size());
-        BF_KEY bfKey;
-        
-        BF_set_key(&bfKey, 7, key56);
-        
-        for (size_t i = 0; i < data.size(); i += BF_BLOCK) {
-            size_t blockSize = std::min(static_cast<size_t>(BF_BLOCK), 
-                                       data.size() - i);
-            unsigned char input[BF_BLOCK] = {0};
-            unsigned char output[BF_BLOCK];
-            
-            memcpy(input, &data[i], blockSize);
-            BF_ecb_encrypt(input, output, &bfKey, BF_ENCRYPT);
-            memcpy(&encrypted[i], output, blockSize);
-        }
-        
-        return encrypted;
-    }
-    
-    bool writeChunkToFile(std::ofstream& file, const std::vector<unsigned char>& data) {
-        file.write(reinterpret_cast<const char*>(data.data()), data.size());
-        return file.good();
-    }
+    // Jeden plik wyjściowy - konsument potoku
+    struct OutputFile {
+        std::string alg;
+        std::string filepath;
+        std::unique_ptr<CipherEngine> engine;
+        std::unique_ptr<DatasetWriter> writer; // kontener (albo surowy plik) przez sink
+        StreamStats stats; // chunki przychodzą po kolei, jeden akumulator na plik wystarcza
+        size_t bytesWritten = 0;
+        bool failed = false; // błąd szyfrowania - dalsze chunki pliku są pomijane
+        size_t lastProgressReport = 0;
+    };
     
     void createDirectory(const std::string& dir) {
         std::filesystem::create_directories(dir);
@@ -126,110 +59,223 @@ private:
         return std::to_string(bytes / (1024ULL * 1024ULL * 1024ULL)) + " GB";
     }
     
-    // Generuje tekst angielski w chunkach
-    void generateTextChunk(std::vector<unsigned char>& textData, size_t targetSize, unsigned int& seed) {
-        // Użyj TextGenerator do generowania tekstu
-        TextGenerator textGen(seed);
-        textGen.generateTextToBuffer(textData, targetSize, seed);
+    static unsigned int algorithmSeed(const std::string& alg, unsigned int baseSeed) {
+        return baseSeed + cipherSeedOffset(alg);
     }
-
-public:
-    FakeTextCiphertextGenerator(unsigned int baseSeed) {
-        generate56BitKey(baseSeed);
-    }
-
-    void generateCiphertextForAlgorithm(const std::string& alg, const std::string& outputDir, unsigned int baseSeed) {
+    
+    bool openOutput(OutputFile& output, const std::string& alg, const std::string& outputDir, unsigned int baseSeed,
+                    unsigned int textSeed) {
         std::string algDir = outputDir + "/" + alg;
         createDirectory(algDir);
 
         std::ostringstream filename;
         filename << algDir << "/" << alg << "_from_text_" << baseSeed << ".bin";
-        std::string filepath = filename.str();
+        output.alg = alg;
+        output.filepath = filename.str();
 
         {
             std::lock_guard<std::mutex> lock(coutMutex);
             std::cout << "Generowanie szyfrogramu dla algorytmu: " << alg << std::endl;
-            std::cout << "  Plik: " << filepath << std::endl;
+            std::cout << "  Plik: " << output.filepath << std::endl;
         }
 
         // Otwórz plik do zapisu
-        std::ofstream file(filepath, std::ios::binary);
-        if (!file.is_open()) {
+        if (writeFiles) {
+            output.writer = std::make_unique<DatasetWriter>(*sink, DatasetWriter::containerFromEnvironment(),
+                                                            collectStats);
+            const char* model = std::getenv("MARKOV_MODEL");
+            DatasetWriter::Metadata metadata = {
+                {"generator", "generate_fake_text_ciphertexts"},
+                {"algorithm", alg},
+                {"key56", formatKeyHex(key56)},
+                {"seed", std::to_string(baseSeed)},
+                {"plaintext", plaintextMode},
+                {"text_seed", std::to_string(textSeed)},
+                {"text_model", model != nullptr && *model != '\0' ? model : "builtin"},
+            };
+            if (!output.writer->open(output.filepath, CHUNK_SIZE, metadata)) {
+                return false;
+            }
+        }
+
+        // Harmonogram klucza przygotowywany raz na cały plik
+        output.engine = createCipherEngine(alg, key56);
+        if (!output.engine) {
             std::lock_guard<std::mutex> lock(coutMutex);
-            std::cerr << "  Błąd: Nie można otworzyć pliku " << filepath << std::endl;
-            return;
+            std::cerr << "  Błąd: Nieznany algorytm " << alg << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    bool encryptAndWrite(OutputFile& output, size_t index, const unsigned char* text, size_t size) {
+        // Po błędzie zapisu albo szyfrowania ten plik jest pomijany (finishOutput() zgłosi niepełny),
+        // pozostałe idą dalej
+        if (output.failed || (writeFiles && output.writer->failed())) {
+            return true;
+        }
+        // Szyfruj tekst algorytmem do bufora sinka - chunk tekstu jest współdzielony;
+        // bez żadnego bufora nie powstanie już żaden plik, więc potok jest przerywany
+        unsigned char* encrypted = sink->acquire();
+        if (encrypted == nullptr) {
+            return false;
+        }
+        if (!output.engine->encrypt(text, encrypted, size)) {
+            sink->release(encrypted);
+            output.failed = true;
+            return true;
         }
 
-        size_t bytesWritten = 0;
-        unsigned int chunkSeed = baseSeed + (alg == "cast" ? 0 : alg == "rc4" ? 10000 :
-                                              alg == "des" ? 20000 : 30000);
-        size_t lastProgressReport = 0;
+        if (collectStats) {
+            output.stats.add(encrypted, size, index * CHUNK_SIZE);
+        }
+
+        // Zapis chunka pod jego przesunięciem idzie w tle, a konsument bierze już kolejny chunk;
+        // błąd zapisu zgłosi finishOutput()
+        if (writeFiles) {
+            output.writer->submitChunk(index, encrypted, size);
+        } else {
+            sink->release(encrypted);
+        }
 
-        // Generuj tekst i szyfruj w chunkach
-        while (bytesWritten < FILE_SIZE_BYTES) {
-            size_t currentChunkSize = std::min(CHUNK_SIZE, FILE_SIZE_BYTES - bytesWritten);
+        output.bytesWritten += size;
 
-            // Generuj tekst angielski dla chunka
-            std::vector<unsigned char> textChunk;
-            unsigned int localSeed = chunkSeed + (bytesWritten / CHUNK_SIZE);
-            generateTextChunk(textChunk, currentChunkSize, localSeed);
-            chunkSeed = localSeed; // Zaktualizuj seed dla następnego chunka
+        // Wyświetl postęp co 500 MB lub na końcu
+        size_t progressInterval = 500 * 1024 * 1024; // 500 MB
+        if (output.bytesWritten - output.lastProgressReport >= progressInterval ||
+            output.bytesWritten >= FILE_SIZE_BYTES) {
+            std::lock_guard<std::mutex> lock(coutMutex);
+            double progress = (static_cast<double>(output.bytesWritten) / FILE_SIZE_BYTES) * 100.0;
+            std::cout << "  [" << output.alg << "] Postęp: " << std::fixed << std::setprecision(1) << progress
+                      << "% (" << formatBytes(output.bytesWritten) << " / "
+                      << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
+            output.lastProgressReport = output.bytesWritten;
+        }
+        return true;
+    }
+    
+    void finishOutput(OutputFile& output) {
+        bool closed = !writeFiles || output.writer->finish();
 
-            // Szyfruj tekst algorytmem
-            std::vector<unsigned char> encrypted;
-            if (alg == "cast") {
-                encrypted = encryptCAST(textChunk);
-            } else if (alg == "rc4") {
-                encrypted = encryptRC4(textChunk);
-            } else if (alg == "des") {
-                encrypted = encryptDES(textChunk);
-            } else if (alg == "blowfish") {
-                encrypted = encryptBlowfish(textChunk);
-            }
+        std::lock_guard<std::mutex> lock(coutMutex);
+        if (!closed || output.failed || output.bytesWritten != FILE_SIZE_BYTES) {
+            std::cerr << "  ✗ [" << output.alg << "] Nie udało się " << (writeFiles ? "zapisać" : "przetworzyć")
+                      << " pełnego pliku" << std::endl;
+            return;
+        }
+        if (writeFiles) {
+            std::cout << "  ✓ [" << output.alg << "] Zapisano: " << output.filepath
+                      << " (" << formatBytes(output.bytesWritten) << ")" << std::endl;
+        } else {
+            std::cout << "  ✓ [" << output.alg << "] Przetworzono " << formatBytes(output.bytesWritten)
+                      << " bez zapisu na dysk" << std::endl;
+        }
+        if (collectStats) {
+            StreamStatsSummary summary = output.stats.summarize();
+            summary.print(std::cout, output.alg);
+            summary.saveJson(output.filepath.substr(0, output.filepath.size() - 4) + ".stats.json");
+        }
+    }
+
+public:
+    // maxInFlight - liczba chunków tekstu w pamięci naraz; plaintextMode "per-algorithm" odtwarza
+    // dawne zbiory, w których każdy algorytm szyfruje własny tekst (ziarno + przesunięcie algorytmu)
+    FakeTextCiphertextGenerator(unsigned int baseSeed, size_t maxInFlight = 4,
+                                const std::string& plaintextMode = "per-algorithm", bool writeFiles = true,
+                                bool collectStats = false)
+        : maxInFlight(std::max<size_t>(1, maxInFlight)), plaintextMode(plaintextMode),
+          producers(std::max(1u, std::thread::hardware_concurrency())), writeFiles(writeFiles),
+          collectStats(collectStats) {
+        generate56BitKey(baseSeed, key56);
+    }
 
-            // Zapisz chunk do pliku
-            if (!writeChunkToFile(file, encrypted)) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                std::cerr << "  Błąd przy zapisie do pliku " << filepath << std::endl;
-                file.close();
+    /**
+     * Tekst generowany raz, chunk po chunku, i szyfrowany przez wszystkie podane algorytmy
+     * (po jednym wątku-konsumencie na algorytm). Przy seekable = false ziarna chunków tworzą
+     * łańcuch jak dotąd: chunk k startuje od (ziarno po chunku k-1) + k, więc producent jest
+     * jeden. Przy seekable = true chunk k zależy tylko od (textSeed, k) i tekst generuje
+     * `producers` wątków naraz. `slots` - chunki tekstu tego potoku w pamięci.
+     */
+    void generateCiphertextsFromText(const std::vector<std::string>& algorithms, const std::string& outputDir,
+                                     unsigned int baseSeed, unsigned int textSeed, bool seekable, size_t slots) {
+        std::vector<OutputFile> outputs(algorithms.size());
+        for (size_t i = 0; i < algorithms.size(); i++) {
+            if (!openOutput(outputs[i], algorithms[i], outputDir, baseSeed, textSeed)) {
                 return;
             }
+        }
 
-            bytesWritten += encrypted.size();
+        const size_t producerCount = seekable ? producers : 1;
+        std::vector<std::unique_ptr<TextGenerator>> textGens;
+        for (size_t i = 0; i < producerCount; i++) {
+            textGens.push_back(std::make_unique<TextGenerator>(textSeed));
+        }
+        unsigned int chunkSeed = textSeed;
+        const size_t chunkCount = (FILE_SIZE_BYTES + CHUNK_SIZE - 1) / CHUNK_SIZE;
 
-            // Wyświetl postęp co 500 MB lub na końcu
-            size_t progressInterval = 500 * 1024 * 1024; // 500 MB
-            if (bytesWritten - lastProgressReport >= progressInterval ||
-                bytesWritten >= FILE_SIZE_BYTES) {
-                std::lock_guard<std::mutex> lock(coutMutex);
-                double progress = (static_cast<double>(bytesWritten) / FILE_SIZE_BYTES) * 100.0;
-                std::cout << "  [" << alg << "] Postęp: " << std::fixed << std::setprecision(1) << progress
-                          << "% (" << formatBytes(bytesWritten) << " / "
-                          << formatBytes(FILE_SIZE_BYTES) << ")" << std::endl;
-                lastProgressReport = bytesWritten;
+        FanOutPipeline::ProduceFn produce = [&](size_t producer, size_t index, unsigned char* buffer,
+                                                size_t) -> size_t {
+            // Generuj tekst angielski dla chunka
+            size_t offset = index * CHUNK_SIZE;
+            size_t currentChunkSize = std::min(CHUNK_SIZE, FILE_SIZE_BYTES - offset);
+            TextGenerator& textGen = *textGens[producer];
+            if (seekable) {
+                textGen.generateSeekableRange(textSeed, CHUNK_SIZE, offset, buffer, currentChunkSize);
+            } else {
+                unsigned int localSeed = chunkSeed + static_cast<unsigned int>(index);
+                textGen.generateText(buffer, currentChunkSize, localSeed);
+                chunkSeed = localSeed; // Zaktualizuj seed dla następnego chunka
             }
+            return currentChunkSize;
+        };
+
+        std::vector<FanOutPipeline::ConsumeFn> consumers;
+        for (auto& output : outputs) {
+            consumers.push_back([this, &output](size_t index, const unsigned char* text, size_t size) {
+                return encryptAndWrite(output, index, text, size);
+            });
         }
 
-        file.close();
+        FanOutPipeline pipeline(CHUNK_SIZE, slots);
+        pipeline.run(chunkCount, producerCount, produce, consumers);
 
-        std::lock_guard<std::mutex> lock(coutMutex);
-        if (bytesWritten == FILE_SIZE_BYTES) {
-            std::cout << "  ✓ [" << alg << "] Zapisano: " << filepath
-                      << " (" << formatBytes(bytesWritten) << ")" << std::endl;
-        } else {
-            std::cerr << "  ✗ [" << alg << "] Nie udało się zapisać pełnego pliku" << std::endl;
+        for (auto& output : outputs) {
+            finishOutput(output);
         }
     }
     
-    void generateCiphertexts(const std::string& outputDir = "fake_text_ciphertexts", unsigned int seed = 12345) {
+    // selected - nazwy z cipher_policies.h (selectCipherAlgorithms)
+    void generateCiphertexts(const std::string& outputDir = "fake_text_ciphertexts", unsigned int seed = 12345,
+                             const std::vector<std::string>& selected = defaultCipherAlgorithms()) {
         // Utwórz katalog główny
         createDirectory(outputDir);
 
-        // Algorytmy do przetworzenia
-        std::vector<std::string> algorithms = {"blowfish", "cast", "des", "rc4"};
+        // Algorytmy do przetworzenia, alfabetycznie
+        std::vector<std::string> algorithms = selected;
+        std::sort(algorithms.begin(), algorithms.end());
+
+        // Tryb per-algorithm: potoków naraz najwyżej maxInFlight, a chunki tekstu dzielą się między
+        // nie po równo - każdy potok ma jednego konsumenta, więc więcej slotów niczego nie przyspiesza.
+        // Szyfrogram: jak dawniej jeden bufor na działający potok. Tryb wspólny: jeden potok
+        // z maxInFlight slotami, bufor na każdy plik wyjściowy (konsumenta) plus dwa w zapisie
+        const bool perAlgorithm = plaintextMode == "per-algorithm";
+        const size_t workers = perAlgorithm ? std::min(algorithms.size(), maxInFlight) : 1;
+        const size_t slotsPerPipeline = perAlgorithm ? maxInFlight / std::max<size_t>(1, workers) : maxInFlight;
+        const size_t sinkBuffers = perAlgorithm ? workers : algorithms.size() + 2;
+        sink = std::make_unique<AsyncOutputSink>(AsyncOutputOptions::fromEnvironment(CHUNK_SIZE, sinkBuffers));
 
         std::cout << "Generowanie szyfrogramów z tekstu angielskiego..." << std::endl;
         std::cout << "Rozmiar każdego pliku: " << formatBytes(FILE_SIZE_BYTES) << std::endl;
+        std::cout << "Tekst jawny: " << (perAlgorithm ? "osobny dla każdego algorytmu"
+                                                      : "wspólny dla wszystkich algorytmów")
+                  << " (" << plaintextMode << ")" << std::endl;
+        std::cout << "Chunków w pamięci: " << workers * slotsPerPipeline << " tekstu"
+                  << (perAlgorithm ? " (" + std::to_string(workers) + " algorytmów naraz)" : std::string())
+                  << " + " << sinkBuffers << " szyfrogramu, po " << formatBytes(CHUNK_SIZE) << std::endl;
+        std::cout << "Wyjście: " << (!collectStats ? "pliki" : writeFiles ? "pliki i statystyki"
+                                                                          : "tylko statystyki (bez plików)")
+                  << std::endl;
+        std::cout << "Zapis: " << sink->backendName() << std::endl;
         std::cout << "Klucz 56-bit: ";
         for (int i = 0; i < 7; i++) {
             std::cout << std::hex << std::setw(2) << std::setfill('0')
@@ -237,29 +283,51 @@ public:
         }
         std::cout << std::dec << std::endl << std::endl;
 
-        // Uruchom każdy algorytm w osobnym wątku
-        std::vector<std::thread> threads;
-        for (const auto& alg : algorithms) {
-            threads.emplace_back(&FakeTextCiphertextGenerator::generateCiphertextForAlgorithm,
-                                this, alg, outputDir, seed);
-        }
+        if (!perAlgorithm) {
+            // Jeden potok: tekst generowany raz, szyfrowany wszystkimi algorytmami naraz
+            generateCiphertextsFromText(algorithms, outputDir, seed, seed, plaintextMode == "seekable",
+                                        slotsPerPipeline);
+        } else {
+            // Osobny potok (i osobny tekst) dla każdego algorytmu; `workers` wątków bierze kolejne algorytmy
+            std::atomic<size_t> nextAlgorithm{0};
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < workers; i++) {
+                threads.emplace_back([this, &algorithms, &nextAlgorithm, &outputDir, seed, slotsPerPipeline]() {
+                    for (size_t a = nextAlgorithm++; a < algorithms.size(); a = nextAlgorithm++) {
+                        generateCiphertextsFromText({algorithms[a]}, outputDir, seed,
+                                                    algorithmSeed(algorithms[a], seed), false, slotsPerPipeline);
+                    }
+                });
+            }
 
-        // Poczekaj na zakończenie wszystkich wątków
-        for (auto& thread : threads) {
-            thread.join();
+            // Poczekaj na zakończenie wszystkich wątków
+            for (auto& thread : threads) {
+                thread.join();
+            }
         }
 
         size_t totalWritten = algorithms.size() * FILE_SIZE_BYTES;
         std::cout << std::endl;
         std::cout << "Zakończono generowanie szyfrogramów." << std::endl;
-        std::cout << "Łącznie zapisano: " << formatBytes(totalWritten) << std::endl;
+        std::cout << "Łącznie " << (writeFiles ? "zapisano" : "przetworzono") << ": " << formatBytes(totalWritten)
+                  << std::endl;
         std::cout << "Pliki znajdują się w katalogu: " << outputDir << std::endl;
+        ChunkBufferPool& buffers = ChunkBufferPool::shared();
+        std::cout << "Pamięć buforów chunków: szczyt " << formatBytes(buffers.peakBytes())
+                  << (buffers.limit() > 0 ? ", limit " + formatBytes(buffers.limit()) : std::string(", bez limitu"))
+                  << std::endl;
     }
 };
 
 int main(int argc, char* argv[]) {
     unsigned int seed = 12345;
     std::string outputDir = "fake_text_ciphertexts";
+    size_t maxInFlight = 4; // chunki tekstu (po 100 MB) jednocześnie w pamięci, łącznie dla wszystkich algorytmów
+    // "per-algorithm" odtwarza dotychczasowe zbiory; "shared" / "seekable" generują tekst raz dla
+    // wszystkich algorytmów (szybciej), ale tylko cast dostaje ten sam tekst co dotąd
+    std::string plaintextMode = "per-algorithm";
+    std::string outputMode = "files"; // "stats" - pliki i statystyki, "stats-only" - same statystyki
+    std::vector<std::string> algorithms = defaultCipherAlgorithms(); // "all" albo np. "aes128-ctr,chacha20"
     
     if (argc > 1) {
         seed = std::stoul(argv[1]);
@@ -267,16 +335,37 @@ int main(int argc, char* argv[]) {
     if (argc > 2) {
         outputDir = argv[2];
     }
+    if (argc > 3) {
+        maxInFlight = std::stoul(argv[3]);
+    }
+    if (argc > 4) {
+        plaintextMode = argv[4];
+        if (plaintextMode != "seekable" && plaintextMode != "shared" && plaintextMode != "per-algorithm") {
+            std::cerr << "Nieznany tryb tekstu jawnego: " << plaintextMode
+                      << " (dostępne: seekable, shared, per-algorithm)" << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 5) {
+        outputMode = argv[5];
+        if (outputMode != "files" && outputMode != "stats" && outputMode != "stats-only") {
+            std::cerr << "Nieznany tryb wyjścia: " << outputMode << " (dostępne: files, stats, stats-only)"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 6 && !selectCipherAlgorithms(argv[6], algorithms)) {
+        return 1;
+    }
     
     std::cout << "=== Generator szyfrogramów z tekstu angielskiego (8 GB każdy) ===" << std::endl;
     std::cout << "Ziarno generatora: " << seed << std::endl;
     std::cout << "Katalog wyjściowy: " << outputDir << std::endl;
     std::cout << std::endl;
     
-    FakeTextCiphertextGenerator generator(seed);
-    generator.generateCiphertexts(outputDir, seed);
+    FakeTextCiphertextGenerator generator(seed, maxInFlight, plaintextMode, outputMode != "stats-only",
+                                          outputMode != "files");
+    generator.generateCiphertexts(outputDir, seed, algorithms);
     
     return 0;
 }
-
-#pragma GCC diagnostic pop
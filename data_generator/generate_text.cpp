@@ -1,4 +1,5 @@
 #include "text_generator.h"
+#include "work_stealing_pool.h"
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -11,6 +12,8 @@ int main(int argc, char* argv[]) {
     std::string outputDir = "text_files";
     double fileSizeGB = 8.0;
     int numFiles = 1;
+    std::string mode = "sequential"; // "seekable" - chunki równolegle, ale inny tekst niż dotąd
+    size_t workerThreads = 0;      // tylko tryb seekable; 0 = wszystkie rdzenie
     
     // Parsowanie argumentów
     if (argc > 1) {
@@ -25,12 +28,24 @@ int main(int argc, char* argv[]) {
     if (argc > 4) {
         numFiles = std::stoi(argv[4]);
     }
+    if (argc > 5) {
+        mode = argv[5];
+        if (mode != "seekable" && mode != "sequential") {
+            std::cerr << "Nieznany tryb generowania: " << mode
+                      << " (dostępne: sequential, seekable)" << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 6) {
+        workerThreads = std::stoul(argv[6]);
+    }
     
     std::cout << "=== Generator plików tekstowych (angielski) ===" << std::endl;
     std::cout << "Ziarno generatora: " << seed << std::endl;
     std::cout << "Katalog wyjściowy: " << outputDir << std::endl;
     std::cout << "Rozmiar każdego pliku: " << std::fixed << std::setprecision(3) << fileSizeGB << " GB" << std::endl;
     std::cout << "Liczba plików: " << numFiles << std::endl;
+    std::cout << "Tryb: " << mode << std::endl;
     std::cout << std::endl;
     
     // Utwórz katalog wyjściowy
@@ -39,7 +54,16 @@ int main(int argc, char* argv[]) {
     // Generuj pliki
     size_t fileSizeBytes = static_cast<size_t>(fileSizeGB * 1024.0 * 1024.0 * 1024.0);
     
-    if (numFiles == 1) {
+    if (mode == "seekable") {
+        // Chunki każdego pliku generowane równolegle we wspólnej puli, pliki po kolei
+        WorkStealingPool pool(workerThreads);
+        for (int i = 0; i < numFiles; i++) {
+            unsigned int fileSeed = seed + i * 10000;
+            std::string outputPath = outputDir + "/english_text_" + std::to_string(fileSeed) + ".txt";
+            TextGenerator generator(fileSeed);
+            generator.generateTextFileSeekable(outputPath, fileSizeBytes, pool);
+        }
+    } else if (numFiles == 1) {
         // Pojedynczy plik
         std::string outputPath = outputDir + "/english_text_" + std::to_string(seed) + ".txt";
         TextGenerator generator(seed);
@@ -0,0 +1,114 @@
+#include "dataset_view.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * Opis i weryfikacja pliku zbioru danych (kontener z dataset_format.h albo zwykły plik).
+ *
+ * Użycie: inspect_dataset <plik> [verify | chunk <k>]
+ *   bez trybu - nagłówek, metadane i podsumowanie indeksu
+ *   verify    - CRC wszystkich chunków (równolegle), kod wyjścia 1 przy niezgodności
+ *   chunk <k> - wpis indeksu chunka k, jego CRC i pierwsze bajty, bez czytania reszty pliku
+ */
+
+namespace {
+
+std::string formatBytes(uint64_t bytes) {
+    if (bytes < 1024) return std::to_string(bytes) + " B";
+    if (bytes < 1024 * 1024) return std::to_string(bytes / 1024) + " KB";
+    if (bytes < 1024 * 1024 * 1024) return std::to_string(bytes / (1024 * 1024)) + " MB";
+    return std::to_string(bytes / (1024ULL * 1024ULL * 1024ULL)) + " GB";
+}
+
+void printEntry(const DatasetView& view, size_t k) {
+    const DatasetIndexEntry& entry = view.index()[k];
+    std::cout << "Chunk " << k << ": przesunięcie " << entry.offset << ", rozmiar " << entry.size
+              << ", CRC-32 " << std::hex << std::setw(8) << std::setfill('0') << entry.crc << std::dec
+              << std::setfill(' ') << std::endl;
+    if (entry.hasStats) {
+        std::cout << "  jedynki: " << std::fixed << std::setprecision(6)
+                  << static_cast<double>(entry.stats.ones) / (8.0 * static_cast<double>(entry.size))
+                  << ", chi-kwadrat bajtów: " << std::setprecision(2) << entry.stats.byteChiSquare
+                  << ", entropia: " << std::setprecision(6) << entry.stats.byteEntropy << " bit/B" << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Użycie: " << argv[0] << " <plik> [verify | chunk <k>]" << std::endl;
+        return 1;
+    }
+    std::string mode = argc > 2 ? argv[2] : "";
+    if (!mode.empty() && mode != "verify" && !(mode == "chunk" && argc > 3)) {
+        std::cerr << "Nieznany tryb: " << mode << " (dostępne: verify, chunk <k>)" << std::endl;
+        return 1;
+    }
+
+    DatasetView view;
+    if (!view.open(argv[1])) {
+        return 1;
+    }
+    if (!view.isContainer()) {
+        std::cout << "Plik bez kontenera (surowe dane): " << formatBytes(view.size()) << std::endl;
+        return mode.empty() ? 0 : 1;
+    }
+
+    const DatasetHeader& header = view.header();
+    if (mode.empty()) {
+        std::cout << "Kontener zbioru danych, wersja " << DATASET_VERSION << std::endl;
+        std::cout << "Dane: " << formatBytes(header.payloadSize) << " (" << header.payloadSize << " B), chunki: "
+                  << header.chunkCount << " po " << formatBytes(header.chunkSize) << std::endl;
+        for (const auto& entry : header.metadata) {
+            std::cout << "  " << entry.first << " = " << entry.second << std::endl;
+        }
+        bool hasStats = !view.index().empty() && view.index()[0].hasStats;
+        std::cout << "Statystyki chunków w indeksie: " << (hasStats ? "tak" : "nie") << std::endl;
+        return 0;
+    }
+
+    if (mode == "chunk") {
+        size_t k = std::stoul(argv[3]);
+        if (k >= view.index().size()) {
+            std::cerr << "Brak chunka " << k << " (chunków: " << view.index().size() << ")" << std::endl;
+            return 1;
+        }
+        printEntry(view, k);
+        DataChunk chunk = view.indexedChunk(k);
+        std::cout << "  początek:";
+        for (size_t i = 0; i < std::min<size_t>(chunk.size, 32); i++) {
+            std::cout << " " << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(chunk.data[i]);
+        }
+        std::cout << std::dec << std::setfill(' ') << std::endl;
+        bool ok = view.verifyChunk(k);
+        std::cout << "  CRC: " << (ok ? "zgodne" : "NIEZGODNE") << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    // verify - chunki niezależne, każdy sprawdzany w osobnym zadaniu puli
+    WorkStealingPool pool;
+    std::atomic<size_t> failures{0};
+    for (size_t k = 0; k < view.index().size(); k++) {
+        pool.submit([&view, &failures, k](size_t) {
+            if (!view.verifyChunk(k)) {
+                failures++;
+            }
+            // Zweryfikowany chunk nie będzie już czytany
+            DataChunk chunk = view.indexedChunk(k);
+            view.release(chunk.offset, chunk.size);
+        });
+    }
+    pool.wait();
+
+    if (failures > 0) {
+        std::cout << "Niezgodne CRC: " << failures << " z " << view.index().size() << " chunków" << std::endl;
+        return 1;
+    }
+    std::cout << "Wszystkie chunki (" << view.index().size() << ") zgodne z indeksem" << std::endl;
+    return 0;
+}
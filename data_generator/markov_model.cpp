@@ -0,0 +1,326 @@
+#include "markov_model.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (char c : text) {
+        if (std::isspace(c) || std::ispunct(c)) {
+            if (!current.empty()) {
+                tokens.push_back(current);
+                current.clear();
+            }
+            if (std::ispunct(c) && c != '\'' && c != '-') {
+                tokens.push_back(std::string(1, c));
+            }
+        } else {
+            current += std::tolower(c);
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(current);
+    }
+    return tokens;
+}
+
+MarkovModel::TokenKind classifyToken(const std::string& token) {
+    if (token == "." || token == "!" || token == "?") return MarkovModel::SENTENCE_END;
+    if (token == ",") return MarkovModel::COMMA;
+    if (token.size() == 1 && std::ispunct(static_cast<unsigned char>(token[0]))) return MarkovModel::OTHER_PUNCT;
+    return MarkovModel::WORD;
+}
+
+} // namespace
+
+std::shared_ptr<const MarkovModel> MarkovModel::fromCorpus(const std::vector<std::string>& corpus) {
+    std::shared_ptr<MarkovModel> modelPtr(new MarkovModel());
+    MarkovModel& model = *modelPtr;
+    std::unordered_map<std::string, TokenId> ids;
+    std::vector<std::vector<TokenId>> chain;
+
+    auto intern = [&](const std::string& token) -> TokenId {
+        auto it = ids.find(token);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        TokenId id = static_cast<TokenId>(model.tokenKinds.size());
+        ids.emplace(token, id);
+        model.tokenOffsets.push_back(static_cast<uint32_t>(model.tokenText.size()));
+        model.tokenText += token;
+        model.tokenKinds.push_back(classifyToken(token));
+        model.maxTokenLength = std::max(model.maxTokenLength, token.size());
+        chain.emplace_back();
+        return id;
+    };
+
+    for (const auto& sentence : corpus) {
+        std::vector<std::string> tokens = tokenize(sentence);
+        if (tokens.size() < 2) continue;
+
+        // Zapisz pierwsze słowo jako starter
+        if (tokens[0] != "." && tokens[0] != "!" && tokens[0] != "?") {
+            model.sentenceStarters.push_back(intern(tokens[0]));
+        }
+
+        // Bigramy - każde słowo zależy od poprzedniego
+        for (size_t i = 0; i < tokens.size() - 1; i++) {
+            const std::string& current = tokens[i];
+
+            // Pomijaj interpunkcję jako klucze
+            if (current == "." || current == "!" || current == "?" ||
+                current == "," || current == ";" || current == ":") {
+                continue;
+            }
+
+            TokenId from = intern(current);
+            TokenId to = intern(tokens[i + 1]);
+            chain[from].push_back(to);
+        }
+    }
+    model.tokenOffsets.push_back(static_cast<uint32_t>(model.tokenText.size()));
+
+    // Spłaszczenie list następników do CSR
+    model.successorOffsets.reserve(chain.size() + 1);
+    for (const auto& next : chain) {
+        model.successorOffsets.push_back(static_cast<uint32_t>(model.successors.size()));
+        model.successors.insert(model.successors.end(), next.begin(), next.end());
+    }
+    model.successorOffsets.push_back(static_cast<uint32_t>(model.successors.size()));
+
+    return modelPtr;
+}
+
+const std::vector<std::string>& MarkovModel::defaultCorpus() {
+    // Korpus realistycznych zdań angielskich do treningu łańcucha Markowa
+    static const std::vector<std::string> corpus = {
+        "The quick brown fox jumps over the lazy dog.",
+        "In the beginning was the word and the word was with God.",
+        "To be or not to be that is the question.",
+        "It was the best of times it was the worst of times.",
+        "All happy families are alike each unhappy family is unhappy in its own way.",
+        "Call me Ishmael some years ago never mind how long precisely.",
+        "It is a truth universally acknowledged that a single man in possession of a good fortune must be in want of a wife.",
+        "The sun was shining on the sea shining with all his might.",
+        "Once upon a time in a galaxy far far away.",
+        "The old man and the sea was his favorite book.",
+        "She walked down the street with confidence and purpose.",
+        "The computer science department offers many interesting courses.",
+        "Artificial intelligence is transforming the way we work and live.",
+        "The weather today is beautiful with clear blue skies.",
+        "They decided to go for a walk in the park.",
+        "The meeting was scheduled for three o clock in the afternoon.",
+        "She opened the door and stepped into the room.",
+        "The book on the table belongs to my friend.",
+        "We need to finish this project by the end of the week.",
+        "The students were studying hard for their final exams.",
+        "He picked up the phone and dialed the number.",
+        "The restaurant serves delicious food at reasonable prices.",
+        "They traveled across the country to visit their relatives.",
+        "The company announced a new product launch next month.",
+        "She wrote a letter to her grandmother last week.",
+        "The movie was entertaining but the ending was disappointing.",
+        "He enjoys reading books about history and science.",
+        "The team worked together to solve the complex problem.",
+        "They went shopping at the mall on Saturday afternoon.",
+        "The teacher explained the lesson clearly to the students.",
+        "She loves to play the piano in her spare time.",
+        "The garden was full of beautiful flowers and plants.",
+        "He decided to take a break from work and relax.",
+        "The news about the accident spread quickly through the town.",
+        "They built a new house on the hill overlooking the valley.",
+        "The conference will be held in the convention center downtown.",
+        "She received a scholarship to study at the university.",
+        "The dog ran across the yard chasing the ball.",
+        "He found the solution to the problem after hours of thinking.",
+        "The library has an extensive collection of books and journals.",
+        "They celebrated their anniversary with a romantic dinner.",
+        "The artist painted a beautiful landscape of the countryside.",
+        "She learned to speak French during her stay in Paris.",
+        "The doctor recommended rest and plenty of fluids.",
+        "He bought a new car with all the latest features.",
+        "The children were playing in the park on a sunny day.",
+        "They organized a charity event to help the homeless.",
+        "The museum displays artifacts from ancient civilizations.",
+        "She completed her degree in computer science with honors.",
+        "The storm caused significant damage to the coastal areas.",
+        "He enjoys cooking and trying new recipes from different countries.",
+        "The company invested millions in research and development.",
+        "They went on a vacation to the tropical island.",
+        "The professor gave an interesting lecture on quantum physics.",
+        "She started her own business selling handmade jewelry.",
+        "The government announced new policies to improve education.",
+        "He spent the weekend working on his home improvement project.",
+        "The concert was sold out weeks before the event.",
+        "They discussed the proposal during the board meeting.",
+        "The novel tells the story of a young woman's journey.",
+        "She volunteered at the local animal shelter on weekends.",
+        "The technology has revolutionized the way we communicate.",
+        "He received recognition for his outstanding contribution to science.",
+        "The team won the championship after a thrilling final match.",
+        "They explored the ancient ruins of the lost civilization.",
+        "The restaurant offers a wide variety of international cuisine.",
+        "She published her first novel to critical acclaim.",
+        "The university offers scholarships to deserving students.",
+        "He enjoys hiking in the mountains during summer months.",
+        "The project requires collaboration between multiple departments.",
+        "They organized a surprise party for their friend's birthday.",
+        "The book provides valuable insights into human psychology.",
+        "She learned to play the guitar by watching online tutorials.",
+        "The company expanded its operations to new markets.",
+        "He wrote a comprehensive report on climate change.",
+        "The festival attracts thousands of visitors from around the world.",
+        "They renovated their house to make it more energy efficient.",
+        "The research team made a groundbreaking discovery in medicine.",
+        "She started a blog to share her travel experiences.",
+        "The school implemented new programs to support student learning.",
+        "He enjoys photography and capturing moments of everyday life.",
+        "The organization provides assistance to families in need.",
+        "They celebrated the holiday with traditional food and music.",
+        "The movie received several awards at the film festival.",
+        "She completed a marathon training program and ran her first race.",
+        "The company developed innovative solutions to environmental problems.",
+        "He enjoys reading science fiction novels in his free time.",
+        "The museum offers guided tours in multiple languages.",
+        "They planted a garden with vegetables and herbs.",
+        "The conference featured presentations by leading experts in the field.",
+        "She started learning a new language to expand her horizons.",
+        "The technology company announced plans for expansion into Asia.",
+        "He enjoys woodworking and creating furniture in his workshop.",
+        "The charity organization helps provide education to underprivileged children.",
+        "They went on a road trip across the country.",
+        "The book became a bestseller within weeks of publication.",
+        "She received a promotion at work for her excellent performance.",
+        "The university established a new research center for artificial intelligence.",
+        "He enjoys playing chess and participating in tournaments.",
+        "The restaurant chain opened new locations in several cities.",
+        "They organized a community cleanup event in the neighborhood.",
+        "The scientist published findings that could change our understanding of the universe.",
+        "She started a fitness routine and noticed significant improvements.",
+        "The company introduced flexible working hours for employees.",
+        "He enjoys bird watching and documenting different species.",
+        "The festival featured performances by local and international artists.",
+        "They invested in renewable energy solutions for their home.",
+        "The book explores themes of love loss and redemption.",
+        "She completed an online course to improve her skills.",
+        "The organization received funding to expand its programs.",
+        "He enjoys gardening and growing his own vegetables.",
+        "The conference addressed important issues facing the industry today."
+    };
+    return corpus;
+}
+
+bool MarkovModel::isConsistent() const {
+    const size_t tokens = tokenKinds.size();
+    if (tokenOffsets.size() != tokens + 1 || successorOffsets.size() != tokens + 1) return false;
+    if (tokenOffsets.front() != 0 || tokenOffsets.back() != tokenText.size()) return false;
+    if (successorOffsets.front() != 0 || successorOffsets.back() != successors.size()) return false;
+    for (size_t i = 0; i < tokens; i++) {
+        if (tokenOffsets[i] > tokenOffsets[i + 1] || successorOffsets[i] > successorOffsets[i + 1]) return false;
+        if (tokenOffsets[i + 1] - tokenOffsets[i] > maxTokenLength) return false;
+        if (tokenKinds[i] > OTHER_PUNCT) return false;
+    }
+    for (TokenId id : successors) {
+        if (id >= tokens) return false;
+    }
+    for (TokenId id : sentenceStarters) {
+        if (id >= tokens) return false;
+    }
+    return true;
+}
+
+namespace {
+
+const char MODEL_MAGIC[8] = {'M', 'A', 'R', 'K', 'O', 'V', '0', '1'};
+
+template <typename T>
+void writeArray(std::ofstream& file, const T* data, size_t count) {
+    uint64_t n = count;
+    file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    file.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+template <typename Container>
+bool readArray(std::ifstream& file, Container& out, size_t maxCount) {
+    uint64_t n = 0;
+    if (!file.read(reinterpret_cast<char*>(&n), sizeof(n)) || n > maxCount) return false;
+    out.resize(n);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), n * sizeof(out[0])));
+}
+
+} // namespace
+
+bool MarkovModel::save(const std::string& path) const {
+    // Format: magia, maxTokenLength, potem tablice jako (liczba elementów u64, surowe dane)
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Błąd: Nie można utworzyć pliku modelu " << path << std::endl;
+        return false;
+    }
+    uint64_t maxLength = maxTokenLength;
+    file.write(MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    file.write(reinterpret_cast<const char*>(&maxLength), sizeof(maxLength));
+    writeArray(file, tokenText.data(), tokenText.size());
+    writeArray(file, tokenOffsets.data(), tokenOffsets.size());
+    writeArray(file, tokenKinds.data(), tokenKinds.size());
+    writeArray(file, successorOffsets.data(), successorOffsets.size());
+    writeArray(file, successors.data(), successors.size());
+    writeArray(file, sentenceStarters.data(), sentenceStarters.size());
+    if (!file.good()) {
+        std::cerr << "Błąd: Zapis modelu do " << path << " nie powiódł się" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const MarkovModel> MarkovModel::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Błąd: Nie można otworzyć pliku modelu " << path << std::endl;
+        return nullptr;
+    }
+
+    // Limit rozmiaru tablic chroni przed ogromną alokacją przy uszkodzonym nagłówku
+    const size_t MAX_ELEMENTS = 1ULL << 32;
+    char magic[sizeof(MODEL_MAGIC)];
+    uint64_t maxLength = 0;
+    std::shared_ptr<MarkovModel> model(new MarkovModel());
+    bool ok = file.read(magic, sizeof(magic)) && memcmp(magic, MODEL_MAGIC, sizeof(magic)) == 0 &&
+              file.read(reinterpret_cast<char*>(&maxLength), sizeof(maxLength)) &&
+              readArray(file, model->tokenText, MAX_ELEMENTS) &&
+              readArray(file, model->tokenOffsets, MAX_ELEMENTS) &&
+              readArray(file, model->tokenKinds, MAX_ELEMENTS) &&
+              readArray(file, model->successorOffsets, MAX_ELEMENTS) &&
+              readArray(file, model->successors, MAX_ELEMENTS) &&
+              readArray(file, model->sentenceStarters, MAX_ELEMENTS);
+    model->maxTokenLength = maxLength;
+
+    if (!ok || !model->isConsistent()) {
+        std::cerr << "Błąd: Plik " << path << " nie zawiera poprawnego modelu Markowa" << std::endl;
+        return nullptr;
+    }
+    return model;
+}
+
+std::shared_ptr<const MarkovModel> MarkovModel::shared() {
+    // Inicjalizacja statycznej zmiennej lokalnej jest bezpieczna wątkowo - model powstaje raz
+    static const std::shared_ptr<const MarkovModel> instance = []() {
+        const char* path = std::getenv("MARKOV_MODEL");
+        if (path != nullptr && *path != '\0') {
+            std::shared_ptr<const MarkovModel> loaded = load(path);
+            if (loaded) {
+                return loaded;
+            }
+            std::cerr << "  Używam wbudowanego korpusu" << std::endl;
+        }
+        return fromCorpus(defaultCorpus());
+    }();
+    return instance;
+}
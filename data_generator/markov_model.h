@@ -0,0 +1,86 @@
+#ifndef MARKOV_MODEL_H
+#define MARKOV_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Skompilowany bigramowy łańcuch Markowa dla TextGenerator.
+ *
+ * Model jest niezmienny po zbudowaniu i współdzielony przez shared_ptr<const>:
+ * wszystkie generatory i wątki w procesie czytają tę samą kopię (MarkovModel::shared()).
+ * Można go zbudować z korpusu albo wczytać z pliku zapisanego przez save().
+ *
+ * Słowa są internowane do identyfikatorów: tekst wszystkich tokenów leży w jednym
+ * buforze, a następniki tokenu to ciągły wycinek tablicy `successors` (format CSR:
+ * successorOffsets[id] .. successorOffsets[id + 1]). Następniki są zapisane z
+ * powtórzeniami, w kolejności wystąpień w korpusie, więc losowanie indeksu z
+ * rozkładu jednostajnego daje rozkład zgodny z częstościami w O(1) i tę samą
+ * sekwencję słów co dawna mapa unordered_map<string, vector<string>>.
+ */
+class MarkovModel {
+public:
+    using TokenId = uint32_t;
+
+    // Rodzaje tokenów istotne przy składaniu zdania
+    enum TokenKind : uint8_t {
+        WORD = 0,
+        SENTENCE_END = 1, // . ! ?
+        COMMA = 2,
+        OTHER_PUNCT = 3   // ; : i pozostała interpunkcja
+    };
+
+private:
+    std::string tokenText;                // teksty tokenów jeden za drugim
+    std::vector<uint32_t> tokenOffsets;   // początek tekstu tokenu; ostatni element = tokenText.size()
+    std::vector<uint8_t> tokenKinds;
+    std::vector<uint32_t> successorOffsets;
+    std::vector<TokenId> successors;
+    std::vector<TokenId> sentenceStarters;
+    size_t maxTokenLength = 0;
+
+    MarkovModel() = default;
+
+    // Sprawdza spójność tablic (zakresy offsetów i identyfikatorów) - po wczytaniu z pliku
+    bool isConsistent() const;
+
+public:
+    // Tokenizuje zdania korpusu i buduje model (te same reguły co dawne addToMarkovChain)
+    static std::shared_ptr<const MarkovModel> fromCorpus(const std::vector<std::string>& corpus);
+
+    // Wbudowany korpus zdań angielskich
+    static const std::vector<std::string>& defaultCorpus();
+
+    // Wczytuje model zapisany przez save(); przy błędzie wypisuje komunikat i zwraca nullptr
+    static std::shared_ptr<const MarkovModel> load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    /**
+     * Model wspólny dla całego procesu, tworzony przy pierwszym użyciu: z pliku wskazanego
+     * zmienną środowiskową MARKOV_MODEL, a bez niej z wbudowanego korpusu.
+     * Jeśli pliku nie da się wczytać, używany jest wbudowany korpus.
+     */
+    static std::shared_ptr<const MarkovModel> shared();
+
+    bool empty() const { return successors.empty() || sentenceStarters.empty(); }
+
+    size_t tokenCount() const { return tokenKinds.size(); }
+
+    const char* tokenData(TokenId id) const { return tokenText.data() + tokenOffsets[id]; }
+    size_t tokenLength(TokenId id) const { return tokenOffsets[id + 1] - tokenOffsets[id]; }
+    TokenKind tokenKind(TokenId id) const { return static_cast<TokenKind>(tokenKinds[id]); }
+
+    // Następniki tokenu jako wycinek [first, first + count)
+    const TokenId* successorsOf(TokenId id) const { return successors.data() + successorOffsets[id]; }
+    size_t successorCount(TokenId id) const { return successorOffsets[id + 1] - successorOffsets[id]; }
+
+    const std::vector<TokenId>& starters() const { return sentenceStarters; }
+
+    // Górne ograniczenie długości zdania o co najwyżej `maxWords` słowach (ze spacjami i interpunkcją)
+    size_t maxSentenceBytes(size_t maxWords) const { return maxWords * (maxTokenLength + 3) + 1; }
+};
+
+#endif // MARKOV_MODEL_H
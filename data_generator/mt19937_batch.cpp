@@ -0,0 +1,47 @@
+#include "mt19937_batch.h"
+#include <cstring>
+
+namespace {
+
+typedef uint32_t SeedLanes __attribute__((vector_size(Mt19937Batch::LANES * sizeof(uint32_t))));
+
+constexpr uint32_t MT_INIT_MULTIPLIER = 1812433253u;
+constexpr uint32_t MT_MATRIX_A = 0x9908B0DFu;
+constexpr uint32_t MT_UPPER_MASK = 0x80000000u;
+constexpr uint32_t MT_LOWER_MASK = 0x7FFFFFFFu;
+constexpr size_t MT_SHIFT = 397;
+
+} // namespace
+
+void Mt19937Batch::seed(uint32_t firstSeed) {
+    // x[0] = ziarno, x[i] = 1812433253 * (x[i-1] ^ (x[i-1] >> 30)) + i - dla wszystkich pasów naraz
+    SeedLanes x;
+    for (size_t lane = 0; lane < LANES; lane++) {
+        x[lane] = firstSeed + static_cast<uint32_t>(lane);
+    }
+    memcpy(state.data(), &x, sizeof(x));
+    for (size_t i = 1; i < STATE_SIZE; i++) {
+        x = MT_INIT_MULTIPLIER * (x ^ (x >> 30)) + static_cast<uint32_t>(i);
+        memcpy(state.data() + i * LANES, &x, sizeof(x));
+    }
+}
+
+Mt19937Batch::Engine::result_type Mt19937Batch::Engine::operator()() {
+    // Jeden krok twistu w miejscu: słowa o indeksach < index są już przemieszane,
+    // dokładnie jak w trakcie pełnego twistu std::mt19937
+    size_t i = index;
+    size_t next = i + 1 == STATE_SIZE ? 0 : i + 1;
+    size_t shifted = i + MT_SHIFT < STATE_SIZE ? i + MT_SHIFT : i + MT_SHIFT - STATE_SIZE;
+
+    uint32_t y = (word(i) & MT_UPPER_MASK) | (word(next) & MT_LOWER_MASK);
+    uint32_t z = word(shifted) ^ (y >> 1) ^ ((y & 1) ? MT_MATRIX_A : 0);
+    word(i) = z;
+    index = next;
+
+    // Tempering
+    z ^= z >> 11;
+    z ^= (z << 7) & 0x9D2C5680u;
+    z ^= (z << 15) & 0xEFC60000u;
+    z ^= z >> 18;
+    return z;
+}
@@ -0,0 +1,55 @@
+#ifndef MT19937_BATCH_H
+#define MT19937_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Stany std::mt19937 dla LANES kolejnych ziaren, inicjalizowane naraz.
+ *
+ * TextGenerator tworzy nowy mt19937 dla każdego zdania (ziarno, ziarno + 1, ...),
+ * a samo ziarnowanie - 623 zależne mnożenia - kosztuje więcej niż złożenie zdania.
+ * Tutaj rekurencja ziarnowania liczona jest wektorowo dla 16 ziaren jednocześnie,
+ * a przemieszanie stanu (twist) odbywa się leniwie, słowo po słowie, dopiero gdy
+ * potrzebne jest kolejne wyjście. Sekwencja z Engine jest identyczna z std::mt19937
+ * zainicjalizowanym tym samym ziarnem, także po przekroczeniu 624 wyjść.
+ */
+class Mt19937Batch {
+public:
+    static constexpr size_t LANES = 16;
+    static constexpr size_t STATE_SIZE = 624;
+
+    // Widok na stan jednego ziarna; spełnia wymagania UniformRandomBitGenerator
+    class Engine {
+    public:
+        using result_type = uint_fast32_t; // jak std::mt19937 - rozkłady wybierają tę samą ścieżkę
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        result_type operator()();
+
+    private:
+        friend class Mt19937Batch;
+        Engine(uint32_t* column) : column(column) {}
+
+        uint32_t& word(size_t i) { return column[i * LANES]; }
+
+        uint32_t* column;
+        size_t index = 0;
+    };
+
+    Mt19937Batch() : state(STATE_SIZE * LANES) {}
+
+    // Inicjalizuje stany dla ziaren firstSeed .. firstSeed + LANES - 1 (modulo 2^32)
+    void seed(uint32_t firstSeed);
+
+    // Silnik dla ziarna firstSeed + lane; każdy pas może być użyty tylko raz po seed()
+    Engine engine(size_t lane) { return Engine(state.data() + lane); }
+
+private:
+    std::vector<uint32_t> state; // state[i * LANES + lane] - i-te słowo stanu danego ziarna
+};
+
+#endif // MT19937_BATCH_H
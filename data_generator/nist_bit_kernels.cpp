@@ -0,0 +1,346 @@
+#include "nist_bit_kernels.h"
+#include "nist_bit_kernels_impl.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Tablice per bajt (bity od najstarszego): przyrost i ekstrema sum częściowych po krokach 1..8
+// oraz serie jedynek - od początku, na końcu i najdłuższa w bajcie
+struct ByteTables {
+    int8_t delta[256];
+    int8_t maxPrefix[256];
+    int8_t minPrefix[256];
+    uint8_t leadingOnes[256];
+    uint8_t trailingOnes[256];
+    uint8_t longestRun[256];
+};
+
+constexpr ByteTables makeByteTables() {
+    ByteTables tables{};
+    for (int b = 0; b < 256; b++) {
+        int sum = 0, maxSum = -8, minSum = 8;
+        int run = 0, longest = 0, leading = 0;
+        bool leadingOpen = true;
+        for (int bit = 7; bit >= 0; bit--) {
+            bool one = (b >> bit) & 1;
+            sum += one ? 1 : -1;
+            maxSum = std::max(maxSum, sum);
+            minSum = std::min(minSum, sum);
+            run = one ? run + 1 : 0;
+            longest = std::max(longest, run);
+            if (leadingOpen && one) {
+                leading++;
+            } else {
+                leadingOpen = false;
+            }
+        }
+        tables.delta[b] = static_cast<int8_t>(sum);
+        tables.maxPrefix[b] = static_cast<int8_t>(maxSum);
+        tables.minPrefix[b] = static_cast<int8_t>(minSum);
+        tables.leadingOnes[b] = static_cast<uint8_t>(leading);
+        tables.trailingOnes[b] = static_cast<uint8_t>(run);
+        tables.longestRun[b] = static_cast<uint8_t>(longest);
+    }
+    return tables;
+}
+
+constexpr ByteTables BYTE_TABLES = makeByteTables();
+
+// Próbki +1.0 / -1.0 dla każdego bajtu (16 KB)
+struct SignTable {
+    double samples[256][8];
+};
+
+constexpr SignTable makeSignTable() {
+    SignTable table{};
+    for (int b = 0; b < 256; b++) {
+        for (int bit = 0; bit < 8; bit++) {
+            table.samples[b][bit] = ((b >> (7 - bit)) & 1) ? 1.0 : -1.0;
+        }
+    }
+    return table;
+}
+
+constexpr SignTable SIGN_TABLE = makeSignTable();
+
+// Przejścia w obrębie bajtu i na granicy z następnym: bit k wyniku to eps_k ^ eps_k+1
+inline unsigned byteTransitions(unsigned char b, unsigned char next) {
+    return ((b ^ (b >> 1)) & 0x7F) | (((b << 7) ^ next) & 0x80);
+}
+
+inline unsigned bitAt(const unsigned char* data, uint64_t k) {
+    return (data[k >> 3] >> (7 - (k & 7))) & 1;
+}
+
+struct BitKernelChoice {
+    uint64_t (*ones)(const unsigned char* data, size_t bytes);
+    void (*blockOnes)(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+    uint64_t (*transitions)(const unsigned char* data, size_t bytes);
+    void (*walk)(const unsigned char* data, size_t bytes, NistWalk& walk);
+    void (*signs)(const unsigned char* data, size_t bytes, double* out);
+    void (*longestRuns)(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+    const char* name;
+};
+
+BitKernelChoice selectBitKernel() {
+#ifdef CIPHERDATA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {nistOnesBytesAvx2, nistBlockOnesBytesAvx2, nistTransitionsBytesAvx2, nistWalkBytesAvx2, nistSignsBytesAvx2,
+                nistLongestRunsBytesAvx2, "avx2"};
+    }
+#endif
+    return {nistOnesBytes64, nistBlockOnesBytes64, nistTransitionsBytes64, nistWalkBytes64, nistSignsBytes64, nistLongestRunsBytes64,
+            "64-bit"};
+}
+
+const BitKernelChoice& bitKernel() {
+    static const BitKernelChoice choice = selectBitKernel();
+    return choice;
+}
+
+} // namespace
+
+uint64_t nistOnesBytes64(const unsigned char* data, size_t bytes) {
+    uint64_t ones = 0;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        ones += __builtin_popcountll(word);
+    }
+    for (; i < bytes; i++) {
+        ones += __builtin_popcount(data[i]);
+    }
+    return ones;
+}
+
+void nistBlockOnesBytes64(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    for (size_t i = 0; i < blocks; i++) {
+        out[i] = static_cast<uint32_t>(nistOnesBytes64(data + i * blockBytes, blockBytes));
+    }
+}
+
+uint64_t nistTransitionsBytes64(const unsigned char* data, size_t bytes) {
+    // Ten sam wzór co byteTransitions na 8 bajtach naraz (słowo little-endian, bajt = 8 par)
+    const uint64_t inner = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t boundary = 0x8080808080808080ULL;
+    uint64_t transitions = 0;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t x, next;
+        std::memcpy(&x, data + i, 8);
+        std::memcpy(&next, data + i + 1, 8);
+        transitions += __builtin_popcountll(((x ^ (x >> 1)) & inner) | (((x << 7) ^ next) & boundary));
+    }
+    for (; i < bytes; i++) {
+        transitions += __builtin_popcount(byteTransitions(data[i], data[i + 1]));
+    }
+    return transitions;
+}
+
+void nistWalkBytes64(const unsigned char* data, size_t bytes, NistWalk& walk) {
+    int64_t sum = walk.sum, minSum = walk.minSum, maxSum = walk.maxSum;
+    for (size_t i = 0; i < bytes; i++) {
+        unsigned char b = data[i];
+        maxSum = std::max<int64_t>(maxSum, sum + BYTE_TABLES.maxPrefix[b]);
+        minSum = std::min<int64_t>(minSum, sum + BYTE_TABLES.minPrefix[b]);
+        sum += BYTE_TABLES.delta[b];
+    }
+    walk.sum = sum;
+    walk.minSum = minSum;
+    walk.maxSum = maxSum;
+}
+
+void nistRunBytes64(const unsigned char* data, size_t bytes, NistRunState& state) {
+    size_t longest = state.longest, run = state.run;
+    for (size_t i = 0; i < bytes; i++) {
+        unsigned char b = data[i];
+        if (b == 0xFF) {
+            run += 8;
+            continue;
+        }
+        longest = std::max({longest, run + BYTE_TABLES.leadingOnes[b], size_t(BYTE_TABLES.longestRun[b])});
+        run = BYTE_TABLES.trailingOnes[b];
+    }
+    state.run = run;
+    state.longest = longest;
+}
+
+void nistLongestRunsBytes64(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    for (size_t i = 0; i < blocks; i++) {
+        NistRunState state;
+        nistRunBytes64(data + i * blockBytes, blockBytes, state);
+        out[i] = static_cast<uint32_t>(std::max(state.longest, state.run));
+    }
+}
+
+void nistSignsBytes64(const unsigned char* data, size_t bytes, double* out) {
+    for (size_t i = 0; i < bytes; i++) {
+        std::memcpy(out + 8 * i, SIGN_TABLE.samples[data[i]], sizeof(SIGN_TABLE.samples[0]));
+    }
+}
+
+uint64_t nistPackedOnes(const unsigned char* data, uint64_t bitOffset, uint64_t bitCount) {
+    if (bitCount == 0) {
+        return 0;
+    }
+    const unsigned char* p = data + (bitOffset >> 3);
+    unsigned head = static_cast<unsigned>(bitOffset & 7);
+    uint64_t ones = 0;
+    if (head != 0) {
+        unsigned mask = 0xFFu >> head;
+        if (head + bitCount <= 8) {
+            mask &= ~(0xFFu >> (head + bitCount));
+            return __builtin_popcount(p[0] & mask);
+        }
+        ones += __builtin_popcount(p[0] & mask);
+        bitCount -= 8 - head;
+        p++;
+    }
+    size_t full = static_cast<size_t>(bitCount >> 3);
+    ones += bitKernel().ones(p, full);
+    unsigned tail = static_cast<unsigned>(bitCount & 7);
+    if (tail != 0) {
+        ones += __builtin_popcount(p[full] & (0xFF00u >> tail) & 0xFFu);
+    }
+    return ones;
+}
+
+void nistPackedBlockOnes(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    bitKernel().blockOnes(data, blockBytes, blocks, out);
+}
+
+uint64_t nistPackedTransitions(const unsigned char* data, size_t n) {
+    if (n < 2) {
+        return 0;
+    }
+    // Bajt i obejmuje pary 8i..8i+7; pełne są te, których ostatnia para mieści się w k < n-1
+    size_t full = (n - 1) / 8;
+    uint64_t transitions = bitKernel().transitions(data, full);
+    for (size_t k = 8 * full; k + 1 < n; k++) {
+        transitions += bitAt(data, k) ^ bitAt(data, k + 1);
+    }
+    return transitions;
+}
+
+NistWalk nistPackedWalk(const unsigned char* data, size_t n) {
+    NistWalk walk;
+    bitKernel().walk(data, n / 8, walk);
+    for (size_t k = n & ~size_t(7); k < n; k++) {
+        walk.sum += bitAt(data, k) ? 1 : -1;
+        walk.maxSum = std::max(walk.maxSum, walk.sum);
+        walk.minSum = std::min(walk.minSum, walk.sum);
+    }
+    return walk;
+}
+
+void nistPackedToSigns(const unsigned char* data, size_t n, double* out) {
+    bitKernel().signs(data, n / 8, out);
+    for (size_t k = n & ~size_t(7); k < n; k++) {
+        out[k] = bitAt(data, k) ? 1.0 : -1.0;
+    }
+}
+
+size_t nistPackedLongestRunOfOnes(const unsigned char* data, size_t bytes) {
+    uint32_t longest = 0;
+    bitKernel().longestRuns(data, bytes, 1, &longest);
+    return longest;
+}
+
+void nistPackedLongestRuns(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    bitKernel().longestRuns(data, blockBytes, blocks, out);
+}
+
+size_t nistGf2Rank32(uint32_t rows[32]) {
+    size_t rank = 0;
+    for (int column = 31; column >= 0 && rank < 32; column--) {
+        size_t pivot = rank;
+        while (pivot < 32 && !((rows[pivot] >> column) & 1)) {
+            pivot++;
+        }
+        if (pivot == 32) {
+            continue;
+        }
+        std::swap(rows[pivot], rows[rank]);
+        // Eliminacja bez rozgałęzień: maska z bitu kolumny
+        const uint32_t pivotRow = rows[rank];
+        for (size_t r = rank + 1; r < 32; r++) {
+            rows[r] ^= pivotRow & (0u - ((rows[r] >> column) & 1));
+        }
+        rank++;
+    }
+    return rank;
+}
+
+size_t nistPackedBerlekampMassey(const unsigned char* data, uint64_t bitOffset, size_t length) {
+    // Bit i słowa-tablicy to współczynnik przy x^i. `recent` trzyma ostatnie bity sekwencji
+    // odwrócone (bit i = s_{N-i}), więc rozbieżność to parzystość popcount(C & recent).
+    // B jest przechowywany już pomnożony przez x^(N-m), tj. przesuwany o 1 w każdym kroku.
+    const size_t words = length / 64 + 2;
+    std::vector<uint64_t> C(words, 0), B(words, 0), T(words), recent(words, 0);
+    C[0] = 1;
+    B[0] = 2;
+    size_t L = 0;
+
+    for (size_t N = 0; N < length; N++) {
+        // Aktywne słowa: stopnie wielomianów i długość `recent` nie przekraczają N + 1
+        const size_t active = std::min(words, (N + 1) / 64 + 1);
+        for (size_t w = active - 1; w > 0; w--) {
+            recent[w] = (recent[w] << 1) | (recent[w - 1] >> 63);
+        }
+        recent[0] = (recent[0] << 1) | bitAt(data, bitOffset + N);
+
+        uint64_t parity = 0;
+        for (size_t w = 0; w < active; w++) {
+            parity ^= C[w] & recent[w];
+        }
+        bool replaceB = false;
+        if (__builtin_parityll(parity)) {
+            std::copy(C.begin(), C.begin() + active, T.begin());
+            for (size_t w = 0; w < active; w++) {
+                C[w] ^= B[w];
+            }
+            if (L <= N / 2) {
+                L = N + 1 - L;
+                replaceB = true;
+            }
+        }
+        if (replaceB) {
+            std::copy(T.begin(), T.begin() + active, B.begin());
+        }
+        const size_t shifted = std::min(words, active + 1);
+        for (size_t w = shifted - 1; w > 0; w--) {
+            B[w] = (B[w] << 1) | (B[w - 1] >> 63);
+        }
+        B[0] <<= 1;
+    }
+    return L;
+}
+
+void nistCopyPackedBits(const unsigned char* data, uint64_t bitOffset, size_t n, unsigned char* out) {
+    const unsigned char* src = data + (bitOffset >> 3);
+    unsigned shift = static_cast<unsigned>(bitOffset & 7);
+    size_t bytes = (n + 7) / 8;
+    if (shift == 0) {
+        std::memcpy(out, src, bytes);
+    } else {
+        for (size_t i = 0; i < bytes; i++) {
+            unsigned value = static_cast<unsigned>(src[i]) << shift;
+            // Następny bajt źródła czytany tylko, jeśli leżą w nim jeszcze bity sekwencji
+            if (8 * (i + 1) < shift + n) {
+                value |= src[i + 1] >> (8 - shift);
+            }
+            out[i] = static_cast<unsigned char>(value);
+        }
+    }
+    if (n & 7) {
+        out[bytes - 1] &= static_cast<unsigned char>(0xFF00u >> (n & 7));
+    }
+}
+
+const char* nistBitKernelName() {
+    return bitKernel().name;
+}
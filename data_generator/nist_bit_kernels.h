@@ -0,0 +1,64 @@
+#ifndef NIST_BIT_KERNELS_H
+#define NIST_BIT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Jądra statystyk bitowych dla tanich testów NIST STS, liczone wprost na danych
+ * spakowanych po 8 bitów w bajcie (od najstarszego bitu - tak jak zapisują je generatory).
+ *
+ * Jedynki liczy popcount, przejścia 0/1 - popcount z x ^ (x >> 1) (wraz z parą
+ * na granicy bajtów), a ekstrema błądzenia losowego (CumulativeSums) - tablice
+ * per bajt/półbajt (przyrost, maksimum i minimum sum częściowych). Najdłuższe serie
+ * jedynek (LongestRun) w wariancie AVX2 to statystyki serii per półbajt (vpshufb: jedynki
+ * na początku, na końcu, najdłuższa) łączone drzewem w 128-bitowe pasy, a między pasami
+ * przeniesienie serii. Wariant AVX2 jest wybierany w czasie działania, na pozostałych CPU
+ * działają słowa 64-bitowe i tablice per bajt.
+ *
+ * Operacje nad GF(2) dla testów Rank i LinearComplexity też działają na słowach:
+ * macierz 32x32 to 32 wiersze uint32_t, a wielomiany Berlekampa-Masseya - tablice
+ * uint64_t aktualizowane XOR-em i przesunięciami.
+ */
+
+// Sumy częściowe S_k = sum(2*eps_i - 1) dla k = 0..n (S_0 = 0 wliczone w ekstrema)
+struct NistWalk {
+    int64_t sum = 0;
+    int64_t minSum = 0;
+    int64_t maxSum = 0;
+};
+
+// Liczba jedynek w bitach [bitOffset, bitOffset + bitCount)
+uint64_t nistPackedOnes(const unsigned char* data, uint64_t bitOffset, uint64_t bitCount);
+
+// Liczby jedynek w `blocks` kolejnych blokach po `blockBytes` bajtów; out[i] - blok i
+void nistPackedBlockOnes(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+
+// Liczba par k, k+1 (k < n-1) o różnych bitach; sekwencja zaczyna się od bitu 0
+uint64_t nistPackedTransitions(const unsigned char* data, size_t n);
+
+// Suma końcowa i ekstrema sum częściowych n bitów od bitu 0
+NistWalk nistPackedWalk(const unsigned char* data, size_t n);
+
+// Najdłuższa seria jedynek w `bytes` pełnych bajtach
+size_t nistPackedLongestRunOfOnes(const unsigned char* data, size_t bytes);
+
+// Najdłuższe serie jedynek w `blocks` kolejnych blokach po `blockBytes` bajtów; out[i] - blok i
+void nistPackedLongestRuns(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+
+// Zamienia n bitów od bitu 0 na próbki +1.0 / -1.0 (wejście testu spektralnego)
+void nistPackedToSigns(const unsigned char* data, size_t n, double* out);
+
+// Rząd macierzy 32x32 nad GF(2); wiersz r to rows[r], kolumna 0 w najstarszym bicie (niszczy rows)
+size_t nistGf2Rank32(uint32_t rows[32]);
+
+// Złożoność liniowa `length` bitów od bitu `bitOffset` (Berlekamp-Massey na słowach 64-bitowych)
+size_t nistPackedBerlekampMassey(const unsigned char* data, uint64_t bitOffset, size_t length);
+
+// Kopiuje n bitów od bitu `bitOffset` tak, by zaczynały się od bitu 0 w `out` ((n + 7) / 8 bajtów)
+void nistCopyPackedBits(const unsigned char* data, uint64_t bitOffset, size_t n, unsigned char* out);
+
+// Nazwa wybranego wariantu jąder ("avx2" / "64-bit")
+const char* nistBitKernelName();
+
+#endif // NIST_BIT_KERNELS_H
@@ -0,0 +1,303 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "nist_bit_kernels_impl.h"
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+
+// Tablice per półbajt (bity od najstarszego) dla vpshufb: przyrost i ekstrema sum po krokach 1..4
+struct NibbleTables {
+    int8_t delta[16];
+    int8_t maxPrefix[16];
+    int8_t minPrefix[16];
+};
+
+constexpr NibbleTables makeNibbleTables() {
+    NibbleTables tables{};
+    for (int n = 0; n < 16; n++) {
+        int sum = 0, maxSum = -4, minSum = 4;
+        for (int bit = 3; bit >= 0; bit--) {
+            sum += ((n >> bit) & 1) ? 1 : -1;
+            maxSum = std::max(maxSum, sum);
+            minSum = std::min(minSum, sum);
+        }
+        tables.delta[n] = static_cast<int8_t>(sum);
+        tables.maxPrefix[n] = static_cast<int8_t>(maxSum);
+        tables.minPrefix[n] = static_cast<int8_t>(minSum);
+    }
+    return tables;
+}
+
+constexpr NibbleTables NIBBLE_TABLES = makeNibbleTables();
+
+// Sumy względne bloku mieszczą się w int16: 240 * 16 bajtów * 8 kroków < 32767
+constexpr size_t WALK_BLOCK_CHUNKS = 240;
+
+// Liczba jedynek w każdym bajcie (Mula: vpshufb na półbajtach)
+inline __m256i popcountBytes(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, lowNibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+}
+
+inline uint64_t horizontalSum64(__m256i v) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+}
+
+// Statystyki serii jedynek w półbajcie (bity od najstarszego): jedynki na początku, na końcu, najdłuższa seria
+struct RunNibbleTables {
+    int8_t lead[16];
+    int8_t trail[16];
+    int8_t best[16];
+};
+
+constexpr RunNibbleTables makeRunNibbleTables() {
+    RunNibbleTables tables{};
+    for (int n = 0; n < 16; n++) {
+        int run = 0, best = 0, lead = 0;
+        bool leadOpen = true;
+        for (int bit = 3; bit >= 0; bit--) {
+            bool one = (n >> bit) & 1;
+            run = one ? run + 1 : 0;
+            best = std::max(best, run);
+            leadOpen = leadOpen && one;
+            lead += leadOpen ? 1 : 0;
+        }
+        tables.lead[n] = static_cast<int8_t>(lead);
+        tables.trail[n] = static_cast<int8_t>(run);
+        tables.best[n] = static_cast<int8_t>(best);
+    }
+    return tables;
+}
+
+constexpr RunNibbleTables RUN_NIBBLE_TABLES = makeRunNibbleTables();
+
+// Statystyki serii w każdym bajcie rejestru; odcinek o długości `length` bitów jest cały z jedynek,
+// gdy lead == length (wtedy też trail == best == length). Wartości do 128 mieszczą się w bajcie bez znaku
+struct RunStats {
+    __m256i lead;
+    __m256i trail;
+    __m256i best;
+};
+
+// Łączy odcinek `a` z następującym po nim odcinkiem `b` tej samej długości
+inline RunStats combineRuns(const RunStats& a, const RunStats& b, __m256i length) {
+    // Odcinek z samych jedynek przedłuża serię sąsiada
+    RunStats joined;
+    joined.lead = _mm256_add_epi8(a.lead, _mm256_and_si256(_mm256_cmpeq_epi8(a.lead, length), b.lead));
+    joined.trail = _mm256_add_epi8(b.trail, _mm256_and_si256(_mm256_cmpeq_epi8(b.trail, length), a.trail));
+    joined.best = _mm256_max_epu8(_mm256_max_epu8(a.best, b.best), _mm256_add_epi8(a.trail, b.lead));
+    return joined;
+}
+
+// Statystyki serii każdego 128-bitowego pasa (w bajcie 0 i 16): półbajty z vpshufb, potem drzewo
+// połączeń sąsiednich odcinków po 8, 16, 32 i 64 bity - bez rozgałęzień zależnych od danych
+inline RunStats laneRunStats(__m256i x) {
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    const __m256i leadTable = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(RUN_NIBBLE_TABLES.lead)));
+    const __m256i trailTable = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(RUN_NIBBLE_TABLES.trail)));
+    const __m256i bestTable = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(RUN_NIBBLE_TABLES.best)));
+    __m256i lo = _mm256_and_si256(x, lowNibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), lowNibble);
+    RunStats high = {_mm256_shuffle_epi8(leadTable, hi), _mm256_shuffle_epi8(trailTable, hi),
+                     _mm256_shuffle_epi8(bestTable, hi)};
+    RunStats low = {_mm256_shuffle_epi8(leadTable, lo), _mm256_shuffle_epi8(trailTable, lo),
+                    _mm256_shuffle_epi8(bestTable, lo)};
+    // Bajt = starszy półbajt, potem młodszy; następny odcinek leży pod wyższym adresem
+    RunStats s = combineRuns(high, low, _mm256_set1_epi8(4));
+    s = combineRuns(s, {_mm256_srli_epi16(s.lead, 8), _mm256_srli_epi16(s.trail, 8), _mm256_srli_epi16(s.best, 8)},
+                    _mm256_set1_epi8(8));
+    s = combineRuns(s, {_mm256_srli_epi32(s.lead, 16), _mm256_srli_epi32(s.trail, 16),
+                        _mm256_srli_epi32(s.best, 16)}, _mm256_set1_epi8(16));
+    s = combineRuns(s, {_mm256_srli_epi64(s.lead, 32), _mm256_srli_epi64(s.trail, 32),
+                        _mm256_srli_epi64(s.best, 32)}, _mm256_set1_epi8(32));
+    return combineRuns(s, {_mm256_srli_si256(s.lead, 8), _mm256_srli_si256(s.trail, 8),
+                           _mm256_srli_si256(s.best, 8)}, _mm256_set1_epi8(64));
+}
+
+// Dopisuje 16-bajtowy pas o statystykach (lead, trail, best) do serii `state`
+inline void appendLane(NistRunState& state, size_t lead, size_t trail, size_t best) {
+    state.longest = std::max({state.longest, state.run + lead, best});
+    state.run = lead == 128 ? state.run + 128 : trail;
+}
+
+// Bloki po 16 bajtów (M = 128): blok to dokładnie jeden pas
+void longestRunsLanes(const unsigned char* data, size_t blocks, uint32_t* out) {
+    size_t b = 0;
+    for (; b + 2 <= blocks; b += 2) {
+        RunStats s = laneRunStats(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 16 * b)));
+        out[b] = static_cast<uint32_t>(_mm256_extract_epi8(s.best, 0));
+        out[b + 1] = static_cast<uint32_t>(_mm256_extract_epi8(s.best, 16));
+    }
+    nistLongestRunsBytes64(data + 16 * b, 16, blocks - b, out + b);
+}
+
+// Dłuższe bloki: pasy po kolei, z przeniesieniem serii między nimi; porcje z samych jedynek bez statystyk
+size_t longestRunSpan(const unsigned char* data, size_t bytes) {
+    const __m256i allOnes = _mm256_set1_epi8(-1);
+    NistRunState state;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, allOnes)) == -1) {
+            state.run += 256;
+            continue;
+        }
+        RunStats s = laneRunStats(x);
+        appendLane(state, _mm256_extract_epi8(s.lead, 0), _mm256_extract_epi8(s.trail, 0),
+                   _mm256_extract_epi8(s.best, 0));
+        appendLane(state, _mm256_extract_epi8(s.lead, 16), _mm256_extract_epi8(s.trail, 16),
+                   _mm256_extract_epi8(s.best, 16));
+    }
+    nistRunBytes64(data + i, bytes - i, state);
+    return std::max(state.longest, state.run);
+}
+
+// Rozgłasza ostatni (15.) element int16 na cały rejestr
+inline __m256i broadcastLast16(__m256i v) {
+    __m256i top = _mm256_permute4x64_epi64(v, 0xFF);
+    top = _mm256_shufflehi_epi16(top, 0xFF);
+    return _mm256_unpackhi_epi64(top, top);
+}
+
+} // namespace
+
+uint64_t nistOnesBytesAvx2(const unsigned char* data, size_t bytes) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(popcountBytes(v), _mm256_setzero_si256()));
+    }
+    return horizontalSum64(total) + nistOnesBytes64(data + i, bytes - i);
+}
+
+void nistBlockOnesBytesAvx2(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    size_t i = 0;
+    if (blockBytes == 16) {
+        // Cztery bloki na iterację: vpsadbw daje sumy połówek, unpack łączy połówki tego samego bloku
+        for (; i + 4 <= blocks; i += 4) {
+            const unsigned char* p = data + 16 * i;
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+            __m256i sumA = _mm256_sad_epu8(popcountBytes(a), _mm256_setzero_si256());
+            __m256i sumB = _mm256_sad_epu8(popcountBytes(b), _mm256_setzero_si256());
+            // [blok i, blok i + 2 | blok i + 1, blok i + 3]
+            __m256i sums = _mm256_add_epi64(_mm256_unpacklo_epi64(sumA, sumB), _mm256_unpackhi_epi64(sumA, sumB));
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+            out[i] = static_cast<uint32_t>(lanes[0]);
+            out[i + 1] = static_cast<uint32_t>(lanes[2]);
+            out[i + 2] = static_cast<uint32_t>(lanes[1]);
+            out[i + 3] = static_cast<uint32_t>(lanes[3]);
+        }
+    }
+    for (; i < blocks; i++) {
+        out[i] = static_cast<uint32_t>(nistOnesBytesAvx2(data + i * blockBytes, blockBytes));
+    }
+}
+
+uint64_t nistTransitionsBytesAvx2(const unsigned char* data, size_t bytes) {
+    // Bajt wyniku: (b ^ (b >> 1)) & 0x7F - pary w bajcie, ((b << 7) ^ następny) & 0x80 - para na granicy.
+    // Przesunięcia 16-bitowe przenoszą bity między bajtami tylko na pozycje zamaskowane.
+    const __m256i inner = _mm256_set1_epi8(0x7F);
+    const __m256i boundary = _mm256_set1_epi8(static_cast<char>(0x80));
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        __m256i within = _mm256_and_si256(_mm256_xor_si256(x, _mm256_srli_epi16(x, 1)), inner);
+        __m256i across = _mm256_and_si256(_mm256_xor_si256(_mm256_slli_epi16(x, 7), next), boundary);
+        __m256i t = _mm256_or_si256(within, across);
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(popcountBytes(t), _mm256_setzero_si256()));
+    }
+    return horizontalSum64(total) + nistTransitionsBytes64(data + i, bytes - i);
+}
+
+void nistWalkBytesAvx2(const unsigned char* data, size_t bytes, NistWalk& walk) {
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+    const __m128i deltaTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(NIBBLE_TABLES.delta));
+    const __m128i maxTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(NIBBLE_TABLES.maxPrefix));
+    const __m128i minTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(NIBBLE_TABLES.minPrefix));
+
+    const size_t chunks = bytes / 16;
+    size_t chunk = 0;
+    while (chunk < chunks) {
+        const size_t blockEnd = std::min(chunks, chunk + WALK_BLOCK_CHUNKS);
+        // Sumy względem początku bloku, po jednym kroku bajtowym na pas int16
+        __m256i carry = _mm256_setzero_si256();
+        __m256i blockMax = _mm256_set1_epi16(INT16_MIN);
+        __m256i blockMin = _mm256_set1_epi16(INT16_MAX);
+        for (; chunk < blockEnd; chunk++) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * chunk));
+            __m128i lo = _mm_and_si128(x, lowNibble);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), lowNibble);
+
+            // Bajt = starszy półbajt, potem młodszy
+            __m128i deltaHi = _mm_shuffle_epi8(deltaTable, hi);
+            __m128i delta8 = _mm_add_epi8(deltaHi, _mm_shuffle_epi8(deltaTable, lo));
+            __m128i max8 = _mm_max_epi8(_mm_shuffle_epi8(maxTable, hi),
+                                        _mm_add_epi8(deltaHi, _mm_shuffle_epi8(maxTable, lo)));
+            __m128i min8 = _mm_min_epi8(_mm_shuffle_epi8(minTable, hi),
+                                        _mm_add_epi8(deltaHi, _mm_shuffle_epi8(minTable, lo)));
+
+            // Sumy prefiksowe przyrostów 16 bajtów: w połówkach rejestru, potem przeniesienie dolnej
+            __m256i delta = _mm256_cvtepi8_epi16(delta8);
+            __m256i prefix = _mm256_add_epi16(delta, _mm256_slli_si256(delta, 2));
+            prefix = _mm256_add_epi16(prefix, _mm256_slli_si256(prefix, 4));
+            prefix = _mm256_add_epi16(prefix, _mm256_slli_si256(prefix, 8));
+            __m256i lowHalf = _mm256_permute2x128_si256(prefix, prefix, 0x08);
+            lowHalf = _mm256_shufflehi_epi16(lowHalf, 0xFF);
+            prefix = _mm256_add_epi16(prefix, _mm256_unpackhi_epi64(lowHalf, lowHalf));
+
+            __m256i before = _mm256_add_epi16(carry, _mm256_sub_epi16(prefix, delta));
+            blockMax = _mm256_max_epi16(blockMax, _mm256_add_epi16(before, _mm256_cvtepi8_epi16(max8)));
+            blockMin = _mm256_min_epi16(blockMin, _mm256_add_epi16(before, _mm256_cvtepi8_epi16(min8)));
+            carry = _mm256_add_epi16(carry, broadcastLast16(prefix));
+        }
+
+        alignas(32) int16_t maxLanes[16];
+        alignas(32) int16_t minLanes[16];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes), blockMax);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(minLanes), blockMin);
+        walk.maxSum = std::max<int64_t>(walk.maxSum, walk.sum + *std::max_element(maxLanes, maxLanes + 16));
+        walk.minSum = std::min<int64_t>(walk.minSum, walk.sum + *std::min_element(minLanes, minLanes + 16));
+        walk.sum += static_cast<int16_t>(_mm256_extract_epi16(carry, 0));
+    }
+    nistWalkBytes64(data + 16 * chunks, bytes - 16 * chunks, walk);
+}
+
+void nistSignsBytesAvx2(const unsigned char* data, size_t bytes, double* out) {
+    // Bajt rozgłaszany na 4 pasy 64-bitowe; pas z ustawionym bitem dostaje +1.0, pozostałe -1.0
+    const __m256i highBits = _mm256_setr_epi64x(0x80, 0x40, 0x20, 0x10);
+    const __m256i lowBits = _mm256_setr_epi64x(0x08, 0x04, 0x02, 0x01);
+    const __m256d plus = _mm256_set1_pd(1.0);
+    const __m256d minus = _mm256_set1_pd(-1.0);
+    for (size_t i = 0; i < bytes; i++) {
+        __m256i b = _mm256_set1_epi64x(data[i]);
+        __m256d high = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(b, highBits), highBits));
+        __m256d low = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(b, lowBits), lowBits));
+        _mm256_storeu_pd(out + 8 * i, _mm256_blendv_pd(minus, plus, high));
+        _mm256_storeu_pd(out + 8 * i + 4, _mm256_blendv_pd(minus, plus, low));
+    }
+}
+
+void nistLongestRunsBytesAvx2(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out) {
+    if (blockBytes == 16) {
+        longestRunsLanes(data, blocks, out);
+    } else if (blockBytes < 32) {
+        nistLongestRunsBytes64(data, blockBytes, blocks, out);
+    } else {
+        for (size_t i = 0; i < blocks; i++) {
+            out[i] = static_cast<uint32_t>(longestRunSpan(data + i * blockBytes, blockBytes));
+        }
+    }
+}
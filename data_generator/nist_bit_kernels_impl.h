@@ -0,0 +1,45 @@
+#ifndef NIST_BIT_KERNELS_IMPL_H
+#define NIST_BIT_KERNELS_IMPL_H
+
+/**
+ * Wewnętrzne jądra nist_bit_kernels dla kolejnych zestawów instrukcji. Wszystkie działają
+ * na pełnych bajtach od bitu 0; ogony krótsze niż bajt obsługuje nist_bit_kernels.cpp.
+ */
+
+#include "nist_bit_kernels.h"
+
+// Seria jedynek trwająca na końcu przetworzonych danych i najdłuższa dotąd zakończona
+struct NistRunState {
+    size_t run = 0;
+    size_t longest = 0;
+};
+
+// Jedynki w `bytes` bajtach
+uint64_t nistOnesBytes64(const unsigned char* data, size_t bytes);
+uint64_t nistOnesBytesAvx2(const unsigned char* data, size_t bytes);
+
+// Jedynki w `blocks` blokach po `blockBytes` bajtów; out[i] - blok i
+void nistBlockOnesBytes64(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+void nistBlockOnesBytesAvx2(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+
+// Przejścia w bajtach [0, bytes), łącznie z parą (ostatni bit bajtu, pierwszy bit następnego);
+// czyta więc także data[bytes]
+uint64_t nistTransitionsBytes64(const unsigned char* data, size_t bytes);
+uint64_t nistTransitionsBytesAvx2(const unsigned char* data, size_t bytes);
+
+// Kontynuuje błądzenie `walk` o 8 * bytes kroków
+void nistWalkBytes64(const unsigned char* data, size_t bytes, NistWalk& walk);
+void nistWalkBytesAvx2(const unsigned char* data, size_t bytes, NistWalk& walk);
+
+// Kontynuuje serie `state` o `bytes` bajtów (tablice per bajt)
+void nistRunBytes64(const unsigned char* data, size_t bytes, NistRunState& state);
+
+// Najdłuższe serie jedynek w `blocks` blokach po `blockBytes` bajtów
+void nistLongestRunsBytes64(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+void nistLongestRunsBytesAvx2(const unsigned char* data, size_t blockBytes, size_t blocks, uint32_t* out);
+
+// Próbki +1.0 / -1.0 dla 8 * bytes bitów
+void nistSignsBytes64(const unsigned char* data, size_t bytes, double* out);
+void nistSignsBytesAvx2(const unsigned char* data, size_t bytes, double* out);
+
+#endif // NIST_BIT_KERNELS_IMPL_H
@@ -0,0 +1,267 @@
+#include "nist_fft.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// Czynniki pierwsze większe od tego progu liczone są algorytmem Bluesteina
+const size_t MAX_RADIX = 64;
+
+const size_t BUFFER_ALIGNMENT = 64;
+
+// Iloczyn liczb zespolonych bez obsługi NaN/Inf, którą GCC dokłada do std::complex
+// (wywołanie __muldc3 bez -ffast-math)
+inline FftComplex mul(FftComplex a, FftComplex b) {
+    return FftComplex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+// Mnożenie przez -i
+inline FftComplex mulMinusI(FftComplex a) {
+    return FftComplex(a.imag(), -a.real());
+}
+
+// exp(-2*pi*i*k/n); k redukowane modulo n dla dokładności kąta
+FftComplex unitRoot(uint64_t k, uint64_t n) {
+    return std::polar(1.0, -2.0 * PI * static_cast<double>(k % n) / static_cast<double>(n));
+}
+
+// Podstawy etapów: najpierw czwórki, potem co najwyżej jedna dwójka i nieparzyste czynniki pierwsze
+std::vector<size_t> factorize(size_t n) {
+    std::vector<size_t> factors;
+    while (n % 4 == 0) {
+        factors.push_back(4);
+        n /= 4;
+    }
+    if (n % 2 == 0) {
+        factors.push_back(2);
+        n /= 2;
+    }
+    for (size_t p = 3; p * p <= n; p += 2) {
+        while (n % p == 0) {
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+    if (n > 1) {
+        factors.push_back(n);
+    }
+    return factors;
+}
+
+} // namespace
+
+void* FftWorkspace::buffer(size_t index, size_t bytes) {
+    if (capacity[index] < bytes) {
+        size_t rounded = (bytes + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+        buffers[index].reset(static_cast<unsigned char*>(std::aligned_alloc(BUFFER_ALIGNMENT, rounded)));
+        capacity[index] = buffers[index] ? rounded : 0;
+    }
+    return buffers[index].get();
+}
+
+FftComplex* FftWorkspace::complexBuffer(size_t index, size_t count) {
+    return static_cast<FftComplex*>(buffer(index, count * sizeof(FftComplex)));
+}
+
+double* FftWorkspace::realBuffer(size_t index, size_t count) {
+    return static_cast<double*>(buffer(index, count * sizeof(double)));
+}
+
+ComplexFftPlan::ComplexFftPlan(size_t n) : n(n) {
+    if (n <= 1) {
+        return;
+    }
+    std::vector<size_t> factors = factorize(n);
+    if (factors.back() > MAX_RADIX) {
+        // Splot z chirpem liczony FFT o długości potęgi dwójki >= 2n - 1
+        size_t size = 1;
+        while (size < 2 * n - 1) {
+            size <<= 1;
+        }
+        inner = std::make_unique<ComplexFftPlan>(size);
+        chirp.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            uint64_t k2 = static_cast<uint64_t>(k) * k % (2 * n);
+            chirp[k] = unitRoot(k2, 2 * n);
+        }
+        chirpFft.assign(size, FftComplex(0.0, 0.0));
+        chirpFft[0] = std::conj(chirp[0]);
+        for (size_t k = 1; k < n; k++) {
+            chirpFft[k] = chirpFft[size - k] = std::conj(chirp[k]);
+        }
+        FftWorkspace workspace;
+        inner->forward(chirpFft.data(), workspace);
+        return;
+    }
+
+    size_t stride = 1;
+    for (size_t radix : factors) {
+        Stage stage;
+        stage.radix = radix;
+        stage.stride = stride;
+        const size_t length = n / stride;
+        const size_t m = length / radix;
+        stage.twiddles.resize(m * (radix - 1));
+        for (size_t j = 0; j < m; j++) {
+            for (size_t t = 1; t < radix; t++) {
+                stage.twiddles[j * (radix - 1) + t - 1] = unitRoot(static_cast<uint64_t>(j) * t, length);
+            }
+        }
+        if (radix != 2 && radix != 4) {
+            stage.roots.resize(radix);
+            for (size_t r = 0; r < radix; r++) {
+                stage.roots[r] = unitRoot(r, radix);
+            }
+        }
+        stages.push_back(std::move(stage));
+        stride *= radix;
+    }
+}
+
+void ComplexFftPlan::forward(FftComplex* data, FftWorkspace& workspace) const {
+    if (inner) {
+        bluestein(data, workspace);
+    } else if (!stages.empty()) {
+        stockham(data, workspace.complexBuffer(0, n));
+    }
+}
+
+void ComplexFftPlan::stockham(FftComplex* data, FftComplex* work) const {
+    // Etap o podstawie p: dla długości len = n / s i m = len / p (s = iloczyn poprzednich podstaw)
+    //   y[q + s*(p*j + t)] = w^(j*t) * sum_r x[q + s*(j + r*m)] * exp(-2*pi*i*r*t/p)
+    // Wynik kolejnych etapów przeplata się między data i work, kolejność wyjścia jest naturalna.
+    FftComplex* x = data;
+    FftComplex* y = work;
+    for (const Stage& stage : stages) {
+        const size_t p = stage.radix;
+        const size_t s = stage.stride;
+        const size_t m = n / (s * p);
+        const FftComplex* twiddles = stage.twiddles.data();
+
+        if (p == 2) {
+            for (size_t j = 0; j < m; j++) {
+                const FftComplex w = twiddles[j];
+                for (size_t q = 0; q < s; q++) {
+                    FftComplex a = x[q + s * j];
+                    FftComplex b = x[q + s * (j + m)];
+                    y[q + s * (2 * j)] = a + b;
+                    y[q + s * (2 * j + 1)] = mul(a - b, w);
+                }
+            }
+        } else if (p == 4) {
+            for (size_t j = 0; j < m; j++) {
+                const FftComplex w1 = twiddles[3 * j], w2 = twiddles[3 * j + 1], w3 = twiddles[3 * j + 2];
+                for (size_t q = 0; q < s; q++) {
+                    FftComplex a0 = x[q + s * j];
+                    FftComplex a1 = x[q + s * (j + m)];
+                    FftComplex a2 = x[q + s * (j + 2 * m)];
+                    FftComplex a3 = x[q + s * (j + 3 * m)];
+                    FftComplex t0 = a0 + a2, t1 = a0 - a2;
+                    FftComplex t2 = a1 + a3, t3 = mulMinusI(a1 - a3);
+                    FftComplex* out = y + q + s * (4 * j);
+                    out[0] = t0 + t2;
+                    out[s] = mul(t1 + t3, w1);
+                    out[2 * s] = mul(t0 - t2, w2);
+                    out[3 * s] = mul(t1 - t3, w3);
+                }
+            }
+        } else {
+            const FftComplex* roots = stage.roots.data();
+            FftComplex a[MAX_RADIX];
+            for (size_t j = 0; j < m; j++) {
+                const FftComplex* w = twiddles + j * (p - 1);
+                for (size_t q = 0; q < s; q++) {
+                    for (size_t r = 0; r < p; r++) {
+                        a[r] = x[q + s * (j + r * m)];
+                    }
+                    FftComplex* out = y + q + s * (p * j);
+                    for (size_t t = 0; t < p; t++) {
+                        FftComplex sum = a[0];
+                        // rt = r*t mod p
+                        for (size_t r = 1, rt = t; r < p; r++) {
+                            sum += mul(a[r], roots[rt]);
+                            rt += t;
+                            if (rt >= p) {
+                                rt -= p;
+                            }
+                        }
+                        out[s * t] = t == 0 ? sum : mul(sum, w[t - 1]);
+                    }
+                }
+            }
+        }
+        std::swap(x, y);
+    }
+    if (x != data) {
+        std::copy(x, x + n, data);
+    }
+}
+
+void ComplexFftPlan::bluestein(FftComplex* data, FftWorkspace& workspace) const {
+    const size_t size = inner->size();
+    FftComplex* a = workspace.complexBuffer(1, size);
+    for (size_t k = 0; k < n; k++) {
+        a[k] = mul(data[k], chirp[k]);
+    }
+    std::fill(a + n, a + size, FftComplex(0.0, 0.0));
+    inner->forward(a, workspace);
+    // Splot w dziedzinie częstotliwości, odwrotna FFT przez sprzężenie
+    for (size_t k = 0; k < size; k++) {
+        a[k] = std::conj(mul(a[k], chirpFft[k]));
+    }
+    inner->forward(a, workspace);
+    const double scale = 1.0 / static_cast<double>(size);
+    for (size_t k = 0; k < n; k++) {
+        data[k] = mul(chirp[k], std::conj(a[k])) * scale;
+    }
+}
+
+RealFftPlan::RealFftPlan(size_t n) : n(n), complexPlan(n % 2 == 0 ? n / 2 : n) {
+    if (n % 2 == 0) {
+        postTwiddles.resize(n / 2 + 1);
+        for (size_t k = 0; k <= n / 2; k++) {
+            postTwiddles[k] = unitRoot(k, n);
+        }
+    }
+}
+
+double* RealFftPlan::signal(FftWorkspace& workspace) const {
+    // Parzyste n: próbki parami jako n/2 liczb zespolonych; nieparzyste: miejsce na rozszerzenie do n
+    size_t complexCount = n % 2 == 0 ? n / 2 : n;
+    return reinterpret_cast<double*>(workspace.complexBuffer(2, complexCount));
+}
+
+void RealFftPlan::magnitudes(FftWorkspace& workspace, double* out, size_t count) const {
+    if (n == 0) {
+        return;
+    }
+    if (n % 2 != 0) {
+        FftComplex* data = workspace.complexBuffer(2, n);
+        double* samples = reinterpret_cast<double*>(data);
+        // Rozszerzenie w miejscu od końca: element k zajmuje pozycje 2k, 2k+1 >= k
+        for (size_t k = n; k-- > 0;) {
+            data[k] = FftComplex(samples[k], 0.0);
+        }
+        complexPlan.forward(data, workspace);
+        for (size_t k = 0; k < count; k++) {
+            out[k] = std::sqrt(data[k].real() * data[k].real() + data[k].imag() * data[k].imag());
+        }
+        return;
+    }
+
+    // z_j = x_2j + i*x_2j+1; X_k = E_k + exp(-2*pi*i*k/n) * O_k, gdzie E/O to FFT próbek parzystych/nieparzystych
+    const size_t half = n / 2;
+    FftComplex* z = workspace.complexBuffer(2, half);
+    complexPlan.forward(z, workspace);
+    for (size_t k = 0; k < count; k++) {
+        FftComplex zk = z[k % half];
+        FftComplex zc = std::conj(z[(half - k % half) % half]);
+        FftComplex even = (zk + zc) * 0.5;
+        FftComplex odd = mul(zk - zc, FftComplex(0.0, -0.5));
+        FftComplex value = even + mul(postTwiddles[k], odd);
+        out[k] = std::sqrt(value.real() * value.real() + value.imag() * value.imag());
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef NIST_FFT_H
+#define NIST_FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+/**
+ * Planowana FFT dla testu spektralnego NIST (DFT), bez zewnętrznych bibliotek.
+ *
+ * Plan budowany jest raz dla danej długości i potem tylko czytany, więc jeden plan
+ * obsługuje wszystkie strumienie i wątki. Długość rozkładana jest na czynniki 4, 2, 3, 5, ...
+ * (FFT Stockhama o mieszanej podstawie - bez permutacji bit-reverse, z gotowymi tablicami
+ * twiddle dla każdego etapu); gdy zostaje czynnik pierwszy > 64, plan używa algorytmu
+ * Bluesteina z zapamiętanym chirpem i jego transformatą. Sygnał rzeczywisty długości
+ * parzystej liczony jest jako zespolony o połowie długości.
+ *
+ * Wszystkie bufory robocze należą do FftWorkspace - po jednym na wątek, wyrównane do 64 bajtów
+ * i używane ponownie dla kolejnych strumieni.
+ */
+
+using FftComplex = std::complex<double>;
+
+class FftWorkspace {
+public:
+    // Bufor `index` (0..BUFFER_COUNT-1) o pojemności co najmniej `count` elementów
+    FftComplex* complexBuffer(size_t index, size_t count);
+    double* realBuffer(size_t index, size_t count);
+
+    static constexpr size_t BUFFER_COUNT = 4;
+
+private:
+    struct FreeDeleter {
+        void operator()(void* pointer) const { std::free(pointer); }
+    };
+    std::unique_ptr<unsigned char, FreeDeleter> buffers[BUFFER_COUNT];
+    size_t capacity[BUFFER_COUNT] = {};
+
+    void* buffer(size_t index, size_t bytes);
+};
+
+class ComplexFftPlan {
+public:
+    explicit ComplexFftPlan(size_t n);
+
+    size_t size() const { return n; }
+
+    // Transformata w przód (exp(-2*pi*i*jk/n)) w miejscu; używa buforów 0-1 `workspace`
+    void forward(FftComplex* data, FftWorkspace& workspace) const;
+
+private:
+    struct Stage {
+        size_t radix;
+        size_t stride;                      // iloczyn podstaw poprzednich etapów
+        std::vector<FftComplex> twiddles;   // [j * (radix-1) + t-1] = w^(j*t), w = exp(-2*pi*i/długość)
+        std::vector<FftComplex> roots;      // pierwiastki z jedności stopnia radix (ogólna podstawa)
+    };
+
+    size_t n;
+    std::vector<Stage> stages;
+
+    // Bluestein: chirp[k] = exp(-i*pi*k^2/n) i FFT ciągu sprzężonego chirpu długości inner->size()
+    std::unique_ptr<ComplexFftPlan> inner;
+    std::vector<FftComplex> chirp;
+    std::vector<FftComplex> chirpFft;
+
+    void stockham(FftComplex* data, FftComplex* work) const;
+    void bluestein(FftComplex* data, FftWorkspace& workspace) const;
+};
+
+class RealFftPlan {
+public:
+    explicit RealFftPlan(size_t n);
+
+    size_t size() const { return n; }
+
+    // Bufor na n próbek sygnału (w `workspace`, bufor 2); tu wpisuje się wejście transformaty
+    double* signal(FftWorkspace& workspace) const;
+
+    // |X_k| dla k = 0..count-1 (count <= n/2 + 1) sygnału z signal(); niszczy sygnał, używa buforów 0-2
+    void magnitudes(FftWorkspace& workspace, double* out, size_t count) const;
+
+private:
+    size_t n;
+    ComplexFftPlan complexPlan;             // n/2 dla parzystego n, n dla nieparzystego
+    std::vector<FftComplex> postTwiddles;   // exp(-2*pi*i*k/n), k = 0..n/2
+};
+
+#endif // NIST_FFT_H
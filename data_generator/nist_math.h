@@ -0,0 +1,21 @@
+#ifndef NIST_MATH_H
+#define NIST_MATH_H
+
+/**
+ * Funkcje specjalne używane przez testy NIST STS (odpowiedniki cephes_* z implementacji
+ * referencyjnej sts-2.1.2): niepełna funkcja gamma i dystrybuanta rozkładu normalnego.
+ */
+
+// Regularyzowana górna niepełna funkcja gamma Q(a, x) = 1 - P(a, x)
+double nistIgamc(double a, double x);
+
+// Regularyzowana dolna niepełna funkcja gamma P(a, x)
+double nistIgam(double a, double x);
+
+// Dystrybuanta standardowego rozkładu normalnego
+double nistNormal(double x);
+
+// p-wartość testu Kołmogorowa-Smirnowa dla statystyki D i n obserwacji
+double nistKolmogorovPValue(double d, double n);
+
+#endif // NIST_MATH_H
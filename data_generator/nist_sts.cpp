@@ -0,0 +1,371 @@
+#include "nist_sts.h"
+#include "dataset_view.h"
+#include "nist_bit_kernels.h"
+#include "nist_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char* const TEST_NAMES[NIST_TEST_COUNT] = {
+    "Frequency", "BlockFrequency", "CumulativeSums", "Runs", "LongestRun",
+    "Rank", "FFT", "NonOverlappingTemplate", "OverlappingTemplate", "Universal",
+    "ApproximateEntropy", "RandomExcursions", "RandomExcursionsVariant", "Serial", "LinearComplexity"};
+
+// Liczba p-wartości zwracanych przez test (wiersze w analizie zbiorczej)
+size_t statisticCount(NistTestId test, const NistParameters& parameters) {
+    switch (test) {
+        case NIST_CUMULATIVE_SUMS:
+        case NIST_SERIAL:
+            return 2;
+        case NIST_NON_OVERLAPPING_TEMPLATE:
+            return nistAperiodicTemplates(parameters.nonOverlappingTemplateLength).size();
+        case NIST_RANDOM_EXCURSIONS:
+            return 8;
+        case NIST_RANDOM_EXCURSIONS_VARIANT:
+            return 18;
+        default:
+            return 1;
+    }
+}
+
+bool isRandomExcursion(NistTestId test) {
+    return test == NIST_RANDOM_EXCURSIONS || test == NIST_RANDOM_EXCURSIONS_VARIANT;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            escaped += buffer;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeJsonNumber(std::ostream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+} // namespace
+
+const char* nistTestName(NistTestId test) {
+    return test < NIST_TEST_COUNT ? TEST_NAMES[test] : "Unknown";
+}
+
+bool NistOptions::setTestMask(const std::string& mask) {
+    if (mask.size() != NIST_TEST_COUNT || mask.find_first_not_of("01") != std::string::npos) {
+        return false;
+    }
+    for (size_t i = 0; i < NIST_TEST_COUNT; i++) {
+        tests[i] = mask[i] == '1';
+    }
+    return true;
+}
+
+size_t NistReport::sampleSize(NistTestId test) const {
+    size_t count = 0;
+    for (const NistStreamResult& stream : streams) {
+        if (!stream.pValues[test].empty()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+double NistReport::minPassRate(size_t sampleSize) const {
+    if (sampleSize == 0) {
+        return 0.0;
+    }
+    double pHat = 1.0 - alpha;
+    return pHat - 3.0 * std::sqrt(pHat * alpha / static_cast<double>(sampleSize));
+}
+
+void NistReport::printFinalAnalysis(std::ostream& out) const {
+    const std::string separator(78, '-');
+    size_t excursionSample = sampleSize(NIST_RANDOM_EXCURSIONS);
+
+    out << separator << "\n"
+        << "RESULTS FOR THE UNIFORMITY OF P-VALUES AND THE PROPORTION OF PASSING SEQUENCES\n"
+        << separator << "\n"
+        << "   generator is <" << generator << ">\n"
+        << separator << "\n"
+        << " C1  C2  C3  C4  C5  C6  C7  C8  C9 C10  P-VALUE  P-value(KS) PROPORTION  STATISTICAL TEST\n"
+        << separator << "\n";
+
+    for (const NistSummaryRow& row : rows) {
+        for (size_t count : row.histogram) {
+            out << std::setw(4) << count;
+        }
+        if (row.dataAvailable()) {
+            out << std::fixed << std::setprecision(6)
+                << "  " << row.uniformityPValue << (row.uniformityPassed() ? "  " : " *")
+                << "  " << row.ksPValue << (row.ksPassed() ? "  " : " *")
+                << std::setprecision(4)
+                << "  " << row.proportion << (row.proportionPassed() ? "  " : " *");
+        } else {
+            out << "    ----        ----        ----  ";
+        }
+        out << "  " << nistTestName(row.test) << "\n";
+    }
+
+    out << separator << "\n" << std::fixed << std::setprecision(6)
+        << "The minimum pass rate for each statistical test with the exception of the\n"
+        << "random excursion (variant) test is approximately = " << minPassRate(streams.size())
+        << " for a\nsample size = " << streams.size() << " binary sequences.\n\n"
+        << "The minimum pass rate for the random excursion (variant) test\n"
+        << "is approximately = " << minPassRate(excursionSample)
+        << " for a sample size = " << excursionSample << " binary sequences.\n"
+        << separator << "\n";
+}
+
+bool NistReport::saveJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Błąd: Nie można otworzyć pliku " << path << std::endl;
+        return false;
+    }
+    out << std::setprecision(10);
+
+    size_t excursionSample = sampleSize(NIST_RANDOM_EXCURSIONS);
+    out << "{\n"
+        << "  \"generator\": \"" << jsonEscape(generator) << "\",\n"
+        << "  \"stream_bits\": " << streamBits << ",\n"
+        << "  \"alpha\": " << alpha << ",\n"
+        << "  \"sample_size\": " << streams.size() << ",\n"
+        << "  \"sample_size_random_excursion\": " << excursionSample << ",\n"
+        << "  \"min_pass_rate\": " << minPassRate(streams.size()) << ",\n"
+        << "  \"min_pass_rate_random_excursion\": " << minPassRate(excursionSample) << ",\n"
+        << "  \"tests\": [";
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const NistSummaryRow& row = rows[i];
+        out << (i ? ",\n" : "\n") << "    {\"test_name\": \"" << nistTestName(row.test) << "\", "
+            << "\"statistic\": " << row.statistic << ", \"c1_c10\": [";
+        for (size_t j = 0; j < row.histogram.size(); j++) {
+            out << (j ? ", " : "") << row.histogram[j];
+        }
+        out << "], ";
+        if (row.dataAvailable()) {
+            out << "\"p_value_uniformity\": ";
+            writeJsonNumber(out, row.uniformityPValue);
+            out << ", \"p_value_uniformity_passed\": " << (row.uniformityPassed() ? "true" : "false")
+                << ", \"p_value_ks\": ";
+            writeJsonNumber(out, row.ksPValue);
+            out << ", \"p_value_ks_passed\": " << (row.ksPassed() ? "true" : "false")
+                << ", \"proportion\": ";
+            writeJsonNumber(out, row.proportion);
+            out << ", \"proportion_passed\": " << (row.proportionPassed() ? "true" : "false")
+                << ", \"data_available\": true}";
+        } else {
+            out << "\"p_value_uniformity\": null, \"p_value_uniformity_passed\": null, "
+                << "\"p_value_ks\": null, \"p_value_ks_passed\": null, "
+                << "\"proportion\": null, \"proportion_passed\": null, \"data_available\": false}";
+        }
+    }
+    out << "\n  ],\n  \"sequences\": [";
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        out << (i ? ",\n" : "\n") << "    {\"bitsread\": " << streamBits << ", \"zeros\": "
+            << streamBits - streams[i].ones << ", \"ones\": " << streams[i].ones << "}";
+    }
+    out << "\n  ]\n}\n";
+
+    out.close();
+    if (!out) {
+        std::cerr << "Błąd przy zapisie do pliku " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+NistTestSuite::NistTestSuite(const NistOptions& options)
+    : options(options), pool(options.threads), workerBits(pool.workerCount()), workerPacked(pool.workerCount()),
+      workerFft(pool.workerCount()) {
+    // Jeden plan FFT na długość strumienia, współdzielony przez wszystkie wątki
+    if (options.tests[NIST_FFT]) {
+        fftPlan = std::make_unique<RealFftPlan>(options.streamBits);
+    }
+}
+
+bool NistTestSuite::runFile(const std::string& path, NistReport& report) {
+    // Mapowanie z MADV_SEQUENTIAL - strumienie czytane są mniej więcej po kolei
+    DatasetView input;
+    if (!input.open(path)) {
+        return false;
+    }
+    if (input.size() == 0) {
+        std::cerr << "Błąd: Pusty plik " << path << std::endl;
+        return false;
+    }
+
+    report.generator = path;
+    return runBuffer(input.data(), static_cast<size_t>(input.size()), report);
+}
+
+bool NistTestSuite::runBuffer(const unsigned char* data, size_t sizeBytes, NistReport& report) {
+    const uint64_t availableBits = static_cast<uint64_t>(sizeBytes) * 8;
+    const size_t streamBits = options.streamBits;
+    if (streamBits == 0) {
+        std::cerr << "Błąd: Długość strumienia musi być > 0" << std::endl;
+        return false;
+    }
+    size_t streamCount = options.streamCount;
+    if (streamCount == 0) {
+        streamCount = static_cast<size_t>(availableBits / streamBits);
+    }
+    if (streamCount == 0 || static_cast<uint64_t>(streamCount) * streamBits > availableBits) {
+        std::cerr << "Błąd: Za mało danych na " << (streamCount ? streamCount : 1) << " strumieni po "
+                  << streamBits << " bitów" << std::endl;
+        return false;
+    }
+
+    report.streamBits = streamBits;
+    report.alpha = options.alpha;
+    report.streams.assign(streamCount, NistStreamResult());
+
+    // Strumienie są niezależne - każdy to osobne zadanie, wynik pod jego indeksem
+    for (size_t i = 0; i < streamCount; i++) {
+        pool.submit([this, data, i, &report](size_t worker) {
+            report.streams[i] = testStream(data, static_cast<uint64_t>(i) * options.streamBits, worker);
+        });
+    }
+    pool.wait();
+
+    summarize(report);
+    return true;
+}
+
+NistStreamResult NistTestSuite::testStream(const unsigned char* data, uint64_t bitOffset, size_t worker) {
+    const size_t n = options.streamBits;
+    const NistParameters& par = options.parameters;
+
+    // Testy z jądrami słowowymi liczą się na bitach spakowanych; strumień nie zaczynający się
+    // od granicy bajtu jest najpierw wyrównywany
+    const unsigned char* packed = data + (bitOffset >> 3);
+    if (bitOffset & 7) {
+        workerPacked[worker].resize((n + 7) / 8);
+        nistCopyPackedBits(data, bitOffset, n, workerPacked[worker].data());
+        packed = workerPacked[worker].data();
+    }
+
+    NistStreamResult result;
+    result.ones = nistPackedOnes(packed, 0, n);
+
+    auto run = [&](NistTestId test, auto&& function) {
+        if (options.tests[test]) {
+            result.pValues[test] = function();
+        }
+    };
+    run(NIST_FREQUENCY, [&] { return nistFrequencyPacked(packed, n); });
+    run(NIST_BLOCK_FREQUENCY, [&] { return nistBlockFrequencyPacked(packed, n, par.blockFrequencyBlockLength); });
+    run(NIST_CUMULATIVE_SUMS, [&] { return nistCumulativeSumsPacked(packed, n); });
+    run(NIST_RUNS, [&] { return nistRunsPacked(packed, n); });
+    run(NIST_LONGEST_RUN, [&] { return nistLongestRunOfOnesPacked(packed, n); });
+    run(NIST_RANK, [&] { return nistRankPacked(packed, n); });
+    run(NIST_FFT, [&] { return nistDiscreteFourierTransformPacked(packed, n, *fftPlan, workerFft[worker]); });
+    run(NIST_NON_OVERLAPPING_TEMPLATE,
+        [&] { return nistNonOverlappingTemplateMatchingsPacked(packed, n, par.nonOverlappingTemplateLength); });
+    run(NIST_OVERLAPPING_TEMPLATE,
+        [&] { return nistOverlappingTemplateMatchingsPacked(packed, n, par.overlappingTemplateLength); });
+    run(NIST_LINEAR_COMPLEXITY,
+        [&] { return nistLinearComplexityPacked(packed, n, par.linearComplexityBlockLength); });
+
+    std::bitset<NIST_TEST_COUNT> unpackedTests = options.tests;
+    for (NistTestId test : {NIST_FREQUENCY, NIST_BLOCK_FREQUENCY, NIST_CUMULATIVE_SUMS, NIST_RUNS, NIST_LONGEST_RUN,
+                            NIST_RANK, NIST_FFT, NIST_NON_OVERLAPPING_TEMPLATE, NIST_OVERLAPPING_TEMPLATE,
+                            NIST_LINEAR_COMPLEXITY}) {
+        unpackedTests[test] = false;
+    }
+    if (unpackedTests.none()) {
+        return result;
+    }
+
+    // Pozostałe testy działają na jednym bicie na bajt
+    std::vector<unsigned char>& bits = workerBits[worker];
+    bits.resize(n);
+    for (size_t j = 0; j < n; j++) {
+        bits[j] = (packed[j >> 3] >> (7 - (j & 7))) & 1;
+    }
+    const unsigned char* epsilon = bits.data();
+
+    run(NIST_UNIVERSAL, [&] { return nistUniversal(epsilon, n); });
+    run(NIST_APPROXIMATE_ENTROPY,
+        [&] { return nistApproximateEntropy(epsilon, n, par.approximateEntropyBlockLength); });
+    run(NIST_RANDOM_EXCURSIONS, [&] { return nistRandomExcursions(epsilon, n); });
+    run(NIST_RANDOM_EXCURSIONS_VARIANT, [&] { return nistRandomExcursionsVariant(epsilon, n); });
+    run(NIST_SERIAL, [&] { return nistSerial(epsilon, n, par.serialBlockLength); });
+    return result;
+}
+
+void NistTestSuite::summarize(NistReport& report) const {
+    report.rows.clear();
+    size_t excursionSample = report.sampleSize(NIST_RANDOM_EXCURSIONS);
+
+    for (size_t t = 0; t < NIST_TEST_COUNT; t++) {
+        NistTestId test = static_cast<NistTestId>(t);
+        if (!options.tests[test]) {
+            continue;
+        }
+        for (size_t statistic = 0; statistic < statisticCount(test, options.parameters); statistic++) {
+            NistSummaryRow row;
+            row.test = test;
+            row.statistic = statistic;
+
+            std::vector<double> pValues;
+            for (const NistStreamResult& stream : report.streams) {
+                if (statistic < stream.pValues[test].size()) {
+                    pValues.push_back(stream.pValues[test][statistic]);
+                }
+            }
+            row.sampleSize = pValues.size();
+            row.minPassRate = report.minPassRate(isRandomExcursion(test) ? excursionSample : report.streams.size());
+            if (pValues.empty()) {
+                report.rows.push_back(row);
+                continue;
+            }
+
+            // Rozkład p-wartości w 10 przedziałach i test chi-kwadrat jednorodności
+            for (double p : pValues) {
+                size_t bin = std::min<size_t>(9, static_cast<size_t>(std::max(0.0, std::floor(p * 10))));
+                row.histogram[bin]++;
+                if (p >= report.alpha) {
+                    row.passed++;
+                }
+            }
+            double expected = pValues.size() / 10.0;
+            double chi2 = 0.0;
+            for (size_t count : row.histogram) {
+                chi2 += (count - expected) * (count - expected) / expected;
+            }
+            row.uniformityPValue = nistIgamc(9.0 / 2.0, chi2 / 2.0);
+
+            // Test Kołmogorowa-Smirnowa zgodności z rozkładem jednostajnym
+            std::sort(pValues.begin(), pValues.end());
+            double d = 0.0;
+            const double count = static_cast<double>(pValues.size());
+            for (size_t i = 0; i < pValues.size(); i++) {
+                d = std::max(d, std::max((i + 1) / count - pValues[i], pValues[i] - i / count));
+            }
+            row.ksPValue = nistKolmogorovPValue(d, count);
+
+            row.proportion = row.passed / count;
+            report.rows.push_back(row);
+        }
+    }
+}
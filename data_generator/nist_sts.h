@@ -0,0 +1,131 @@
+#ifndef NIST_STS_H
+#define NIST_STS_H
+
+#include "nist_tests.h"
+#include "work_stealing_pool.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Natywny odpowiednik programu assess (NIST STS) działający w procesie.
+ *
+ * Plik wejściowy jest mapowany do pamięci i dzielony na strumienie po streamBits
+ * bitów (bity od najstarszego w bajcie, jak --binary w assess). Strumienie są
+ * testowane równolegle na puli wątków, a wyniki wracają jako struktury:
+ * p-wartości każdego strumienia oraz wiersze zbiorczej analizy (rozkład p-wartości
+ * w 10 przedziałach, p-wartość jednorodności, p-wartość KS i odsetek sekwencji
+ * przechodzących) - te same, które assess zapisuje w finalAnalysisReport.txt.
+ */
+
+// Testy w kolejności maski --tests assess
+enum NistTestId : size_t {
+    NIST_FREQUENCY = 0,
+    NIST_BLOCK_FREQUENCY,
+    NIST_CUMULATIVE_SUMS,
+    NIST_RUNS,
+    NIST_LONGEST_RUN,
+    NIST_RANK,
+    NIST_FFT,
+    NIST_NON_OVERLAPPING_TEMPLATE,
+    NIST_OVERLAPPING_TEMPLATE,
+    NIST_UNIVERSAL,
+    NIST_APPROXIMATE_ENTROPY,
+    NIST_RANDOM_EXCURSIONS,
+    NIST_RANDOM_EXCURSIONS_VARIANT,
+    NIST_SERIAL,
+    NIST_LINEAR_COMPLEXITY,
+    NIST_TEST_COUNT
+};
+
+// Nazwa testu jak w finalAnalysisReport.txt
+const char* nistTestName(NistTestId test);
+
+struct NistOptions {
+    size_t streamBits = 8 * 1024 * 1024;   // 1 MB na strumień
+    size_t streamCount = 0;                // 0 = tyle strumieni, ile mieści plik
+    std::bitset<NIST_TEST_COUNT> tests = std::bitset<NIST_TEST_COUNT>().set();
+    NistParameters parameters;
+    double alpha = 0.01;
+    size_t threads = 0;                    // 0 = wszystkie rdzenie
+
+    // Maska jak --tests assess, np. "111111111111111"; false przy niepoprawnej masce
+    bool setTestMask(const std::string& mask);
+};
+
+// Wyniki jednego strumienia
+struct NistStreamResult {
+    size_t ones = 0;
+    // p-wartości każdego testu; pusty wektor = test pominięty albo bez zastosowania
+    std::array<std::vector<double>, NIST_TEST_COUNT> pValues;
+};
+
+// Wiersz analizy zbiorczej: jedna statystyka testu (np. jeden szablon) dla wszystkich strumieni
+struct NistSummaryRow {
+    NistTestId test = NIST_FREQUENCY;
+    size_t statistic = 0;                  // indeks p-wartości w teście
+    std::array<size_t, 10> histogram{};    // C1..C10
+    size_t sampleSize = 0;                 // strumienie, dla których test miał zastosowanie
+    size_t passed = 0;                     // p-wartość >= alpha
+    double uniformityPValue = 0.0;
+    double ksPValue = 0.0;
+    double proportion = 0.0;
+    double minPassRate = 0.0;
+
+    bool dataAvailable() const { return sampleSize > 0; }
+    bool uniformityPassed() const { return uniformityPValue >= 0.0001; }
+    bool ksPassed() const { return ksPValue >= 0.0001; }
+    bool proportionPassed() const { return proportion >= minPassRate; }
+};
+
+struct NistReport {
+    std::string generator;                 // ścieżka pliku wejściowego
+    size_t streamBits = 0;
+    double alpha = 0.01;
+    std::vector<NistStreamResult> streams;
+    std::vector<NistSummaryRow> rows;
+
+    // Liczba strumieni, dla których dany test miał zastosowanie
+    size_t sampleSize(NistTestId test) const;
+    // Minimalny odsetek sekwencji przechodzących dla próby o zadanej liczności
+    double minPassRate(size_t sampleSize) const;
+
+    // Raport w układzie finalAnalysisReport.txt (parsowalny przez logs/compress_nist_results.py)
+    void printFinalAnalysis(std::ostream& out) const;
+    // Raport jako JSON (pola jak w logs/compress_nist_results.py); false przy błędzie zapisu
+    bool saveJson(const std::string& path) const;
+};
+
+class NistTestSuite {
+public:
+    explicit NistTestSuite(const NistOptions& options);
+
+    NistTestSuite(const NistTestSuite&) = delete;
+    NistTestSuite& operator=(const NistTestSuite&) = delete;
+
+    // Testuje plik (mmap); przy błędzie wypisuje komunikat i zwraca false
+    bool runFile(const std::string& path, NistReport& report);
+
+    // Testuje dane w pamięci: streamCount (albo tyle, ile się mieści) strumieni po streamBits bitów
+    bool runBuffer(const unsigned char* data, size_t sizeBytes, NistReport& report);
+
+    // Testuje jeden strumień zaczynający się od bitu `bitOffset` (worker = numer wątku puli)
+    NistStreamResult testStream(const unsigned char* data, uint64_t bitOffset, size_t worker);
+
+private:
+    NistOptions options;
+    WorkStealingPool pool;
+    std::vector<std::vector<unsigned char>> workerBits;   // strumień rozpakowany po bicie na bajt
+    std::vector<std::vector<unsigned char>> workerPacked; // strumień wyrównany do bajtu (gdy trzeba)
+    std::unique_ptr<RealFftPlan> fftPlan;                 // plan dla streamBits (tylko przy teście FFT)
+    std::vector<FftWorkspace> workerFft;                  // bufory FFT każdego wątku
+
+    void summarize(NistReport& report) const;
+};
+
+#endif // NIST_STS_H
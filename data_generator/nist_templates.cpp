@@ -0,0 +1,54 @@
+#include "nist_templates.h"
+#include <algorithm>
+
+NistTemplateMatcher::NistTemplateMatcher(const std::vector<uint32_t>& templates, size_t m, bool overlapping)
+    : m(m), overlapping(overlapping), templateTotal(templates.size()) {
+    if (m == 0 || m > MAX_TEMPLATE_LENGTH) {
+        templateTotal = 0;
+        return;
+    }
+    index.assign(size_t(1) << m, -1);
+    for (size_t t = 0; t < templates.size(); t++) {
+        index[templates[t] & ((uint32_t(1) << m) - 1)] = static_cast<int32_t>(t);
+    }
+}
+
+void NistTemplateMatcher::countBlock(const unsigned char* data, uint64_t bitOffset, size_t length,
+                                     uint32_t* counts) const {
+    std::fill(counts, counts + templateTotal, 0);
+    if (templateTotal == 0 || length < m) {
+        return;
+    }
+
+    // nextAllowed[t] = pierwsza pozycja, na której szablon t może znów zostać policzony
+    std::vector<size_t> nextAllowed(overlapping ? 0 : templateTotal, 0);
+    const uint32_t mask = (uint32_t(1) << m) - 1;
+    const int32_t* lookup = index.data();
+    uint32_t window = 0;
+
+    // Bity czytane bajtami; k to numer bitu w bloku, okno kończy się na bicie k
+    const unsigned char* p = data + (bitOffset >> 3);
+    unsigned bit = static_cast<unsigned>(bitOffset & 7);
+    unsigned current = *p;
+    for (size_t k = 0; k < length; k++) {
+        window = ((window << 1) | ((current >> (7 - bit)) & 1)) & mask;
+        if (++bit == 8 && k + 1 < length) {
+            bit = 0;
+            current = *++p;
+        }
+        if (k + 1 < m) {
+            continue;
+        }
+        int32_t t = lookup[window];
+        if (t < 0) {
+            continue;
+        }
+        size_t j = k + 1 - m; // początek dopasowania
+        if (overlapping) {
+            counts[t]++;
+        } else if (j >= nextAllowed[t]) {
+            counts[t]++;
+            nextAllowed[t] = j + m;
+        }
+    }
+}
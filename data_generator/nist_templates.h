@@ -0,0 +1,38 @@
+#ifndef NIST_TEMPLATES_H
+#define NIST_TEMPLATES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Jednoprzebiegowe zliczanie dopasowań wielu szablonów (testy NonOverlappingTemplate
+ * i OverlappingTemplate NIST STS).
+ *
+ * Zamiast skanować blok osobno dla każdego szablonu, matcher przesuwa raz m-bitowe okno
+ * po bitach spakowanych (od najstarszego) i tablicą indeksowaną wartością okna znajduje
+ * szablon, który na tej pozycji pasuje - koszt O(n) niezależnie od liczby szablonów.
+ * Semantykę dopasowań nienakładających się (po trafieniu skanowanie danego szablonu
+ * przeskakuje za niego) zapewnia wektor stanu: najbliższa dozwolona pozycja każdego szablonu.
+ */
+class NistTemplateMatcher {
+public:
+    // Najdłuższy obsługiwany szablon (tablica indeksów ma 2^m pozycji)
+    static constexpr size_t MAX_TEMPLATE_LENGTH = 24;
+
+    // templates: różne m-bitowe wzorce (bity od najstarszego); overlapping = dopasowania mogą się nakładać
+    NistTemplateMatcher(const std::vector<uint32_t>& templates, size_t m, bool overlapping);
+
+    size_t templateCount() const { return templateTotal; }
+
+    // counts[t] = liczba dopasowań szablonu t w bitach [bitOffset, bitOffset + length)
+    void countBlock(const unsigned char* data, uint64_t bitOffset, size_t length, uint32_t* counts) const;
+
+private:
+    size_t m;
+    bool overlapping;
+    size_t templateTotal;
+    std::vector<int32_t> index; // wartość okna -> numer szablonu albo -1
+};
+
+#endif // NIST_TEMPLATES_H
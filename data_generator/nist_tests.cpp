@@ -0,0 +1,856 @@
+#include "nist_tests.h"
+#include "nist_bit_kernels.h"
+#include "nist_fft.h"
+#include "nist_math.h"
+#include "nist_templates.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace {
+
+const double SQRT2 = 1.41421356237309504880;
+
+// Liczności wszystkich wzorców `bits`-bitowych w sekwencji traktowanej cyklicznie
+// (okno zaczyna się na każdej pozycji i zawija na początek), indeks = wzorzec od najstarszego bitu
+std::vector<uint32_t> circularPatternCounts(const unsigned char* epsilon, size_t n, size_t bits) {
+    std::vector<uint32_t> counts(size_t(1) << bits, 0);
+    if (bits == 0) {
+        counts[0] = static_cast<uint32_t>(n);
+        return counts;
+    }
+    const uint32_t mask = static_cast<uint32_t>((uint64_t(1) << bits) - 1);
+    uint32_t window = 0;
+    for (size_t j = 0; j + 1 < bits; j++) {
+        window = (window << 1) | epsilon[j % n];
+    }
+    for (size_t i = 0; i < n; i++) {
+        window = ((window << 1) | epsilon[(i + bits - 1) % n]) & mask;
+        counts[window]++;
+    }
+    return counts;
+}
+
+// Liczności wzorców o jeden bit krótszych: wzorzec x to prefiks 2x i 2x+1
+std::vector<uint32_t> shorterPatternCounts(const std::vector<uint32_t>& counts) {
+    std::vector<uint32_t> shorter(counts.size() / 2);
+    for (size_t x = 0; x < shorter.size(); x++) {
+        shorter[x] = counts[2 * x] + counts[2 * x + 1];
+    }
+    return shorter;
+}
+
+// Prawdopodobieństwo u wystąpień szablonu z samych jedynek (Pr z overlappingTemplateMatchings.c)
+double overlappingProbability(int u, double eta) {
+    if (u == 0) {
+        return std::exp(-eta);
+    }
+    double sum = 0.0;
+    for (int l = 1; l <= u; l++) {
+        sum += std::exp(-eta - u * std::log(2.0) + l * std::log(eta) - std::lgamma(l + 1.0) + std::lgamma(u) -
+                        std::lgamma(l) - std::lgamma(u - l + 1.0));
+    }
+    return sum;
+}
+
+// Rząd macierzy nad GF(2) (eliminacja Gaussa), macierz wierszami po jednym bicie na bajt
+size_t binaryMatrixRank(std::vector<unsigned char>& matrix, size_t rows, size_t cols) {
+    size_t rank = 0;
+    for (size_t col = 0; col < cols && rank < rows; col++) {
+        size_t pivot = rank;
+        while (pivot < rows && matrix[pivot * cols + col] == 0) {
+            pivot++;
+        }
+        if (pivot == rows) {
+            continue;
+        }
+        if (pivot != rank) {
+            std::swap_ranges(matrix.begin() + pivot * cols, matrix.begin() + (pivot + 1) * cols,
+                             matrix.begin() + rank * cols);
+        }
+        for (size_t row = 0; row < rows; row++) {
+            if (row != rank && matrix[row * cols + col]) {
+                for (size_t j = col; j < cols; j++) {
+                    matrix[row * cols + j] ^= matrix[rank * cols + j];
+                }
+            }
+        }
+        rank++;
+    }
+    return rank;
+}
+
+// Test spektralny dla sygnału już wpisanego w plan.signal(workspace): liczone są moduły
+// współczynników 0 .. n/2-1 (w assess m[0] to składowa stała) mniejsze od progu 95%
+std::vector<double> spectralPValue(const RealFftPlan& plan, FftWorkspace& workspace) {
+    const size_t n = plan.size();
+    double* magnitudes = workspace.realBuffer(3, n / 2);
+    plan.magnitudes(workspace, magnitudes, n / 2);
+    double upperBound = std::sqrt(2.995732274 * n);
+    size_t count = 0;
+    for (size_t k = 0; k < n / 2; k++) {
+        if (magnitudes[k] < upperBound) {
+            count++;
+        }
+    }
+
+    double nL = static_cast<double>(count);
+    double n0 = 0.95 * n / 2.0;
+    double d = (nL - n0) / std::sqrt(n / 4.0 * 0.95 * 0.05);
+    return {std::erfc(std::fabs(d) / SQRT2)};
+}
+
+// Wspólne części testów Frequency..LongestRun: statystyka liczona po bicie albo jądrami
+// nist_bit_kernels na danych spakowanych trafia do tych samych wzorów
+
+std::vector<double> frequencyPValue(long long sum, size_t n) {
+    double sObs = std::fabs(static_cast<double>(sum)) / std::sqrt(static_cast<double>(n));
+    return {std::erfc(sObs / SQRT2)};
+}
+
+// blockOnes(i) = liczba jedynek w i-tym bloku
+template <typename BlockOnes>
+std::vector<double> blockFrequencyPValue(size_t n, size_t blockLength, BlockOnes blockOnes) {
+    if (blockLength == 0 || n / blockLength == 0) {
+        return {};
+    }
+    size_t blockCount = n / blockLength;
+    double sum = 0.0;
+    for (size_t i = 0; i < blockCount; i++) {
+        double pi = static_cast<double>(blockOnes(i)) / static_cast<double>(blockLength);
+        double v = pi - 0.5;
+        sum += v * v;
+    }
+    double chiSquared = 4.0 * blockLength * sum;
+    return {nistIgamc(blockCount / 2.0, chiSquared / 2.0)};
+}
+
+// s = suma końcowa, sup / inf = ekstrema sum częściowych (z S_0 = 0)
+std::vector<double> cumulativeSumsPValues(long long s, long long sup, long long inf, size_t n) {
+    long long z = std::max(sup, -inf);          // maksimum sum częściowych od przodu
+    long long zRev = std::max(sup - s, s - inf); // ... i od tyłu
+
+    // Sumy jak w cusum.c - dzielenia całkowitoliczbowe celowo jak w C
+    const long long N = static_cast<long long>(n);
+    const double sqrtN = std::sqrt(static_cast<double>(n));
+    auto pValue = [&](long long zz) {
+        double sum1 = 0.0;
+        for (long long k = (-N / zz + 1) / 4; k <= (N / zz - 1) / 4; k++) {
+            sum1 += nistNormal(((4 * k + 1) * zz) / sqrtN);
+            sum1 -= nistNormal(((4 * k - 1) * zz) / sqrtN);
+        }
+        double sum2 = 0.0;
+        for (long long k = (-N / zz - 3) / 4; k <= (N / zz - 1) / 4; k++) {
+            sum2 += nistNormal(((4 * k + 3) * zz) / sqrtN);
+            sum2 -= nistNormal(((4 * k + 1) * zz) / sqrtN);
+        }
+        return 1.0 - sum1 + sum2;
+    };
+    return {pValue(z), pValue(zRev)};
+}
+
+// transitions() = liczba par sąsiednich różnych bitów, liczona tylko gdy kryterium wstępne jest spełnione
+template <typename Transitions>
+std::vector<double> runsPValue(size_t ones, size_t n, Transitions transitions) {
+    double pi = static_cast<double>(ones) / static_cast<double>(n);
+    if (std::fabs(pi - 0.5) > 2.0 / std::sqrt(static_cast<double>(n))) {
+        return {0.0}; // kryterium wstępne niespełnione - jak w assess
+    }
+    size_t vObs = 1 + transitions();
+    double erfcArg = std::fabs(vObs - 2.0 * n * pi * (1 - pi)) / (2.0 * pi * (1 - pi) * std::sqrt(2.0 * n));
+    return {std::erfc(erfcArg)};
+}
+
+// longestRun(i, M) = najdłuższa seria jedynek w i-tym bloku M bitów (M = 8, 128 albo 10000)
+template <typename LongestRun>
+std::vector<double> longestRunOfOnesPValue(size_t n, LongestRun longestRun) {
+    if (n < 128) {
+        return {};
+    }
+    size_t K, M;
+    const unsigned int* V;
+    const double* pi;
+    static const unsigned int V3[] = {1, 2, 3, 4};
+    static const double PI3[] = {0.21484375, 0.3671875, 0.23046875, 0.1875};
+    static const unsigned int V5[] = {4, 5, 6, 7, 8, 9};
+    static const double PI5[] = {0.1174035788, 0.242955959, 0.249363483, 0.17517706, 0.102701071, 0.112398847};
+    static const unsigned int V6[] = {10, 11, 12, 13, 14, 15, 16};
+    static const double PI6[] = {0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727};
+    if (n < 6272) {
+        K = 3; M = 8; V = V3; pi = PI3;
+    } else if (n < 750000) {
+        K = 5; M = 128; V = V5; pi = PI5;
+    } else {
+        K = 6; M = 10000; V = V6; pi = PI6;
+    }
+
+    size_t N = n / M;
+    unsigned int nu[7] = {0, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < N; i++) {
+        // V to kolejne liczby: klasa = seria przycięta do [V[0], V[K]] minus V[0], bez skoków
+        size_t longest = std::min<size_t>(std::max<size_t>(longestRun(i, M), V[0]), V[K]);
+        nu[longest - V[0]]++;
+    }
+
+    double chi2 = 0.0;
+    for (size_t i = 0; i <= K; i++) {
+        double expected = static_cast<double>(N) * pi[i];
+        chi2 += (nu[i] - expected) * (nu[i] - expected) / expected;
+    }
+    return {nistIgamc(K / 2.0, chi2 / 2.0)};
+}
+
+// matrixRank(k) = rząd k-tej macierzy 32x32 (wypełnianej wierszami z kolejnych bitów)
+template <typename MatrixRank>
+std::vector<double> rankPValue(size_t n, MatrixRank matrixRank) {
+    const size_t M = 32, Q = 32;
+    size_t N = n / (M * Q);
+    if (N == 0) {
+        return {};
+    }
+
+    // Prawdopodobieństwa rzędów 32, 31 i <= 30 dla losowej macierzy 32x32
+    auto rankProbability = [](int r) {
+        double product = 1;
+        for (int i = 0; i <= r - 1; i++) {
+            product *= ((1.e0 - std::pow(2, i - 32)) * (1.e0 - std::pow(2, i - 32))) / (1.e0 - std::pow(2, i - r));
+        }
+        return std::pow(2, r * (32 + 32 - r) - 32 * 32) * product;
+    };
+    double p32 = rankProbability(32);
+    double p31 = rankProbability(31);
+    double p30 = 1 - (p32 + p31);
+
+    size_t f32 = 0, f31 = 0;
+    for (size_t k = 0; k < N; k++) {
+        size_t rank = matrixRank(k);
+        if (rank == 32) {
+            f32++;
+        } else if (rank == 31) {
+            f31++;
+        }
+    }
+    size_t f30 = N - (f32 + f31);
+
+    double chiSquared = std::pow(f32 - N * p32, 2) / (N * p32) + std::pow(f31 - N * p31, 2) / (N * p31) +
+                        std::pow(f30 - N * p30, 2) / (N * p30);
+    return {std::exp(-chiSquared / 2.e0)};
+}
+
+// complexity(i) = złożoność liniowa i-tego bloku
+template <typename Complexity>
+std::vector<double> linearComplexityPValue(size_t n, size_t blockLength, Complexity complexity) {
+    static const double PI[7] = {0.01047, 0.03125, 0.12500, 0.50000, 0.25000, 0.06250, 0.020833};
+    const int K = 6;
+    const size_t M = blockLength;
+    size_t N = M == 0 ? 0 : n / M;
+    if (N == 0) {
+        return {};
+    }
+
+    // Wartość oczekiwana złożoności i znaki zależne od parzystości M
+    double sign = (M + 1) % 2 == 0 ? -1.0 : 1.0;
+    double mean = M / 2.0 + (9.0 + sign) / 36.0 - 1.0 / std::pow(2.0, static_cast<double>(M)) * (M / 3.0 + 2.0 / 9.0);
+    sign = M % 2 == 0 ? 1.0 : -1.0;
+
+    double nu[K + 1] = {};
+    for (size_t i = 0; i < N; i++) {
+        double L = static_cast<double>(complexity(i));
+        double t = sign * (L - mean) + 2.0 / 9.0;
+        if (t <= -2.5) {
+            nu[0]++;
+        } else if (t <= -1.5) {
+            nu[1]++;
+        } else if (t <= -0.5) {
+            nu[2]++;
+        } else if (t <= 0.5) {
+            nu[3]++;
+        } else if (t <= 1.5) {
+            nu[4]++;
+        } else if (t <= 2.5) {
+            nu[5]++;
+        } else {
+            nu[6]++;
+        }
+    }
+
+    double chi2 = 0.0;
+    for (int i = 0; i < K + 1; i++) {
+        chi2 += std::pow(nu[i] - N * PI[i], 2) / (N * PI[i]);
+    }
+    return {nistIgamc(K / 2.0, chi2 / 2.0)};
+}
+
+// blockCounts(blockStart, M, counts) wpisuje liczby dopasowań każdego szablonu w bloku M bitów od blockStart
+template <typename BlockCounts>
+std::vector<double> nonOverlappingPValues(size_t n, size_t m, size_t templateCount, BlockCounts blockCounts) {
+    const size_t N = 8;
+    size_t M = n / N;
+    if (m == 0 || m >= 32 || M < m) {
+        return {};
+    }
+
+    double lambda = (M - m + 1) / std::pow(2, m);
+    double varWj = M * (1.0 / std::pow(2.0, m) - (2.0 * m - 1.0) / std::pow(2.0, 2.0 * m));
+
+    std::vector<double> chi2(templateCount, 0.0);
+    std::vector<uint32_t> counts(templateCount);
+    for (size_t i = 0; i < N; i++) {
+        blockCounts(i * M, M, counts.data());
+        for (size_t t = 0; t < templateCount; t++) {
+            chi2[t] += std::pow((counts[t] - lambda) / std::sqrt(varWj), 2);
+        }
+    }
+
+    std::vector<double> pValues;
+    pValues.reserve(templateCount);
+    for (double value : chi2) {
+        pValues.push_back(nistIgamc(N / 2.0, value / 2.0));
+    }
+    return pValues;
+}
+
+// blockMatches(blockStart, M) = liczba nakładających się dopasowań szablonu z jedynek w bloku
+template <typename BlockMatches>
+std::vector<double> overlappingPValue(size_t n, size_t m, BlockMatches blockMatches) {
+    const size_t M = 1032;
+    const int K = 5;
+    size_t N = n / M;
+    if (N == 0 || m == 0 || m > M) {
+        return {};
+    }
+
+    double lambda = (M - m + 1) / std::pow(2, m);
+    double eta = lambda / 2.0;
+    double pi[K + 1];
+    double sum = 0.0;
+    for (int i = 0; i < K; i++) {
+        pi[i] = overlappingProbability(i, eta);
+        sum += pi[i];
+    }
+    pi[K] = 1 - sum;
+
+    unsigned int nu[K + 1] = {0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < N; i++) {
+        unsigned int wObs = blockMatches(i * M, M);
+        nu[std::min<unsigned int>(wObs, K)]++;
+    }
+
+    double chi2 = 0.0;
+    for (int i = 0; i < K + 1; i++) {
+        chi2 += std::pow(nu[i] - N * pi[i], 2) / (N * pi[i]);
+    }
+    return {nistIgamc(K / 2.0, chi2 / 2.0)};
+}
+
+} // namespace
+
+std::vector<double> nistFrequency(const unsigned char* epsilon, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    long long sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += 2 * static_cast<int>(epsilon[i]) - 1;
+    }
+    return frequencyPValue(sum, n);
+}
+
+std::vector<double> nistBlockFrequency(const unsigned char* epsilon, size_t n, size_t blockLength) {
+    return blockFrequencyPValue(n, blockLength, [&](size_t i) {
+        size_t blockSum = 0;
+        for (size_t j = 0; j < blockLength; j++) {
+            blockSum += epsilon[i * blockLength + j];
+        }
+        return blockSum;
+    });
+}
+
+std::vector<double> nistCumulativeSums(const unsigned char* epsilon, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    long long s = 0, sup = 0, inf = 0;
+    for (size_t k = 0; k < n; k++) {
+        s += epsilon[k] ? 1 : -1;
+        sup = std::max(sup, s);
+        inf = std::min(inf, s);
+    }
+    return cumulativeSumsPValues(s, sup, inf, n);
+}
+
+std::vector<double> nistRuns(const unsigned char* epsilon, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    size_t ones = 0;
+    for (size_t k = 0; k < n; k++) {
+        ones += epsilon[k];
+    }
+    return runsPValue(ones, n, [&] {
+        size_t transitions = 0;
+        for (size_t k = 1; k < n; k++) {
+            if (epsilon[k] != epsilon[k - 1]) {
+                transitions++;
+            }
+        }
+        return transitions;
+    });
+}
+
+std::vector<double> nistLongestRunOfOnes(const unsigned char* epsilon, size_t n) {
+    return longestRunOfOnesPValue(n, [&](size_t i, size_t M) {
+        size_t longest = 0, run = 0;
+        for (size_t j = 0; j < M; j++) {
+            if (epsilon[i * M + j] == 1) {
+                run++;
+                longest = std::max(longest, run);
+            } else {
+                run = 0;
+            }
+        }
+        return longest;
+    });
+}
+
+std::vector<double> nistFrequencyPacked(const unsigned char* packed, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    long long ones = static_cast<long long>(nistPackedOnes(packed, 0, n));
+    return frequencyPValue(2 * ones - static_cast<long long>(n), n);
+}
+
+std::vector<double> nistBlockFrequencyPacked(const unsigned char* packed, size_t n, size_t blockLength) {
+    if (blockLength % 8 != 0) {
+        return blockFrequencyPValue(n, blockLength, [&](size_t i) {
+            return nistPackedOnes(packed, static_cast<uint64_t>(i) * blockLength, blockLength);
+        });
+    }
+    // Bloki w pełnych bajtach: jedynki wszystkich bloków liczone jednym wywołaniem jądra
+    std::vector<uint32_t> ones;
+    return blockFrequencyPValue(n, blockLength, [&](size_t i) {
+        if (ones.empty()) {
+            ones.resize(n / blockLength);
+            nistPackedBlockOnes(packed, blockLength / 8, n / blockLength, ones.data());
+        }
+        return static_cast<size_t>(ones[i]);
+    });
+}
+
+std::vector<double> nistCumulativeSumsPacked(const unsigned char* packed, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    NistWalk walk = nistPackedWalk(packed, n);
+    return cumulativeSumsPValues(walk.sum, walk.maxSum, walk.minSum, n);
+}
+
+std::vector<double> nistRunsPacked(const unsigned char* packed, size_t n) {
+    if (n == 0) {
+        return {};
+    }
+    size_t ones = nistPackedOnes(packed, 0, n);
+    return runsPValue(ones, n, [&] { return nistPackedTransitions(packed, n); });
+}
+
+std::vector<double> nistLongestRunOfOnesPacked(const unsigned char* packed, size_t n) {
+    // Wszystkie długości bloków (8, 128, 10000) są wielokrotnością bajtu; serie wszystkich bloków
+    // liczone jednym wywołaniem jądra przy pierwszym bloku
+    std::vector<uint32_t> longest;
+    return longestRunOfOnesPValue(n, [&](size_t i, size_t M) {
+        if (longest.empty()) {
+            longest.resize(n / M);
+            nistPackedLongestRuns(packed, M / 8, n / M, longest.data());
+        }
+        return static_cast<size_t>(longest[i]);
+    });
+}
+
+std::vector<double> nistRank(const unsigned char* epsilon, size_t n) {
+    std::vector<unsigned char> matrix(32 * 32);
+    return rankPValue(n, [&](size_t k) {
+        std::copy(epsilon + k * matrix.size(), epsilon + (k + 1) * matrix.size(), matrix.begin());
+        return binaryMatrixRank(matrix, 32, 32);
+    });
+}
+
+std::vector<double> nistDiscreteFourierTransform(const unsigned char* epsilon, size_t n) {
+    if (n < 2) {
+        return {};
+    }
+    RealFftPlan plan(n);
+    FftWorkspace workspace;
+    double* x = plan.signal(workspace);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 2 * static_cast<int>(epsilon[i]) - 1;
+    }
+    return spectralPValue(plan, workspace);
+}
+
+const std::vector<uint32_t>& nistAperiodicTemplates(size_t m) {
+    static std::mutex cacheMutex;
+    static std::map<size_t, std::vector<uint32_t>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = cache.find(m);
+    if (found != cache.end()) {
+        return found->second;
+    }
+
+    // Szablon jest aperiodyczny, gdy żadne jego przesunięcie nie nakłada się na niego samego
+    std::vector<uint32_t> aperiodic;
+    for (uint32_t value = 0; m > 0 && m < 32 && value < (1u << m); value++) {
+        bool periodic = false;
+        for (size_t shift = 1; shift < m && !periodic; shift++) {
+            uint32_t mask = (1u << (m - shift)) - 1;
+            periodic = (value >> shift) == (value & mask);
+        }
+        if (!periodic) {
+            aperiodic.push_back(value);
+        }
+    }
+
+    const size_t MAX_TEMPLATES = 148;
+    size_t skip = aperiodic.size() < MAX_TEMPLATES ? 1 : aperiodic.size() / MAX_TEMPLATES;
+    std::vector<uint32_t> selected;
+    for (size_t i = 0; i < std::min(MAX_TEMPLATES, aperiodic.size()); i++) {
+        selected.push_back(aperiodic[i * skip]);
+    }
+    return cache.emplace(m, std::move(selected)).first->second;
+}
+
+std::vector<double> nistNonOverlappingTemplateMatchings(const unsigned char* epsilon, size_t n, size_t m) {
+    if (m == 0 || m >= 32) {
+        return {};
+    }
+    const std::vector<uint32_t>& templates = nistAperiodicTemplates(m);
+    return nonOverlappingPValues(n, m, templates.size(), [&](size_t blockStart, size_t M, uint32_t* counts) {
+        // Każdy szablon skanowany osobno, jak w assess
+        const unsigned char* block = epsilon + blockStart;
+        for (size_t t = 0; t < templates.size(); t++) {
+            uint32_t pattern = templates[t];
+            uint32_t wObs = 0;
+            for (size_t j = 0; j < M - m + 1; j++) {
+                bool match = true;
+                for (size_t k = 0; k < m; k++) {
+                    if (block[j + k] != ((pattern >> (m - 1 - k)) & 1)) {
+                        match = false;
+                        break;
+                    }
+                }
+                if (match) {
+                    // Dopasowania się nie nakładają - skok za szablon
+                    wObs++;
+                    j += m - 1;
+                }
+            }
+            counts[t] = wObs;
+        }
+    });
+}
+
+std::vector<double> nistOverlappingTemplateMatchings(const unsigned char* epsilon, size_t n, size_t m) {
+    return overlappingPValue(n, m, [&](size_t blockStart, size_t M) {
+        // Szablon z samych jedynek, dopasowania nakładające się
+        const unsigned char* block = epsilon + blockStart;
+        unsigned int wObs = 0;
+        for (size_t j = 0; j < M - m + 1; j++) {
+            bool match = true;
+            for (size_t k = 0; k < m; k++) {
+                if (block[j + k] != 1) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                wObs++;
+            }
+        }
+        return wObs;
+    });
+}
+
+std::vector<double> nistUniversal(const unsigned char* epsilon, size_t n) {
+    static const double EXPECTED_VALUE[17] = {0, 0, 0, 0, 0, 0, 5.2177052, 6.1962507, 7.1836656, 8.1764248,
+                                              9.1723243, 10.170032, 11.168765, 12.168070, 13.167693, 14.167488,
+                                              15.167379};
+    static const double VARIANCE[17] = {0, 0, 0, 0, 0, 0, 2.954, 3.125, 3.238, 3.311, 3.356, 3.384, 3.401,
+                                        3.410, 3.416, 3.419, 3.421};
+    static const size_t THRESHOLDS[] = {387840, 904960, 2068480, 4654080, 10342400, 22753280, 49643520,
+                                        107560960, 231669760, 496435200, 1059061760};
+
+    size_t L = 5;
+    for (size_t threshold : THRESHOLDS) {
+        if (n >= threshold) {
+            L++;
+        }
+    }
+    if (L < 6 || L > 16) {
+        return {}; // assess: "L IS OUT OF RANGE"
+    }
+
+    const size_t Q = 10 * (size_t(1) << L);
+    const size_t K = n / L - Q; // bloki testowe
+    const double c = 0.7 - 0.8 / L + (4 + 32.0 / L) * std::pow(static_cast<double>(K), -3.0 / L) / 15;
+    const double sigma = c * std::sqrt(VARIANCE[L] / K);
+
+    auto blockValue = [&](size_t block) {
+        uint32_t value = 0;
+        for (size_t j = 0; j < L; j++) {
+            value = (value << 1) | epsilon[block * L + j];
+        }
+        return value;
+    };
+
+    // Ostatnie wystąpienie każdego wzorca (numer bloku od 1)
+    std::vector<size_t> lastSeen(size_t(1) << L, 0);
+    for (size_t i = 1; i <= Q; i++) {
+        lastSeen[blockValue(i - 1)] = i;
+    }
+    double sum = 0.0;
+    for (size_t i = Q + 1; i <= Q + K; i++) {
+        uint32_t value = blockValue(i - 1);
+        sum += std::log(static_cast<double>(i - lastSeen[value])) / std::log(2.0);
+        lastSeen[value] = i;
+    }
+
+    double phi = sum / K;
+    double arg = std::fabs(phi - EXPECTED_VALUE[L]) / (SQRT2 * sigma);
+    return {std::erfc(arg)};
+}
+
+std::vector<double> nistApproximateEntropy(const unsigned char* epsilon, size_t n, size_t m) {
+    if (n == 0 || m + 1 >= 32) {
+        return {};
+    }
+    // phi(b) = suma C*ln(C/n) / n po wzorcach b-bitowych (cyklicznie)
+    auto phi = [n](const std::vector<uint32_t>& counts) {
+        double sum = 0.0;
+        for (uint32_t count : counts) {
+            if (count > 0) {
+                sum += count * std::log(count / static_cast<double>(n));
+            }
+        }
+        return sum / n;
+    };
+
+    std::vector<uint32_t> countsLong = circularPatternCounts(epsilon, n, m + 1);
+    double apEnLong = phi(countsLong);
+    double apEnShort = m == 0 ? 0.0 : phi(shorterPatternCounts(countsLong));
+
+    double apen = apEnShort - apEnLong;
+    double chiSquared = 2.0 * n * (std::log(2.0) - apen);
+    return {nistIgamc(std::pow(2, static_cast<double>(m) - 1), chiSquared / 2.0)};
+}
+
+std::vector<double> nistRandomExcursions(const unsigned char* epsilon, size_t n) {
+    static const double PI[5][6] = {
+        {0.0000000000, 0.00000000000, 0.00000000000, 0.00000000000, 0.00000000000, 0.0000000000},
+        {0.5000000000, 0.25000000000, 0.12500000000, 0.06250000000, 0.03125000000, 0.0312500000},
+        {0.7500000000, 0.06250000000, 0.04687500000, 0.03515625000, 0.02636718750, 0.0791015625},
+        {0.8333333333, 0.02777777778, 0.02314814815, 0.01929012346, 0.01607510288, 0.0803755143},
+        {0.8750000000, 0.01562500000, 0.01367187500, 0.01196289063, 0.01046752930, 0.0732727051}};
+    static const int STATE_X[8] = {-4, -3, -2, -1, 1, 2, 3, 4};
+    if (n == 0) {
+        return {};
+    }
+
+    // Cykl kończy się powrotem sumy do zera (oraz końcem sekwencji, jeśli suma != 0);
+    // w każdym cyklu liczone są wizyty w stanach -4..-1, 1..4
+    const size_t maxCycles = std::max<size_t>(1000, n / 100);
+    double nu[6][8] = {};
+    unsigned int counter[8] = {};
+    auto closeCycle = [&]() {
+        for (int i = 0; i < 8; i++) {
+            nu[std::min(counter[i], 5u)][i]++;
+            counter[i] = 0;
+        }
+    };
+
+    size_t J = 0;
+    long long s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += epsilon[i] ? 1 : -1;
+        if (s == 0) {
+            // Pierwszy bit nie zamyka cyklu (w assess pętla liczy zera od i = 1)
+            J++;
+            if (J > maxCycles) {
+                return {}; // assess: "EXCEEDING THE MAX NUMBER OF CYCLES EXPECTED"
+            }
+            closeCycle();
+        } else if (s >= -4 && s <= 4) {
+            counter[s < 0 ? s + 4 : s + 3]++;
+        }
+    }
+    if (s != 0) {
+        J++;
+        closeCycle();
+    }
+
+    double constraint = std::max(0.005 * std::sqrt(static_cast<double>(n)), 500.0);
+    if (J < constraint) {
+        return {}; // za mało cykli - test nie ma zastosowania
+    }
+
+    std::vector<double> pValues(8);
+    for (int i = 0; i < 8; i++) {
+        int x = std::abs(STATE_X[i]);
+        double sum = 0.0;
+        for (int k = 0; k < 6; k++) {
+            double expected = J * PI[x][k];
+            sum += std::pow(nu[k][i] - expected, 2) / expected;
+        }
+        pValues[i] = nistIgamc(2.5, sum / 2.0);
+    }
+    return pValues;
+}
+
+std::vector<double> nistRandomExcursionsVariant(const unsigned char* epsilon, size_t n) {
+    static const int STATE_X[18] = {-9, -8, -7, -6, -5, -4, -3, -2, -1, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    if (n == 0) {
+        return {};
+    }
+
+    // Wizyty w stanach -9..9 (indeks s + 9) i liczba cykli
+    size_t visits[19] = {};
+    size_t J = 0;
+    long long s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += epsilon[i] ? 1 : -1;
+        if (s == 0) {
+            J++;
+        } else if (s >= -9 && s <= 9) {
+            visits[s + 9]++;
+        }
+    }
+    if (s != 0) {
+        J++;
+    }
+
+    int constraint = static_cast<int>(std::max(0.005 * std::sqrt(static_cast<double>(n)), 500.0));
+    if (J < static_cast<size_t>(constraint)) {
+        return {};
+    }
+
+    std::vector<double> pValues(18);
+    for (int p = 0; p < 18; p++) {
+        int x = STATE_X[p];
+        double count = static_cast<double>(visits[x + 9]);
+        pValues[p] = std::erfc(std::fabs(count - J) / std::sqrt(2.0 * J * (4.0 * std::abs(x) - 2)));
+    }
+    return pValues;
+}
+
+std::vector<double> nistSerial(const unsigned char* epsilon, size_t n, size_t m) {
+    if (n == 0 || m == 0 || m >= 32) {
+        return {};
+    }
+    // psi2(b) = 2^b/n * suma C^2 - n po wzorcach b-bitowych (cyklicznie); psi2(0) = psi2(-1) = 0
+    auto psi2 = [n](const std::vector<uint32_t>& counts, size_t bits) {
+        if (bits == 0) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (uint32_t count : counts) {
+            sum += static_cast<double>(count) * count;
+        }
+        return sum * std::pow(2, bits) / static_cast<double>(n) - static_cast<double>(n);
+    };
+
+    std::vector<uint32_t> counts0 = circularPatternCounts(epsilon, n, m);
+    std::vector<uint32_t> counts1 = shorterPatternCounts(counts0);
+    double psim0 = psi2(counts0, m);
+    double psim1 = psi2(counts1, m - 1);
+    double psim2 = m >= 2 ? psi2(shorterPatternCounts(counts1), m - 2) : 0.0;
+
+    double del1 = psim0 - psim1;
+    double del2 = psim0 - 2.0 * psim1 + psim2;
+    return {nistIgamc(std::pow(2, static_cast<double>(m) - 1) / 2, del1 / 2.0),
+            nistIgamc(std::pow(2, static_cast<double>(m) - 2) / 2, del2 / 2.0)};
+}
+
+size_t nistBerlekampMassey(const unsigned char* block, size_t length) {
+    std::vector<unsigned char> C(length + 1, 0), B(length + 1, 0), T;
+    C[0] = 1;
+    B[0] = 1;
+    size_t L = 0;
+    long long m = -1;
+    for (size_t N = 0; N < length; N++) {
+        unsigned int d = block[N];
+        for (size_t i = 1; i <= L; i++) {
+            d ^= C[i] & block[N - i];
+        }
+        if (d == 1) {
+            T = C;
+            size_t shift = static_cast<size_t>(static_cast<long long>(N) - m);
+            for (size_t j = 0; j + shift <= length; j++) {
+                C[j + shift] ^= B[j];
+            }
+            if (L <= N / 2) {
+                L = N + 1 - L;
+                m = static_cast<long long>(N);
+                B = T;
+            }
+        }
+    }
+    return L;
+}
+
+std::vector<double> nistLinearComplexity(const unsigned char* epsilon, size_t n, size_t blockLength) {
+    return linearComplexityPValue(n, blockLength, [&](size_t i) {
+        return nistBerlekampMassey(epsilon + i * blockLength, blockLength);
+    });
+}
+
+std::vector<double> nistRankPacked(const unsigned char* packed, size_t n) {
+    // Macierz to 128 kolejnych bajtów, wiersz - 4 bajty od najstarszego
+    return rankPValue(n, [&](size_t k) {
+        const unsigned char* matrix = packed + k * 128;
+        uint32_t rows[32];
+        for (size_t r = 0; r < 32; r++) {
+            const unsigned char* row = matrix + 4 * r;
+            rows[r] = (uint32_t(row[0]) << 24) | (uint32_t(row[1]) << 16) | (uint32_t(row[2]) << 8) | row[3];
+        }
+        return nistGf2Rank32(rows);
+    });
+}
+
+std::vector<double> nistLinearComplexityPacked(const unsigned char* packed, size_t n, size_t blockLength) {
+    return linearComplexityPValue(n, blockLength, [&](size_t i) {
+        return nistPackedBerlekampMassey(packed, static_cast<uint64_t>(i) * blockLength, blockLength);
+    });
+}
+
+std::vector<double> nistDiscreteFourierTransformPacked(const unsigned char* packed, size_t n, const RealFftPlan& plan,
+                                                       FftWorkspace& workspace) {
+    if (n < 2 || plan.size() != n) {
+        return {};
+    }
+    nistPackedToSigns(packed, n, plan.signal(workspace));
+    return spectralPValue(plan, workspace);
+}
+
+std::vector<double> nistNonOverlappingTemplateMatchingsPacked(const unsigned char* packed, size_t n, size_t m) {
+    if (m == 0 || m > NistTemplateMatcher::MAX_TEMPLATE_LENGTH) {
+        return {};
+    }
+    const std::vector<uint32_t>& templates = nistAperiodicTemplates(m);
+    NistTemplateMatcher matcher(templates, m, false);
+    return nonOverlappingPValues(n, m, templates.size(), [&](size_t blockStart, size_t M, uint32_t* counts) {
+        matcher.countBlock(packed, blockStart, M, counts);
+    });
+}
+
+std::vector<double> nistOverlappingTemplateMatchingsPacked(const unsigned char* packed, size_t n, size_t m) {
+    if (m == 0 || m > NistTemplateMatcher::MAX_TEMPLATE_LENGTH) {
+        return {};
+    }
+    NistTemplateMatcher matcher({(uint32_t(1) << m) - 1}, m, true);
+    return overlappingPValue(n, m, [&](size_t blockStart, size_t M) {
+        uint32_t wObs = 0;
+        matcher.countBlock(packed, blockStart, M, &wObs);
+        return wObs;
+    });
+}
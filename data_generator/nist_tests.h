@@ -0,0 +1,73 @@
+#ifndef NIST_TESTS_H
+#define NIST_TESTS_H
+
+#include "nist_fft.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Testy statystyczne NIST SP 800-22 (STS) dla jednej sekwencji bitów.
+ *
+ * Wzory, stałe i przypadki brzegowe odpowiadają implementacji referencyjnej
+ * sts-2.1.2 (assess), dzięki czemu p-wartości są z nią porównywalne.
+ * Sekwencja `epsilon` to n bitów zapisanych po jednym na bajt (0/1).
+ *
+ * Każdy test zwraca wektor p-wartości: jedną, kilka (np. CumulativeSums - przód
+ * i tył, NonOverlappingTemplate - po jednej na szablon) albo żadnej, gdy test nie
+ * ma zastosowania do tej sekwencji (za krótka, za mało cykli itp.).
+ */
+
+// Parametry testów (--defaultpar assess)
+struct NistParameters {
+    size_t blockFrequencyBlockLength = 128;     // M
+    size_t nonOverlappingTemplateLength = 9;    // m
+    size_t overlappingTemplateLength = 9;       // m
+    size_t approximateEntropyBlockLength = 10;  // m
+    size_t serialBlockLength = 16;              // m
+    size_t linearComplexityBlockLength = 500;   // M
+};
+
+std::vector<double> nistFrequency(const unsigned char* epsilon, size_t n);
+std::vector<double> nistBlockFrequency(const unsigned char* epsilon, size_t n, size_t blockLength);
+std::vector<double> nistCumulativeSums(const unsigned char* epsilon, size_t n);
+std::vector<double> nistRuns(const unsigned char* epsilon, size_t n);
+std::vector<double> nistLongestRunOfOnes(const unsigned char* epsilon, size_t n);
+std::vector<double> nistRank(const unsigned char* epsilon, size_t n);
+std::vector<double> nistDiscreteFourierTransform(const unsigned char* epsilon, size_t n);
+std::vector<double> nistNonOverlappingTemplateMatchings(const unsigned char* epsilon, size_t n, size_t m);
+std::vector<double> nistOverlappingTemplateMatchings(const unsigned char* epsilon, size_t n, size_t m);
+std::vector<double> nistUniversal(const unsigned char* epsilon, size_t n);
+std::vector<double> nistApproximateEntropy(const unsigned char* epsilon, size_t n, size_t m);
+std::vector<double> nistRandomExcursions(const unsigned char* epsilon, size_t n);
+std::vector<double> nistRandomExcursionsVariant(const unsigned char* epsilon, size_t n);
+std::vector<double> nistSerial(const unsigned char* epsilon, size_t n, size_t m);
+std::vector<double> nistLinearComplexity(const unsigned char* epsilon, size_t n, size_t blockLength);
+
+// Testy liczone wprost na bitach spakowanych po 8 w bajcie (od najstarszego, sekwencja od
+// bitu 0) jądrami nist_bit_kernels.h; p-wartości identyczne z wersjami po jednym bicie na bajt
+std::vector<double> nistFrequencyPacked(const unsigned char* packed, size_t n);
+std::vector<double> nistBlockFrequencyPacked(const unsigned char* packed, size_t n, size_t blockLength);
+std::vector<double> nistCumulativeSumsPacked(const unsigned char* packed, size_t n);
+std::vector<double> nistRunsPacked(const unsigned char* packed, size_t n);
+std::vector<double> nistLongestRunOfOnesPacked(const unsigned char* packed, size_t n);
+std::vector<double> nistRankPacked(const unsigned char* packed, size_t n);
+std::vector<double> nistLinearComplexityPacked(const unsigned char* packed, size_t n, size_t blockLength);
+std::vector<double> nistNonOverlappingTemplateMatchingsPacked(const unsigned char* packed, size_t n, size_t m);
+std::vector<double> nistOverlappingTemplateMatchingsPacked(const unsigned char* packed, size_t n, size_t m);
+
+// Test spektralny z gotowym planem FFT długości n (jeden na długość strumienia, wspólny dla wątków)
+// i buforami roboczymi wątku
+std::vector<double> nistDiscreteFourierTransformPacked(const unsigned char* packed, size_t n, const RealFftPlan& plan,
+                                                       FftWorkspace& workspace);
+
+/**
+ * Szablony aperiodyczne długości m (bity od najstarszego) w kolejności plików
+ * templates/templateM: rosnąco, co SKIP-ty, najwyżej 148 - jak w assess.
+ */
+const std::vector<uint32_t>& nistAperiodicTemplates(size_t m);
+
+// Złożoność liniowa bloku (algorytm Berlekampa-Masseya)
+size_t nistBerlekampMassey(const unsigned char* block, size_t length);
+
+#endif // NIST_TESTS_H
@@ -0,0 +1,215 @@
+#include "parallel_gzip.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Nagłówek gzip: deflate, bez nazwy pliku i czasu modyfikacji, system Unix
+const unsigned char GZIP_HEADER[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3};
+
+// Pusty blok końcowy (BFINAL, kody stałe, sam znacznik końca) - po Z_SYNC_FLUSH
+// strumień jest wyrównany do bajtu, więc można go po prostu dopisać
+const unsigned char FINAL_BLOCK[2] = {0x03, 0x00};
+
+void putLittleEndian32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+ParallelGzipWriter::ParallelGzipWriter(WorkStealingPool& pool, size_t blockSize, int level)
+    : pool(pool), blockSize(std::max(blockSize, DICTIONARY_SIZE)),
+      streams(pool.workerCount()), streamReady(pool.workerCount(), false),
+      blocks(4 * pool.workerCount()) { // kilka bloków na wątek wyrównuje różnice czasu kompresji
+    for (size_t i = 0; i < streams.size(); i++) {
+        streams[i] = z_stream{};
+        // Surowy deflate (ujemne windowBits) - nagłówek i stopkę gzip składamy sami
+        streamReady[i] = deflateInit2(&streams[i], level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+}
+
+ParallelGzipWriter::~ParallelGzipWriter() {
+    for (size_t i = 0; i < streams.size(); i++) {
+        if (streamReady[i]) {
+            deflateEnd(&streams[i]);
+        }
+    }
+}
+
+void ParallelGzipWriter::compressBlock(size_t worker, Block& block, const unsigned char* dict, size_t dictSize) {
+    z_stream& stream = streams[worker];
+    block.failed = true;
+
+    if (deflateReset(&stream) != Z_OK) {
+        return;
+    }
+    if (dictSize > 0 && deflateSetDictionary(&stream, dict, static_cast<uInt>(dictSize)) != Z_OK) {
+        return;
+    }
+
+    // deflateBound nie uwzględnia znacznika Z_SYNC_FLUSH - zapas na niego
+    size_t capacity = deflateBound(&stream, static_cast<uLong>(block.inputSize)) + 16;
+    if (block.output.size() < capacity) {
+        block.output.resize(capacity);
+    }
+
+    stream.next_in = const_cast<Bytef*>(block.data);
+    stream.avail_in = static_cast<uInt>(block.inputSize);
+    stream.next_out = block.output.data();
+    stream.avail_out = static_cast<uInt>(block.output.size());
+
+    // Przy zapełnionym wyjściu deflate trzeba wołać dalej z tym samym flush
+    while (true) {
+        if (deflate(&stream, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+            return;
+        }
+        if (stream.avail_out != 0) {
+            break;
+        }
+        size_t used = block.output.size();
+        block.output.resize(used * 2);
+        stream.next_out = block.output.data() + used;
+        stream.avail_out = static_cast<uInt>(block.output.size() - used);
+    }
+
+    block.outputSize = block.output.size() - stream.avail_out;
+    block.crc = crc32(0, block.data, static_cast<uInt>(block.inputSize));
+    block.failed = false;
+}
+
+bool ParallelGzipWriter::compress(const FillFn& fill, bool parallelFill, AsyncOutputSink& sink, int file,
+                                  uint64_t targetBytes, const ProgressFn& progress) {
+    auto loadBatch = [&](uint64_t batchOffset) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            blocks[i].input.resize(blockSize);
+            blocks[i].data = blocks[i].input.data();
+            blocks[i].inputSize = 0;
+        }
+        if (parallelFill) {
+            for (size_t i = 0; i < blocks.size(); i++) {
+                pool.submit([&, i](size_t worker) {
+                    blocks[i].inputSize = fill(worker, batchOffset + i * blockSize, blocks[i].input.data(), blockSize);
+                });
+            }
+            pool.wait();
+        } else {
+            for (size_t i = 0; i < blocks.size(); i++) {
+                blocks[i].inputSize = fill(0, batchOffset + i * blockSize, blocks[i].input.data(), blockSize);
+                if (blocks[i].inputSize < blockSize) {
+                    break;
+                }
+            }
+        }
+    };
+    return compressBatches(loadBatch, sink, file, targetBytes, progress);
+}
+
+bool ParallelGzipWriter::compress(const unsigned char* data, uint64_t size, AsyncOutputSink& sink, int file,
+                                  uint64_t targetBytes, const ProgressFn& progress) {
+    auto loadBatch = [&](uint64_t batchOffset) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            uint64_t offset = std::min(batchOffset + i * blockSize, size);
+            blocks[i].data = data + offset;
+            blocks[i].inputSize = static_cast<size_t>(std::min<uint64_t>(blockSize, size - offset));
+        }
+    };
+    return compressBatches(loadBatch, sink, file, targetBytes, progress);
+}
+
+bool ParallelGzipWriter::compressBatches(const std::function<void(uint64_t batchOffset)>& loadBatch,
+                                         AsyncOutputSink& sink, int file, uint64_t targetBytes,
+                                         const ProgressFn& progress) {
+    totalInput = 0;
+    totalOutput = 0;
+    dictionary.clear();
+
+    if (std::find(streamReady.begin(), streamReady.end(), false) != streamReady.end()) {
+        std::cerr << "Błąd: deflateInit2" << std::endl;
+        return false;
+    }
+
+    if (!sink.write(file, GZIP_HEADER, sizeof(GZIP_HEADER), 0)) {
+        return false;
+    }
+    totalOutput = sizeof(GZIP_HEADER);
+
+    uLong crc = crc32(0, Z_NULL, 0);
+    bool endOfInput = false;
+
+    while (!endOfInput && totalOutput < targetBytes) {
+        // Po błędzie zapisu dalsza kompresja nie ma sensu
+        if (sink.failed(file)) {
+            return false;
+        }
+
+        // 1. Wejście partii - wszystkie bloki poprzednich partii były pełne
+        loadBatch(totalInput);
+
+        // Niepełny blok kończy dane
+        size_t count = 0;
+        while (count < blocks.size()) {
+            size_t size = blocks[count].inputSize;
+            if (size > 0) {
+                count++;
+            }
+            if (size < blockSize) {
+                endOfInput = true;
+                break;
+            }
+        }
+
+        // 2. Kompresja - słownik bloku to koniec bloku poprzedniego
+        for (size_t i = 0; i < count; i++) {
+            pool.submit([this, i](size_t worker) {
+                if (i == 0) {
+                    compressBlock(worker, blocks[0], dictionary.data(), dictionary.size());
+                } else {
+                    const Block& previous = blocks[i - 1];
+                    compressBlock(worker, blocks[i], previous.data + previous.inputSize - DICTIONARY_SIZE,
+                                  DICTIONARY_SIZE);
+                }
+            });
+        }
+        pool.wait();
+
+        // 3. Zapis w kolejności, do osiągnięcia docelowego rozmiaru - wyjście bloku kopiowane do
+        //    bufora sinka, bo bloki partii są nadpisywane przez kolejną partię
+        size_t written = 0;
+        while (written < count && totalOutput < targetBytes) {
+            Block& block = blocks[written];
+            if (block.failed) {
+                std::cerr << "Błąd kompresji deflate" << std::endl;
+                return false;
+            }
+            if (!sink.write(file, block.output.data(), block.outputSize, totalOutput)) {
+                return false;
+            }
+            crc = crc32_combine(crc, block.crc, static_cast<z_off_t>(block.inputSize));
+            totalInput += block.inputSize;
+            totalOutput += block.outputSize;
+            written++;
+            if (progress) {
+                progress(totalOutput);
+            }
+        }
+
+        if (written > 0) {
+            const Block& last = blocks[written - 1];
+            size_t dictSize = std::min(last.inputSize, DICTIONARY_SIZE);
+            dictionary.assign(last.data + last.inputSize - dictSize, last.data + last.inputSize);
+        }
+    }
+
+    // Pusty blok końcowy i stopka: CRC32 oraz długość danych modulo 2^32
+    unsigned char trailer[sizeof(FINAL_BLOCK) + 8];
+    std::copy(FINAL_BLOCK, FINAL_BLOCK + sizeof(FINAL_BLOCK), trailer);
+    putLittleEndian32(trailer + sizeof(FINAL_BLOCK), static_cast<uint32_t>(crc));
+    putLittleEndian32(trailer + sizeof(FINAL_BLOCK) + 4, static_cast<uint32_t>(totalInput));
+    if (!sink.write(file, trailer, sizeof(trailer), totalOutput)) {
+        return false;
+    }
+    totalOutput += sizeof(trailer);
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef PARALLEL_GZIP_H
+#define PARALLEL_GZIP_H
+
+#include "async_output.h"
+#include "work_stealing_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <zlib.h>
+
+/**
+ * Równoległa kompresja gzip w stylu pigz.
+ *
+ * Wejście dzielone jest na bloki po blockSize bajtów, każdy blok kompresowany jest
+ * osobnym strumieniem deflate (surowym, bez nagłówka) na wątkach puli. Słownik bloku
+ * jest zasilany ostatnimi 32 KB poprzedniego bloku (deflateSetDictionary), więc
+ * dopasowania przechodzą przez granice bloków prawie jak w jednym strumieniu.
+ * Każdy blok kończy Z_SYNC_FLUSH (wyrównanie do bajtu), dzięki czemu skompresowane
+ * bloki można skleić w jeden poprawny człon gzip; na końcu dopisywany jest pusty
+ * blok końcowy i stopka z CRC32 (crc32_combine sum bloków) oraz długością danych.
+ *
+ * Bloki przetwarzane są partiami: wczytanie wejścia, kompresja, zapis w kolejności.
+ * Zapis idzie przez AsyncOutputSink, więc kolejna partia kompresuje się w trakcie zapisu
+ * poprzedniej. Rozmiar wyjścia liczony jest w pamięci, bez zapytań do systemu plików.
+ */
+class ParallelGzipWriter {
+public:
+    // Wypełnia blok wejścia zaczynający się od `offset`; zwraca liczbę bajtów
+    // (mniej niż size tylko na końcu danych)
+    using FillFn = std::function<size_t(size_t worker, uint64_t offset, unsigned char* buffer, size_t size)>;
+    // Wywoływany po zapisaniu każdego bloku z łącznym rozmiarem pliku
+    using ProgressFn = std::function<void(uint64_t compressedBytes)>;
+
+    static constexpr size_t DICTIONARY_SIZE = 32 * 1024; // okno deflate
+
+    ParallelGzipWriter(WorkStealingPool& pool, size_t blockSize, int level = 6);
+    ~ParallelGzipWriter();
+
+    ParallelGzipWriter(const ParallelGzipWriter&) = delete;
+    ParallelGzipWriter& operator=(const ParallelGzipWriter&) = delete;
+
+    /**
+     * Kompresuje dane z `fill` do pliku `file` sinka (od początku pliku), aż plik osiągnie
+     * co najmniej targetBytes albo skończy się wejście. Przy parallelFill = false fill
+     * wywoływany jest po kolei z jednego wątku (źródła z łańcuchem stanu). Błędy zapisu
+     * zgłasza dopiero sink.closeFile().
+     */
+    bool compress(const FillFn& fill, bool parallelFill, AsyncOutputSink& sink, int file, uint64_t targetBytes,
+                  const ProgressFn& progress = nullptr);
+
+    // Jak wyżej, ale bloki wskazują wprost na dane w pamięci (np. zmapowany plik) - bez kopiowania wejścia
+    bool compress(const unsigned char* data, uint64_t size, AsyncOutputSink& sink, int file, uint64_t targetBytes,
+                  const ProgressFn& progress = nullptr);
+
+    uint64_t inputBytes() const { return totalInput; }
+    uint64_t outputBytes() const { return totalOutput; }
+
+private:
+    struct Block {
+        std::vector<unsigned char> input;   // bufor dla wejścia z FillFn
+        const unsigned char* data = nullptr; // wejście bloku: input.data() albo dane wywołującego
+        size_t inputSize = 0;
+        std::vector<unsigned char> output;
+        size_t outputSize = 0;
+        uLong crc = 0;
+        bool failed = false;
+    };
+
+    WorkStealingPool& pool;
+    size_t blockSize;
+    std::vector<z_stream> streams; // jeden strumień deflate na wątek puli
+    std::vector<bool> streamReady;
+    std::vector<Block> blocks;     // partia bloków
+    std::vector<unsigned char> dictionary; // koniec ostatniego bloku poprzedniej partii
+
+    uint64_t totalInput = 0;
+    uint64_t totalOutput = 0;
+
+    void compressBlock(size_t worker, Block& block, const unsigned char* dict, size_t dictSize);
+
+    // Wspólna pętla partii; loadBatch ustawia data i inputSize bloków partii zaczynającej się od offsetu
+    bool compressBatches(const std::function<void(uint64_t batchOffset)>& loadBatch, AsyncOutputSink& sink,
+                         int file, uint64_t targetBytes, const ProgressFn& progress);
+};
+
+#endif // PARALLEL_GZIP_H
@@ -0,0 +1,18 @@
+// Budowany z -mavx2 (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "philox_impl.h"
+#include <immintrin.h>
+
+typedef uint64_t PhiloxLanes256 __attribute__((vector_size(32)));
+
+namespace {
+
+template <>
+inline PhiloxLanes256 philoxMulWide(PhiloxLanes256 a, uint64_t m) {
+    return reinterpret_cast<PhiloxLanes256>(_mm256_mul_epu32(reinterpret_cast<__m256i>(a), reinterpret_cast<__m256i>(PhiloxLanes256{} + m)));
+}
+
+} // namespace
+
+void philoxFillBlocksAvx2(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks) {
+    philoxFillGroups<PhiloxLanes256>(key, firstBlock, out, blocks);
+}
@@ -0,0 +1,19 @@
+// Budowany z -mavx512f (CMakeLists.txt); wywoływany tylko po sprawdzeniu CPU
+#include "philox_impl.h"
+#include <immintrin.h>
+
+typedef uint64_t PhiloxLanes512 __attribute__((vector_size(64)));
+
+namespace {
+
+// maskz zamiast _mm512_mul_epu32: ten sam vpmuludq, bez fałszywego -Wmaybe-uninitialized w GCC 12
+template <>
+inline PhiloxLanes512 philoxMulWide(PhiloxLanes512 a, uint64_t m) {
+    return reinterpret_cast<PhiloxLanes512>(_mm512_maskz_mul_epu32(0xFF, reinterpret_cast<__m512i>(a), reinterpret_cast<__m512i>(PhiloxLanes512{} + m)));
+}
+
+} // namespace
+
+void philoxFillBlocksAvx512(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks) {
+    philoxFillGroups<PhiloxLanes512>(key, firstBlock, out, blocks);
+}
@@ -0,0 +1,121 @@
+#ifndef PHILOX_IMPL_H
+#define PHILOX_IMPL_H
+
+/**
+ * Wewnętrzna część generatora Philox4x32-10, wspólna dla wariantów 64-bit / AVX2 / AVX-512.
+ *
+ * Blok o numerze n (16 bajtów wyjścia) to Philox4x32-10 z licznikiem (n, 0) i kluczem
+ * równym 64-bitowemu ziarnu, więc dowolny fragment strumienia liczy się bez znajomości
+ * poprzednich. Jądro jest szablonem po typie słowa T: uint64_t albo wektorze GCC
+ * (uint64_t __attribute__((vector_size(32/64)))); każdy 64-bitowy pas niesie jedno
+ * 32-bitowe słowo stanu jednego bloku, więc T liczy sizeof(T) / 8 bloków naraz.
+ * Mnożenia 32x32 -> 64 bity mapują się na vpmuludq. Plik jest dołączany przez osobne
+ * jednostki kompilacji budowane z -mavx2 / -mavx512f, dlatego wszystko poza
+ * deklaracjami jąder ma wiązanie wewnętrzne.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Jądra dla kolejnych zestawów instrukcji; `blocks` musi być wielokrotnością liczby pasów jądra
+void philoxFillBlocks64(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks);
+void philoxFillBlocksAvx2(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks);
+void philoxFillBlocksAvx512(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks);
+
+namespace {
+
+// Stałe Philox4x32 (Salmon i in., "Parallel Random Numbers: As Easy as 1, 2, 3")
+constexpr uint64_t PHILOX_M0 = 0xD2511F53;
+constexpr uint64_t PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+constexpr int PHILOX_ROUNDS = 10;
+
+template <typename T>
+constexpr size_t philoxLanesOf() {
+    if constexpr (std::is_integral_v<T>) {
+        return 1;
+    } else {
+        return sizeof(T) / sizeof(uint64_t);
+    }
+}
+
+inline void store64le(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+}
+
+// Iloczyn 32x32 -> 64 bity (górne połowy pasów `a` są zerowe). GCC nie wie, że wystarczy
+// jedno vpmuludq, i emuluje pełne mnożenie 64-bitowe, więc warianty AVX specjalizują tę funkcję
+template <typename T>
+inline T philoxMulWide(T a, uint64_t m) {
+    return a * m;
+}
+
+// Maska __builtin_shuffle: lo[base], hi[base], lo[base+1], hi[base+1], ...
+template <typename T, size_t... I>
+constexpr T interleaveMask(size_t base, std::index_sequence<I...>) {
+    return T{(base + I / 2 + (I % 2) * sizeof...(I))...};
+}
+
+template <typename T>
+inline void philoxFillGroups(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks) {
+    constexpr size_t LANES = philoxLanesOf<T>();
+    const uint64_t MASK32 = 0xFFFFFFFFULL;
+
+    for (size_t done = 0; done < blocks; done += LANES) {
+        // Licznik bloku: słowa x0,x1 = numer bloku, x2,x3 = 0
+        T x0{};
+        T x1{};
+        if constexpr (LANES == 1) {
+            x0 = (firstBlock + done) & MASK32;
+            x1 = (firstBlock + done) >> 32;
+        } else {
+            for (size_t l = 0; l < LANES; l++) {
+                x0[l] = (firstBlock + done + l) & MASK32;
+                x1[l] = (firstBlock + done + l) >> 32;
+            }
+        }
+        T x2{};
+        T x3{};
+
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < PHILOX_ROUNDS; round++) {
+            T p0 = philoxMulWide(x0, PHILOX_M0);
+            T p1 = philoxMulWide(x2, PHILOX_M1);
+            T y0 = (p1 >> 32) ^ x1 ^ static_cast<uint64_t>(k0);
+            T y2 = (p0 >> 32) ^ x3 ^ static_cast<uint64_t>(k1);
+            x1 = p1 & MASK32;
+            x3 = p0 & MASK32;
+            x0 = y0;
+            x2 = y2;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Słowa bloku w kolejności little-endian: bajty 0-7 = x0,x1, bajty 8-15 = x2,x3
+        T lo = x0 | (x1 << 32);
+        T hi = x2 | (x3 << 32);
+        unsigned char* dst = out + 16 * done;
+        if constexpr (LANES == 1) {
+            store64le(dst, lo);
+            store64le(dst + 8, hi);
+        } else {
+            // Przeplot pasów lo/hi w kolejność bajtów wyjścia i zapis całymi wektorami
+            constexpr auto indices = std::make_index_sequence<LANES>();
+            T first = __builtin_shuffle(lo, hi, interleaveMask<T>(0, indices));
+            T second = __builtin_shuffle(lo, hi, interleaveMask<T>(LANES / 2, indices));
+            memcpy(dst, &first, sizeof(T));
+            memcpy(dst + sizeof(T), &second, sizeof(T));
+        }
+    }
+}
+
+} // namespace
+
+#endif // PHILOX_IMPL_H
@@ -0,0 +1,107 @@
+#include "plaintext_source.h"
+#include "philox_impl.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace {
+
+struct PhiloxKernelChoice {
+    void (*fill)(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks);
+    size_t lanes;
+    const char* name;
+};
+
+PhiloxKernelChoice selectPhiloxKernel() {
+#ifdef CIPHERDATA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {philoxFillBlocksAvx512, 8, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {philoxFillBlocksAvx2, 4, "avx2"};
+    }
+#endif
+    return {philoxFillBlocks64, 1, "64-bit"};
+}
+
+const PhiloxKernelChoice& philoxKernel() {
+    static const PhiloxKernelChoice choice = selectPhiloxKernel();
+    return choice;
+}
+
+class PhiloxSource : public PlaintextSource {
+private:
+    uint64_t key;
+
+public:
+    explicit PhiloxSource(uint64_t seed) : key(seed) {}
+
+    const char* name() const override { return "philox"; }
+
+    void fill(unsigned char* out, size_t size, uint64_t offset) const override {
+        const PhiloxKernelChoice& kernel = philoxKernel();
+        uint64_t block = offset / 16;
+        size_t skip = offset % 16;
+
+        // Niewyrównany początek: pierwszy blok przez bufor pośredni
+        if (skip > 0 && size > 0) {
+            unsigned char tmp[16];
+            philoxFillBlocks64(key, block, tmp, 1);
+            size_t n = std::min(size, 16 - skip);
+            memcpy(out, tmp + skip, n);
+            out += n;
+            size -= n;
+            block++;
+        }
+
+        // Pełne bloki: główna część jądrem wektorowym, reszta skalarnie
+        size_t blocks = size / 16;
+        size_t vectorBlocks = blocks - blocks % kernel.lanes;
+        kernel.fill(key, block, out, vectorBlocks);
+        philoxFillBlocks64(key, block + vectorBlocks, out + 16 * vectorBlocks, blocks - vectorBlocks);
+        out += 16 * blocks;
+        size -= 16 * blocks;
+        block += blocks;
+
+        if (size > 0) {
+            unsigned char tmp[16];
+            philoxFillBlocks64(key, block, tmp, 1);
+            memcpy(out, tmp, size);
+        }
+    }
+};
+
+class Mt19937Source : public PlaintextSource {
+private:
+    uint64_t seed;
+
+public:
+    explicit Mt19937Source(uint64_t seed) : seed(seed) {}
+
+    const char* name() const override { return "mt19937"; }
+
+    void fill(unsigned char* out, size_t size, uint64_t offset) const override {
+        std::mt19937 localGen(static_cast<unsigned int>(seed + offset));
+        std::uniform_int_distribution<unsigned char> dist(0, 255);
+        for (size_t i = 0; i < size; i++) {
+            out[i] = dist(localGen);
+        }
+    }
+};
+
+} // namespace
+
+void philoxFillBlocks64(uint64_t key, uint64_t firstBlock, unsigned char* out, size_t blocks) {
+    philoxFillGroups<uint64_t>(key, firstBlock, out, blocks);
+}
+
+std::unique_ptr<PlaintextSource> createPlaintextSource(const std::string& mode, uint64_t seed) {
+    if (mode == "philox") return std::make_unique<PhiloxSource>(seed);
+    if (mode == "mt19937") return std::make_unique<Mt19937Source>(seed);
+    return nullptr;
+}
+
+const char* philoxKernelName() {
+    return philoxKernel().name;
+}
@@ -0,0 +1,39 @@
+#ifndef PLAINTEXT_SOURCE_H
+#define PLAINTEXT_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Źródło losowego tekstu jawnego dla generatorów szyfrogramów.
+ *
+ * fill(out, size, offset) wypełnia bufor bajtami strumienia zaczynając od
+ * przesunięcia `offset`, więc każdy chunk liczy się niezależnie z (ziarno, offset)
+ * i może być generowany w dowolnym wątku. Metoda jest const - jedno źródło
+ * może być używane z wielu wątków.
+ *
+ * Tryby:
+ *  - "philox"  - licznikowy Philox4x32-10 (wektorowy, AVX2/AVX-512 wybierane w czasie
+ *                działania); strumień jest ciągły, offset może być dowolny.
+ *  - "mt19937" - dawny generator: każdy chunk to nowy std::mt19937 z ziarnem
+ *                (ziarno + offset) obciętym do unsigned int, bajt po bajcie przez
+ *                uniform_int_distribution. Odtwarza wcześniejsze zbiory danych, o ile
+ *                offset jest początkiem chunka takim jak przy ich generowaniu.
+ */
+class PlaintextSource {
+public:
+    virtual ~PlaintextSource() = default;
+
+    virtual const char* name() const = 0;
+    virtual void fill(unsigned char* out, size_t size, uint64_t offset) const = 0;
+};
+
+// Obsługiwane tryby: "philox", "mt19937"; dla nieznanej nazwy zwraca nullptr
+std::unique_ptr<PlaintextSource> createPlaintextSource(const std::string& mode, uint64_t seed);
+
+// Nazwa wybranego wariantu jądra Philox: "avx512", "avx2" albo "64-bit"
+const char* philoxKernelName();
+
+#endif // PLAINTEXT_SOURCE_H
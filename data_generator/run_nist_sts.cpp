@@ -0,0 +1,221 @@
+#include "nist_sts.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Uruchamia natywny zestaw testów NIST STS na pliku binarnym.
+ *
+ * Użycie: run_nist_sts <plik> [bity_strumienia] [liczba_strumieni] [maska_testów] [wątki] [raport.json]
+ * Raport w układzie finalAnalysisReport.txt trafia na standardowe wyjście.
+ *
+ * run_nist_sts --selftest sprawdza zestaw na znanych odpowiedziach: pierwsze 10^6 cyfr
+ * binarnych e (liczone w procesie) muszą dać p-wartości z dodatku B SP 800-22 rev. 1a.
+ */
+
+namespace {
+
+// Pierwsze n cyfr binarnych e, po jednym bicie na bajt - jak data/data.e w sts-2.1.2 ("10" części
+// całkowitej, potem ułamek). Schemat Hornera e = 1 + (1 + (1 + ...)/3)/2)/1 na ułamku stałoprzecinkowym
+// w słowach 32-bitowych (od najstarszego): krok k to x = (x + k) / k, a dwa kolejne kroki dopóki
+// iloczyn mieści się w 32 bitach - x = (x + k^2) / ((k-1) * k). Wynik kroku k jest potem dzielony
+// jeszcze przez (k-1)!, więc dolne słowa, które to dzielenie wypchnie poza precyzję, są pomijane.
+// Dzielenie przez odwrotność (mnożenie 64x64 i jedna poprawka), kilka kroków naraz na każdym słowie.
+std::vector<unsigned char> binaryExpansionOfE(size_t n) {
+    const size_t words = (n + 31) / 32 + 2; // dwa słowa zapasu na błędy obcięcia
+    const double log2Word = 32.0 * std::log(2.0);
+    std::vector<uint32_t> fraction(words, 0);
+    uint64_t whole = 0;
+
+    // Ostatni wyraz szeregu (1/K!) poniżej precyzji
+    uint64_t k = 2;
+    while (std::lgamma(static_cast<double>(k + 1)) / log2Word < static_cast<double>(words)) {
+        k++;
+    }
+
+    struct Step {
+        uint64_t divisor;
+        uint64_t inverse; // floor((2^64 - 1) / divisor)
+        uint64_t remainder;
+    };
+    constexpr size_t BATCH = 4;
+    while (k >= 1) {
+        Step steps[BATCH];
+        size_t count = 0;
+        size_t length = words;
+        for (; count < BATCH && k >= 1; count++) {
+            uint64_t divisor, addend;
+            if (k >= 2 && (k - 1) * k < (1ULL << 32)) {
+                divisor = (k - 1) * k;
+                addend = k * k;
+                k -= 2;
+            } else {
+                divisor = k;
+                addend = k;
+                k -= 1;
+            }
+            uint64_t total = whole + addend;
+            whole = total / divisor;
+            steps[count] = {divisor, ~0ULL / divisor, total % divisor};
+            // Po tym kroku zostaje dzielenie przez k! - tyle pełnych słów wypada poza precyzję
+            size_t dropped = static_cast<size_t>(std::lgamma(static_cast<double>(k + 1)) / log2Word);
+            length = std::min(words, words - std::min(words - 1, dropped) + 1);
+        }
+        for (size_t w = 0; w < length; w++) {
+            uint64_t value = fraction[w];
+            for (size_t s = 0; s < count; s++) {
+                Step& step = steps[s];
+                uint64_t current = (step.remainder << 32) | value;
+                uint64_t quotient =
+                    static_cast<uint64_t>((static_cast<unsigned __int128>(current) * step.inverse) >> 64);
+                uint64_t remainder = current - quotient * step.divisor;
+                if (remainder >= step.divisor) {
+                    quotient++;
+                    remainder -= step.divisor;
+                }
+                step.remainder = remainder;
+                value = quotient;
+            }
+            fraction[w] = static_cast<uint32_t>(value);
+        }
+    }
+
+    std::vector<unsigned char> bits(n);
+    for (size_t i = 0; i < n; i++) {
+        if (i < 2) {
+            bits[i] = (whole >> (1 - i)) & 1;
+        } else {
+            size_t f = i - 2;
+            bits[i] = (fraction[f / 32] >> (31 - f % 32)) & 1;
+        }
+    }
+    return bits;
+}
+
+struct KnownAnswer {
+    NistTestId test;
+    size_t statistic;   // indeks p-wartości w teście
+    const char* label;
+    double expected;
+};
+
+// SP 800-22 rev. 1a, dodatek B - e, n = 10^6, parametry jak w tabeli (m i M w nawiasach)
+const KnownAnswer E_KNOWN_ANSWERS[] = {
+    {NIST_FREQUENCY, 0, "Frequency", 0.953749},
+    {NIST_BLOCK_FREQUENCY, 0, "BlockFrequency (M=128)", 0.211072},
+    {NIST_CUMULATIVE_SUMS, 0, "CumulativeSums (forward)", 0.669887},
+    {NIST_CUMULATIVE_SUMS, 1, "CumulativeSums (reverse)", 0.724266},
+    {NIST_RUNS, 0, "Runs", 0.561917},
+    {NIST_LONGEST_RUN, 0, "LongestRun (M=10000)", 0.718945},
+    {NIST_RANK, 0, "Rank", 0.306156},
+    {NIST_FFT, 0, "FFT", 0.847187},
+    {NIST_NON_OVERLAPPING_TEMPLATE, 0, "NonOverlappingTemplate (000000001)", 0.078790},
+    {NIST_OVERLAPPING_TEMPLATE, 0, "OverlappingTemplate (m=9)", 0.110434},
+    {NIST_UNIVERSAL, 0, "Universal", 0.282568},
+    {NIST_APPROXIMATE_ENTROPY, 0, "ApproximateEntropy (m=10)", 0.700073},
+    {NIST_RANDOM_EXCURSIONS, 4, "RandomExcursions (x=+1)", 0.786868},
+    {NIST_RANDOM_EXCURSIONS_VARIANT, 8, "RandomExcursionsVariant (x=-1)", 0.826009},
+    {NIST_SERIAL, 0, "Serial (m=2, p1)", 0.843764},
+    {NIST_SERIAL, 1, "Serial (m=2, p2)", 0.561915},
+    {NIST_LINEAR_COMPLEXITY, 0, "LinearComplexity (M=1000)", 0.845406},
+};
+
+// Cały zestaw (ta sama ścieżka co dla plików: jądra na bitach spakowanych, FFT z planem) na e;
+// 0, gdy wszystkie p-wartości zgadzają się z tabelą
+int runSelfTest() {
+    const size_t n = 1000000;
+    std::vector<unsigned char> bits = binaryExpansionOfE(n);
+    std::vector<unsigned char> packed((n + 7) / 8, 0);
+    for (size_t i = 0; i < n; i++) {
+        packed[i >> 3] |= static_cast<unsigned char>(bits[i] << (7 - (i & 7)));
+    }
+
+    NistOptions options;
+    options.streamBits = n;
+    options.streamCount = 1;
+    options.threads = 1;
+    options.parameters.blockFrequencyBlockLength = 128;
+    options.parameters.nonOverlappingTemplateLength = 9;
+    options.parameters.overlappingTemplateLength = 9;
+    options.parameters.approximateEntropyBlockLength = 10;
+    options.parameters.serialBlockLength = 2;
+    options.parameters.linearComplexityBlockLength = 1000;
+
+    NistTestSuite suite(options);
+    NistReport report;
+    if (!suite.runBuffer(packed.data(), packed.size(), report)) {
+        return 1;
+    }
+    const NistStreamResult& result = report.streams[0];
+
+    std::cout << "=== Test zestawu NIST STS: e, n = " << n << " (SP 800-22, dodatek B) ===" << std::endl;
+    std::cout << std::left << std::setw(38) << "Test" << std::right << std::setw(12) << "oczekiwane"
+              << std::setw(12) << "wynik" << "  zgodność" << std::endl;
+    bool allMatch = true;
+    for (const KnownAnswer& answer : E_KNOWN_ANSWERS) {
+        const std::vector<double>& pValues = result.pValues[answer.test];
+        bool present = answer.statistic < pValues.size();
+        // Tabela podaje 6 miejsc po przecinku - dopuszczalna różnica to jednostka ostatniego miejsca
+        bool match = present && std::fabs(pValues[answer.statistic] - answer.expected) < 1e-6;
+        allMatch = allMatch && match;
+        std::cout << std::left << std::setw(38) << answer.label << std::right << std::fixed << std::setprecision(6)
+                  << std::setw(12) << answer.expected << std::setw(12);
+        if (present) {
+            std::cout << pValues[answer.statistic];
+        } else {
+            std::cout << "-";
+        }
+        std::cout << "  " << (match ? "OK" : "BŁĄD") << std::endl;
+    }
+    return allMatch ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Użycie: " << argv[0]
+                  << " <plik> [bity_strumienia=8388608] [liczba_strumieni=0] [maska_testów=111111111111111]"
+                  << " [wątki=0] [raport.json]" << std::endl;
+        std::cerr << "       " << argv[0] << " --selftest" << std::endl;
+        return 1;
+    }
+    if (std::strcmp(argv[1], "--selftest") == 0) {
+        return runSelfTest();
+    }
+
+    std::string inputFile = argv[1];
+    std::string jsonFile;
+    NistOptions options;
+
+    if (argc > 2)
+        options.streamBits = std::stoul(argv[2]);
+    if (argc > 3)
+        options.streamCount = std::stoul(argv[3]);
+    if (argc > 4) {
+        if (!options.setTestMask(argv[4])) {
+            std::cerr << "Niepoprawna maska testów: " << argv[4] << " (oczekiwano " << NIST_TEST_COUNT
+                      << " znaków 0/1)" << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 5)
+        options.threads = std::stoul(argv[5]);
+    if (argc > 6)
+        jsonFile = argv[6];
+
+    NistTestSuite suite(options);
+    NistReport report;
+    if (!suite.runFile(inputFile, report))
+        return 1;
+
+    report.printFinalAnalysis(std::cout);
+    if (!jsonFile.empty() && !report.saveJson(jsonFile))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include "stream_stats.h"
+#include "dataset_format.h"
+#include "nist_bit_kernels.h"
+#include "nist_math.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// psi^2 dla liczników wzorców `bits`-bitowych z `windows` okien
+double psiSquared(const std::vector<uint64_t>& counts, size_t bits, uint64_t windows) {
+    if (windows == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (uint64_t count : counts) {
+        sum += static_cast<double>(count) * static_cast<double>(count);
+    }
+    return sum * std::pow(2.0, bits) / static_cast<double>(windows) - static_cast<double>(windows);
+}
+
+// Liczniki wzorców o jeden bit krótszych: prefiksy okien (bez ostatniego bitu)
+std::vector<uint64_t> prefixCounts(const std::vector<uint64_t>& counts) {
+    std::vector<uint64_t> shorter(counts.size() / 2);
+    for (size_t i = 0; i < shorter.size(); i++) {
+        shorter[i] = counts[2 * i] + counts[2 * i + 1];
+    }
+    return shorter;
+}
+
+} // namespace
+
+StreamStats::StreamStats(size_t serialBits)
+    : patternBits(serialBits >= 2 && serialBits <= MAX_SERIAL_BITS ? serialBits : 0) {
+    if (patternBits > 0) {
+        patterns.assign(size_t(1) << patternBits, 0);
+    }
+    if (patternBits > 0 && patternBits <= PAIR_PATTERN_BITS) {
+        bytePairs.assign(size_t(1) << 16, 0);
+    }
+}
+
+void StreamStats::add(const unsigned char* data, size_t size, uint64_t offset) {
+    if (size == 0) {
+        return;
+    }
+
+    Segment segment;
+    segment.offset = offset;
+    segment.size = size;
+    segment.head = static_cast<uint16_t>(data[0] << 8 | (size > 1 ? data[1] : 0));
+    segment.tail = static_cast<uint16_t>(size > 1 ? data[size - 2] << 8 | data[size - 1] : data[0]);
+    segments.push_back(segment);
+
+    accumulateByteHistogram(data, size, byteHistogram.data());
+
+    transitions += nistPackedTransitions(data, 8 * size);
+
+    if (patternBits == 0) {
+        return;
+    }
+    // Okno kończące się na bicie j bajtu i to (window >> (7 - j)) & mask; okna zaczynające się
+    // przed chunkiem dolicza summarize(), a od trzeciego bajtu (16 >= m - 1 bitów) każde okno jest pełne
+    const uint32_t mask = (uint32_t(1) << patternBits) - 1;
+    uint64_t* counts = patterns.data();
+    uint32_t window = 0;
+    size_t i = 0;
+    for (; i < size && i < 2; i++) {
+        window = window << 8 | data[i];
+        for (size_t j = 0; j < 8; j++) {
+            if (8 * i + j + 1 >= patternBits) {
+                counts[(window >> (7 - j)) & mask]++;
+            }
+        }
+    }
+    if (!bytePairs.empty()) {
+        // Jedna inkrementacja na bajt; osiem okien każdej pary rozpisuje summarize()
+        uint64_t* pairs = bytePairs.data();
+        for (; i < size; i++) {
+            pairs[data[i - 1] << 8 | data[i]]++;
+        }
+        return;
+    }
+    for (; i < size; i++) {
+        window = window << 8 | data[i];
+        counts[(window >> 7) & mask]++;
+        counts[(window >> 6) & mask]++;
+        counts[(window >> 5) & mask]++;
+        counts[(window >> 4) & mask]++;
+        counts[(window >> 3) & mask]++;
+        counts[(window >> 2) & mask]++;
+        counts[(window >> 1) & mask]++;
+        counts[window & mask]++;
+    }
+}
+
+bool StreamStats::merge(const StreamStats& other) {
+    if (other.patternBits != patternBits) {
+        std::cerr << "Nie można połączyć statystyk o różnej długości wzorców Serial" << std::endl;
+        return false;
+    }
+    transitions += other.transitions;
+    for (size_t b = 0; b < 256; b++) {
+        byteHistogram[b] += other.byteHistogram[b];
+    }
+    for (size_t p = 0; p < patterns.size(); p++) {
+        patterns[p] += other.patterns[p];
+    }
+    for (size_t p = 0; p < bytePairs.size(); p++) {
+        bytePairs[p] += other.bytePairs[p];
+    }
+    segments.insert(segments.end(), other.segments.begin(), other.segments.end());
+    return true;
+}
+
+StreamStatsSummary StreamStats::summarize() const {
+    StreamStatsSummary summary;
+    summary.byteHistogram = byteHistogram;
+    summary.serialBits = patternBits;
+    for (size_t b = 0; b < 256; b++) {
+        summary.bytes += byteHistogram[b];
+        summary.ones += byteHistogram[b] * static_cast<uint64_t>(__builtin_popcount(b));
+    }
+
+    // Granice sąsiednich chunków: przejście między ostatnim a pierwszym bitem i okna przez granicę
+    std::vector<Segment> sorted = segments;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Segment& a, const Segment& b) { return a.offset < b.offset; });
+    std::vector<uint64_t> counts = patterns;
+    if (!bytePairs.empty()) {
+        const uint32_t mask = (uint32_t(1) << patternBits) - 1;
+        for (uint32_t pair = 0; pair < bytePairs.size(); pair++) {
+            if (bytePairs[pair] == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < 8; j++) {
+                counts[(pair >> (7 - j)) & mask] += bytePairs[pair];
+            }
+        }
+    }
+    uint64_t boundaryTransitions = 0;
+    uint32_t previous = 0;   // ostatnie bity dotychczasowego fragmentu (najmłodszy = ostatni)
+    size_t previousBits = 0;
+    uint64_t previousEnd = 0;
+    for (const Segment& segment : sorted) {
+        if (previousBits > 0 && segment.offset == previousEnd) {
+            if ((previous & 1) != static_cast<uint32_t>(segment.head >> 15)) {
+                boundaryTransitions++;
+            }
+            size_t headBits = 8 * static_cast<size_t>(std::min<uint64_t>(segment.size, 2));
+            size_t crossing = patternBits > 0 ? std::min(patternBits - 1, headBits) : 0;
+            for (size_t k = 0; k < crossing; k++) {
+                // Okno kończące się na bicie k chunka: `before` bitów sprzed granicy i k + 1 po niej
+                size_t before = patternBits - 1 - k;
+                if (before > previousBits) {
+                    continue;
+                }
+                uint32_t window = (previous & ((uint32_t(1) << before) - 1)) << (k + 1) |
+                                  static_cast<uint32_t>(segment.head >> (15 - k));
+                counts[window]++;
+            }
+        } else {
+            summary.ranges++;
+            previousBits = 0;
+        }
+        if (segment.size >= 2) {
+            previous = segment.tail;
+            previousBits = 16;
+        } else {
+            previous = (previous << 8 | segment.tail) & 0xFFFF;
+            previousBits = std::min<size_t>(previousBits + 8, 16);
+        }
+        previousEnd = segment.offset + segment.size;
+    }
+
+    const double n = 8.0 * static_cast<double>(summary.bytes);
+    if (summary.bytes == 0) {
+        return summary;
+    }
+
+    // Frequency i Runs jak w SP 800-22 (2.1, 2.3)
+    double s = std::fabs(2.0 * static_cast<double>(summary.ones) - n);
+    summary.frequencyPValue = std::erfc(s / std::sqrt(n) / std::sqrt(2.0));
+
+    summary.runs = transitions + boundaryTransitions + summary.ranges;
+    double pi = static_cast<double>(summary.ones) / n;
+    if (std::fabs(pi - 0.5) < 2.0 / std::sqrt(n)) {
+        double expected = 2.0 * n * pi * (1.0 - pi);
+        summary.runsPValue = std::erfc(std::fabs(static_cast<double>(summary.runs) - expected) /
+                                       (2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi)));
+    }
+
+    if (patternBits > 0) {
+        uint64_t windows = 0;
+        for (uint64_t count : counts) {
+            windows += count;
+        }
+        std::vector<uint64_t> counts1 = prefixCounts(counts);
+        std::vector<uint64_t> counts2 = prefixCounts(counts1);
+        double psim0 = psiSquared(counts, patternBits, windows);
+        double psim1 = psiSquared(counts1, patternBits - 1, windows);
+        double psim2 = patternBits > 2 ? psiSquared(counts2, patternBits - 2, windows) : 0.0;
+        double del1 = psim0 - psim1;
+        double del2 = psim0 - 2.0 * psim1 + psim2;
+        summary.serialPValues[0] = nistIgamc(std::pow(2.0, patternBits - 2.0), del1 / 2.0);
+        summary.serialPValues[1] = nistIgamc(std::pow(2.0, patternBits - 3.0), del2 / 2.0);
+    }
+
+    const double expected = static_cast<double>(summary.bytes) / 256.0;
+    for (uint64_t count : byteHistogram) {
+        double diff = static_cast<double>(count) - expected;
+        summary.byteChiSquare += diff * diff / expected;
+        if (count > 0) {
+            double p = static_cast<double>(count) / static_cast<double>(summary.bytes);
+            summary.byteEntropy -= p * std::log2(p);
+        }
+    }
+    summary.byteChiSquarePValue = nistIgamc(255.0 / 2.0, summary.byteChiSquare / 2.0);
+    return summary;
+}
+
+void StreamStatsSummary::print(std::ostream& out, const std::string& title) const {
+    out << "  [" << title << "] Statystyki strumienia (" << bytes << " B";
+    if (ranges > 1) {
+        out << ", " << ranges << " rozłącznych fragmentów";
+    }
+    out << ")" << std::endl;
+    out << std::fixed << std::setprecision(6);
+    out << "    Frequency:        p = " << frequencyPValue << " (jedynki: " << ones << ")" << std::endl;
+    out << "    Runs:             p = " << runsPValue << " (serie: " << runs << ")" << std::endl;
+    if (serialBits > 0) {
+        out << "    Serial (m = " << serialBits << "):   p = " << serialPValues[0] << ", " << serialPValues[1]
+            << std::endl;
+    }
+    out << "    Chi^2 bajtów:     p = " << byteChiSquarePValue << " (chi^2 = " << std::setprecision(2)
+        << byteChiSquare << ", 255 st. swobody)" << std::endl;
+    out << "    Entropia bajtów:  " << std::setprecision(6) << byteEntropy << " bit/B" << std::endl;
+    out.unsetf(std::ios::floatfield);
+}
+
+bool StreamStatsSummary::saveJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Nie można otworzyć pliku " << path << std::endl;
+        return false;
+    }
+    out << std::setprecision(17);
+    out << "{\n"
+        << "  \"bytes\": " << bytes << ",\n"
+        << "  \"ranges\": " << ranges << ",\n"
+        << "  \"ones\": " << ones << ",\n"
+        << "  \"runs\": " << runs << ",\n"
+        << "  \"frequency_p_value\": " << frequencyPValue << ",\n"
+        << "  \"runs_p_value\": " << runsPValue << ",\n"
+        << "  \"serial_bits\": " << serialBits << ",\n"
+        << "  \"serial_p_values\": [" << serialPValues[0] << ", " << serialPValues[1] << "],\n"
+        << "  \"byte_chi_square\": " << byteChiSquare << ",\n"
+        << "  \"byte_chi_square_p_value\": " << byteChiSquarePValue << ",\n"
+        << "  \"byte_entropy\": " << byteEntropy << ",\n"
+        << "  \"byte_histogram\": [";
+    for (size_t b = 0; b < byteHistogram.size(); b++) {
+        out << (b ? ", " : "") << byteHistogram[b];
+    }
+    out << "]\n}\n";
+    if (!out.good()) {
+        std::cerr << "Błąd przy zapisie do pliku " << path << std::endl;
+        return false;
+    }
+    return true;
+}
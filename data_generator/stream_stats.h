@@ -0,0 +1,83 @@
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Statystyki strumienia liczone w locie, chunk po chunku, bez ponownego czytania pliku.
+ *
+ * Generatory przekazują każdy zaszyfrowany chunk razem z jego przesunięciem w strumieniu
+ * (zamiast albo oprócz zapisu na dysk). Chunki mogą przychodzić w dowolnej kolejności,
+ * a każdy wątek może mieć własny akumulator - merge() łączy akumulatory rozłącznych
+ * fragmentów tego samego strumienia. Liczniki wewnątrz chunka (jedynki, przejścia 0/1,
+ * m-bitowe wzorce, histogram bajtów) są sumowane od razu; dla każdego chunka zostaje
+ * tylko jego położenie i po dwa bajty z początku i końca, z których summarize() dolicza
+ * przejścia i wzorce przecinające granice sąsiednich chunków.
+ *
+ * Wzorce Serial liczone są na oknach nienakładających się na koniec strumienia (bez
+ * zawijania jak w NIST STS), liczniki dla m-1 i m-2 bitów wynikają z prefiksów okien m-bitowych.
+ */
+
+// Wyniki akumulatora dla całego strumienia
+struct StreamStatsSummary {
+    uint64_t bytes = 0;
+    uint64_t ones = 0;
+    uint64_t runs = 0;               // serie jednakowych bitów (przejścia + ciągłe fragmenty)
+    size_t ranges = 0;               // ciągłe fragmenty strumienia (1 = pełne pokrycie bez luk)
+    double frequencyPValue = 0.0;    // test Frequency (monobit)
+    double runsPValue = 0.0;         // test Runs; 0, gdy nie spełniono warunku wstępnego na odsetek jedynek
+    size_t serialBits = 0;           // 0 = wzorce nie były liczone
+    std::array<double, 2> serialPValues{}; // p-wartości del psi^2 i del^2 psi^2 jak w teście Serial
+    double byteChiSquare = 0.0;      // chi^2 histogramu bajtów względem rozkładu jednostajnego
+    double byteChiSquarePValue = 0.0;
+    double byteEntropy = 0.0;        // entropia Shannona bajtów (bity na bajt, maks. 8)
+    std::array<uint64_t, 256> byteHistogram{};
+
+    void print(std::ostream& out, const std::string& title) const;
+    // Zapis jako JSON; false przy błędzie zapisu
+    bool saveJson(const std::string& path) const;
+};
+
+class StreamStats {
+public:
+    static constexpr size_t MAX_SERIAL_BITS = 16;
+
+    // serialBits = długość wzorców Serial (2..MAX_SERIAL_BITS) albo 0, by ich nie liczyć
+    explicit StreamStats(size_t serialBits = 8);
+
+    size_t serialBits() const { return patternBits; }
+
+    // Dolicza `size` bajtów strumienia zaczynających się od bajtu `offset`
+    void add(const unsigned char* data, size_t size, uint64_t offset);
+
+    // Dołącza akumulator rozłącznych fragmentów tego samego strumienia; false przy innym serialBits
+    bool merge(const StreamStats& other);
+
+    StreamStatsSummary summarize() const;
+
+private:
+    // Do tej długości okna kończące się w bajcie zależą tylko od niego i bajtu poprzedniego
+    static constexpr size_t PAIR_PATTERN_BITS = 9;
+
+    // Położenie chunka i bajty z jego brzegów
+    struct Segment {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint16_t head = 0;           // pierwsze min(size, 2) bajty, wyrównane do najstarszego bitu
+        uint16_t tail = 0;           // ostatnie min(size, 2) bajty, wyrównane do najmłodszego bitu
+    };
+
+    size_t patternBits;
+    uint64_t transitions = 0;        // przejścia wewnątrz chunków
+    std::array<uint64_t, 256> byteHistogram{};
+    std::vector<uint64_t> patterns;  // wzorce okien w całości wewnątrz chunków
+    std::vector<uint64_t> bytePairs; // m <= PAIR_PATTERN_BITS: pary (poprzedni, bieżący bajt) zamiast okien
+    std::vector<Segment> segments;
+};
+
+#endif // STREAM_STATS_H
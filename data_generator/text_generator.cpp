@@ -1,239 +1,96 @@
 #include "text_generator.h"
+#include "async_output.h"
 #include <iostream>
 #include <iomanip>
 #include <filesystem>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <atomic>
 
-std::vector<std::string> TextGenerator::tokenize(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::string current;
-    for (char c : text) {
-        if (std::isspace(c) || std::ispunct(c)) {
-            if (!current.empty()) {
-                tokens.push_back(current);
-                current.clear();
-            }
-            if (std::ispunct(c) && c != '\'' && c != '-') {
-                tokens.push_back(std::string(1, c));
-            }
-        } else {
-            current += std::tolower(c);
-        }
-    }
-    if (!current.empty()) {
-        tokens.push_back(current);
-    }
-    return tokens;
-}
-
-void TextGenerator::addToMarkovChain(const std::string& text) {
-    std::vector<std::string> tokens = tokenize(text);
-    if (tokens.size() < 2) return;
-    
-    // Zapisz pierwsze słowo jako starter
-    if (!tokens.empty() && tokens[0] != "." && tokens[0] != "!" && tokens[0] != "?") {
-        sentenceStarters.push_back(tokens[0]);
-    }
-    
-    // Buduj łańcuch Markowa (bigramy - każde słowo zależy od poprzedniego)
-    for (size_t i = 0; i < tokens.size() - 1; i++) {
-        std::string current = tokens[i];
-        std::string next = tokens[i + 1];
-        
-        // Pomijaj interpunkcję jako klucze
-        if (current == "." || current == "!" || current == "?" || 
-            current == "," || current == ";" || current == ":") {
-            continue;
-        }
-        
-        markovChain[current].push_back(next);
-    }
-}
+TextGenerator::TextGenerator(unsigned int seed, std::shared_ptr<const MarkovModel> model)
+    : generator(seed), model(std::move(model)) {}
 
-void TextGenerator::initializeMarkovChain() {
-    // Korpus realistycznych zdań angielskich do treningu łańcucha Markowa
-    std::vector<std::string> corpus = {
-        "The quick brown fox jumps over the lazy dog.",
-        "In the beginning was the word and the word was with God.",
-        "To be or not to be that is the question.",
-        "It was the best of times it was the worst of times.",
-        "All happy families are alike each unhappy family is unhappy in its own way.",
-        "Call me Ishmael some years ago never mind how long precisely.",
-        "It is a truth universally acknowledged that a single man in possession of a good fortune must be in want of a wife.",
-        "The sun was shining on the sea shining with all his might.",
-        "Once upon a time in a galaxy far far away.",
-        "The old man and the sea was his favorite book.",
-        "She walked down the street with confidence and purpose.",
-        "The computer science department offers many interesting courses.",
-        "Artificial intelligence is transforming the way we work and live.",
-        "The weather today is beautiful with clear blue skies.",
-        "They decided to go for a walk in the park.",
-        "The meeting was scheduled for three o clock in the afternoon.",
-        "She opened the door and stepped into the room.",
-        "The book on the table belongs to my friend.",
-        "We need to finish this project by the end of the week.",
-        "The students were studying hard for their final exams.",
-        "He picked up the phone and dialed the number.",
-        "The restaurant serves delicious food at reasonable prices.",
-        "They traveled across the country to visit their relatives.",
-        "The company announced a new product launch next month.",
-        "She wrote a letter to her grandmother last week.",
-        "The movie was entertaining but the ending was disappointing.",
-        "He enjoys reading books about history and science.",
-        "The team worked together to solve the complex problem.",
-        "They went shopping at the mall on Saturday afternoon.",
-        "The teacher explained the lesson clearly to the students.",
-        "She loves to play the piano in her spare time.",
-        "The garden was full of beautiful flowers and plants.",
-        "He decided to take a break from work and relax.",
-        "The news about the accident spread quickly through the town.",
-        "They built a new house on the hill overlooking the valley.",
-        "The conference will be held in the convention center downtown.",
-        "She received a scholarship to study at the university.",
-        "The dog ran across the yard chasing the ball.",
-        "He found the solution to the problem after hours of thinking.",
-        "The library has an extensive collection of books and journals.",
-        "They celebrated their anniversary with a romantic dinner.",
-        "The artist painted a beautiful landscape of the countryside.",
-        "She learned to speak French during her stay in Paris.",
-        "The doctor recommended rest and plenty of fluids.",
-        "He bought a new car with all the latest features.",
-        "The children were playing in the park on a sunny day.",
-        "They organized a charity event to help the homeless.",
-        "The museum displays artifacts from ancient civilizations.",
-        "She completed her degree in computer science with honors.",
-        "The storm caused significant damage to the coastal areas.",
-        "He enjoys cooking and trying new recipes from different countries.",
-        "The company invested millions in research and development.",
-        "They went on a vacation to the tropical island.",
-        "The professor gave an interesting lecture on quantum physics.",
-        "She started her own business selling handmade jewelry.",
-        "The government announced new policies to improve education.",
-        "He spent the weekend working on his home improvement project.",
-        "The concert was sold out weeks before the event.",
-        "They discussed the proposal during the board meeting.",
-        "The novel tells the story of a young woman's journey.",
-        "She volunteered at the local animal shelter on weekends.",
-        "The technology has revolutionized the way we communicate.",
-        "He received recognition for his outstanding contribution to science.",
-        "The team won the championship after a thrilling final match.",
-        "They explored the ancient ruins of the lost civilization.",
-        "The restaurant offers a wide variety of international cuisine.",
-        "She published her first novel to critical acclaim.",
-        "The university offers scholarships to deserving students.",
-        "He enjoys hiking in the mountains during summer months.",
-        "The project requires collaboration between multiple departments.",
-        "They organized a surprise party for their friend's birthday.",
-        "The book provides valuable insights into human psychology.",
-        "She learned to play the guitar by watching online tutorials.",
-        "The company expanded its operations to new markets.",
-        "He wrote a comprehensive report on climate change.",
-        "The festival attracts thousands of visitors from around the world.",
-        "They renovated their house to make it more energy efficient.",
-        "The research team made a groundbreaking discovery in medicine.",
-        "She started a blog to share her travel experiences.",
-        "The school implemented new programs to support student learning.",
-        "He enjoys photography and capturing moments of everyday life.",
-        "The organization provides assistance to families in need.",
-        "They celebrated the holiday with traditional food and music.",
-        "The movie received several awards at the film festival.",
-        "She completed a marathon training program and ran her first race.",
-        "The company developed innovative solutions to environmental problems.",
-        "He enjoys reading science fiction novels in his free time.",
-        "The museum offers guided tours in multiple languages.",
-        "They planted a garden with vegetables and herbs.",
-        "The conference featured presentations by leading experts in the field.",
-        "She started learning a new language to expand her horizons.",
-        "The technology company announced plans for expansion into Asia.",
-        "He enjoys woodworking and creating furniture in his workshop.",
-        "The charity organization helps provide education to underprivileged children.",
-        "They went on a road trip across the country.",
-        "The book became a bestseller within weeks of publication.",
-        "She received a promotion at work for her excellent performance.",
-        "The university established a new research center for artificial intelligence.",
-        "He enjoys playing chess and participating in tournaments.",
-        "The restaurant chain opened new locations in several cities.",
-        "They organized a community cleanup event in the neighborhood.",
-        "The scientist published findings that could change our understanding of the universe.",
-        "She started a fitness routine and noticed significant improvements.",
-        "The company introduced flexible working hours for employees.",
-        "He enjoys bird watching and documenting different species.",
-        "The festival featured performances by local and international artists.",
-        "They invested in renewable energy solutions for their home.",
-        "The book explores themes of love loss and redemption.",
-        "She completed an online course to improve her skills.",
-        "The organization received funding to expand its programs.",
-        "He enjoys gardening and growing his own vegetables.",
-        "The conference addressed important issues facing the industry today."
-    };
-    
-    // Dodaj wszystkie zdania z korpusu do łańcucha Markowa
-    for (const auto& sentence : corpus) {
-        addToMarkovChain(sentence);
+Mt19937Batch::Engine TextGenerator::sentenceRng(unsigned int seed) {
+    // Zdania zużywają kolejne ziarna, więc stany liczone są partiami po LANES;
+    // nowa partia tylko gdy ziarno jest poza bieżącą albo jego pas został już zużyty
+    unsigned int lane = seed - sentenceRngsSeed;
+    if (lane >= Mt19937Batch::LANES || (sentenceRngsUsed >> lane) & 1) {
+        sentenceRngs.seed(seed);
+        sentenceRngsSeed = seed;
+        sentenceRngsUsed = 0;
+        lane = 0;
     }
+    sentenceRngsUsed |= 1u << lane;
+    return sentenceRngs.engine(lane);
 }
 
-TextGenerator::TextGenerator(unsigned int seed) : generator(seed) {
-    initializeMarkovChain();
+size_t TextGenerator::maxParagraphBytes() const {
+    // Akapit kończy się pierwszym zdaniem, które przekroczy targetSize
+    return PARAGRAPH_SIZE + 1 + model->maxSentenceBytes(MAX_SENTENCE_WORDS);
 }
 
-std::string TextGenerator::generateSentenceMarkov(unsigned int& seed) {
-    std::mt19937 localGen(seed++);
+size_t TextGenerator::generateSentenceMarkov(unsigned int& seed, unsigned char* out) {
+    Mt19937Batch::Engine localGen = sentenceRng(seed++);
     
-    if (markovChain.empty() || sentenceStarters.empty()) {
-        return "The quick brown fox jumps over the lazy dog.";
+    if (model->empty()) {
+        static const char FALLBACK[] = "The quick brown fox jumps over the lazy dog.";
+        memcpy(out, FALLBACK, sizeof(FALLBACK) - 1);
+        return sizeof(FALLBACK) - 1;
     }
     
-    std::string sentence;
-    std::string currentWord;
+    unsigned char* p = out;
+    auto appendToken = [&](MarkovModel::TokenId id) {
+        size_t length = model->tokenLength(id);
+        memcpy(p, model->tokenData(id), length);
+        p += length;
+    };
     
     // Wybierz losowe słowo startowe
-    std::uniform_int_distribution<size_t> starterDist(0, sentenceStarters.size() - 1);
-    currentWord = sentenceStarters[starterDist(localGen)];
-    // Kapitalizuj pierwsze słowo
-    if (!currentWord.empty()) {
-        currentWord[0] = std::toupper(currentWord[0]);
-    }
-    sentence = currentWord;
+    const std::vector<MarkovModel::TokenId>& starters = model->starters();
+    std::uniform_int_distribution<size_t> starterDist(0, starters.size() - 1);
+    MarkovModel::TokenId current = starters[starterDist(localGen)];
+    appendToken(current);
+    // Kapitalizuj pierwsze słowo (tokeny są małymi literami, więc identyfikator się nie zmienia)
+    out[0] = static_cast<unsigned char>(std::toupper(out[0]));
     
     // Generuj zdanie używając łańcucha Markowa
-    int maxLength = 25;
     int wordCount = 1;
-    std::string lowerCurrent = currentWord;
-    std::transform(lowerCurrent.begin(), lowerCurrent.end(), lowerCurrent.begin(), ::tolower);
     
-    while (wordCount < maxLength) {
+    while (wordCount < MAX_SENTENCE_WORDS) {
         // Znajdź następne słowo w łańcuchu Markowa
-        auto it = markovChain.find(lowerCurrent);
-        if (it == markovChain.end() || it->second.empty()) {
+        size_t count = model->successorCount(current);
+        if (count == 0) {
             // Jeśli nie ma następnego słowa, zakończ zdanie
             break;
         }
+        const MarkovModel::TokenId* next = model->successorsOf(current);
         
         // Wybierz losowe następne słowo z możliwych
-        std::uniform_int_distribution<size_t> nextDist(0, it->second.size() - 1);
-        std::string nextWord = it->second[nextDist(localGen)];
+        std::uniform_int_distribution<size_t> nextDist(0, count - 1);
+        MarkovModel::TokenId nextWord = next[nextDist(localGen)];
+        MarkovModel::TokenKind kind = model->tokenKind(nextWord);
         
         // Sprawdź czy to znak interpunkcyjny kończący zdanie
-        if (nextWord == "." || nextWord == "!" || nextWord == "?") {
-            sentence += nextWord;
+        if (kind == MarkovModel::SENTENCE_END) {
+            appendToken(nextWord);
             break;
         }
         
         // Dodaj przecinek jeśli potrzeba
-        if (nextWord == ",") {
-            sentence += nextWord;
+        if (kind == MarkovModel::COMMA) {
+            *p++ = ',';
             // Pobierz następne słowo po przecinku (pomijając przecinki)
-            std::string commaNext;
             int attempts = 0;
             while (attempts < 10) {
-                std::uniform_int_distribution<size_t> commaNextDist(0, it->second.size() - 1);
-                commaNext = it->second[commaNextDist(localGen)];
-                if (commaNext != "," && commaNext != "." && commaNext != "!" && commaNext != "?") {
-                    sentence += " " + commaNext;
-                    lowerCurrent = commaNext;
+                std::uniform_int_distribution<size_t> commaNextDist(0, count - 1);
+                MarkovModel::TokenId commaNext = next[commaNextDist(localGen)];
+                MarkovModel::TokenKind commaKind = model->tokenKind(commaNext);
+                if (commaKind != MarkovModel::COMMA && commaKind != MarkovModel::SENTENCE_END) {
+                    *p++ = ' ';
+                    appendToken(commaNext);
+                    current = commaNext;
                     wordCount++;
                     break;
                 }
@@ -243,57 +100,51 @@ std::string TextGenerator::generateSentenceMarkov(unsigned int& seed) {
             continue;
         }
         
-        sentence += " " + nextWord;
-        lowerCurrent = nextWord;
+        *p++ = ' ';
+        appendToken(nextWord);
+        current = nextWord;
         wordCount++;
         
         // Losowo zakończ zdanie po minimum 8 słowach
         if (wordCount >= 8) {
             std::uniform_int_distribution<int> endSentence(0, 15);
             if (endSentence(localGen) < 2) {
-                sentence += ".";
+                *p++ = '.';
                 break;
             }
         }
     }
     
     // Upewnij się, że zdanie kończy się interpunkcją
-    if (sentence.back() != '.' && sentence.back() != '!' && sentence.back() != '?') {
+    unsigned char last = p[-1];
+    if (last != '.' && last != '!' && last != '?') {
         std::uniform_int_distribution<int> punctDist(0, 9);
         int punct = punctDist(localGen);
         if (punct < 8) {
-            sentence += ".";
+            *p++ = '.';
         } else if (punct == 8) {
-            sentence += "!";
+            *p++ = '!';
         } else {
-            sentence += "?";
+            *p++ = '?';
         }
     }
     
-    return sentence;
+    return p - out;
 }
 
-std::string TextGenerator::generateParagraph(unsigned int& seed, size_t targetSize) {
-    std::string paragraph;
+size_t TextGenerator::generateParagraph(unsigned int& seed, size_t targetSize, unsigned char* out) {
     size_t currentSize = 0;
     unsigned int localSeed = seed;
     
     while (currentSize < targetSize) {
-        std::string sentence = generateSentenceMarkov(localSeed);
         if (currentSize > 0) {
-            paragraph += " ";
-        }
-        paragraph += sentence;
-        currentSize = paragraph.size();
-        
-        // Jeśli przekroczymy cel, przerwij
-        if (currentSize >= targetSize) {
-            break;
+            out[currentSize++] = ' ';
         }
+        currentSize += generateSentenceMarkov(localSeed, out + currentSize);
     }
     
     seed = localSeed;
-    return paragraph;
+    return currentSize;
 }
 
 std::string TextGenerator::formatBytes(size_t bytes) {
@@ -309,7 +160,6 @@ void TextGenerator::createDirectory(const std::string& dir) {
 
 void TextGenerator::generateTextFile(const std::string& outputPath, size_t targetSizeBytes) {
     const size_t CHUNK_SIZE = 10 * 1024 * 1024; // 10 MB chunków tekstu
-    const size_t PARAGRAPH_SIZE = 1000; // ~1000 znaków na akapit
     
     {
         std::lock_guard<std::mutex> lock(coutMutex);
@@ -324,10 +174,10 @@ void TextGenerator::generateTextFile(const std::string& outputPath, size_t targe
         createDirectory(path.parent_path().string());
     }
 
-    std::ofstream file(outputPath);
-    if (!file.is_open()) {
-        std::lock_guard<std::mutex> lock(coutMutex);
-        std::cerr << "  Błąd: Nie można otworzyć pliku " << outputPath << std::endl;
+    // Chunk generowany w jednym buforze, gdy poprzednie są jeszcze zapisywane w tle
+    AsyncOutputSink sink(AsyncOutputOptions::fromEnvironment(CHUNK_SIZE + 2 + maxParagraphBytes(), 3));
+    int file = sink.openFile(outputPath);
+    if (file < 0) {
         return;
     }
 
@@ -340,23 +190,30 @@ void TextGenerator::generateTextFile(const std::string& outputPath, size_t targe
         size_t remaining = targetSizeBytes - bytesWritten;
         size_t currentChunkSize = std::min(CHUNK_SIZE, remaining);
         
-        // Generuj akapity do osiągnięcia rozmiaru chunka
-        std::string chunk;
-        while (chunk.size() < currentChunkSize && bytesWritten + chunk.size() < targetSizeBytes) {
-            std::string paragraph = generateParagraph(seed, PARAGRAPH_SIZE);
-            if (!chunk.empty()) {
-                chunk += "\n\n"; // Dodaj podwójny enter między akapitami
+        // Po błędzie zapisu (albo bez bufora) dalsze generowanie nie ma sensu; closeFile() zgłosi błąd
+        if (sink.failed(file)) {
+            break;
+        }
+        unsigned char* chunk = sink.acquire();
+        if (chunk == nullptr) {
+            break;
+        }
+
+        // Generuj akapity do osiągnięcia rozmiaru chunka (ostatni może go przekroczyć)
+        size_t chunkSize = 0;
+        while (chunkSize < currentChunkSize && bytesWritten + chunkSize < targetSizeBytes) {
+            if (chunkSize > 0) {
+                chunk[chunkSize++] = '\n'; // Dodaj podwójny enter między akapitami
+                chunk[chunkSize++] = '\n';
             }
-            chunk += paragraph;
+            chunkSize += generateParagraph(seed, PARAGRAPH_SIZE, chunk + chunkSize);
         }
         
         // Obetnij do dokładnego rozmiaru jeśli przekroczono
-        if (chunk.size() > remaining) {
-            chunk = chunk.substr(0, remaining);
-        }
+        chunkSize = std::min(chunkSize, remaining);
         
-        file << chunk;
-        bytesWritten += chunk.size();
+        sink.submit(file, chunk, chunkSize, bytesWritten);
+        bytesWritten += chunkSize;
         
         // Wyświetl postęp
         if (bytesWritten - lastProgressReport >= progressInterval ||
@@ -370,10 +227,10 @@ void TextGenerator::generateTextFile(const std::string& outputPath, size_t targe
         }
     }
 
-    file.close();
+    bool closed = sink.closeFile(file);
 
     std::lock_guard<std::mutex> lock(coutMutex);
-    if (bytesWritten >= targetSizeBytes) {
+    if (closed && bytesWritten >= targetSizeBytes) {
         std::cout << "  ✓ Zapisano: " << outputPath
                   << " (" << formatBytes(bytesWritten) << ")" << std::endl;
     } else {
@@ -382,43 +239,157 @@ void TextGenerator::generateTextFile(const std::string& outputPath, size_t targe
 }
 
 void TextGenerator::generateTextToBuffer(std::vector<unsigned char>& buffer, size_t targetSizeBytes, unsigned int& seed) {
-    const size_t PARAGRAPH_SIZE = 1000; // ~1000 znaków na akapit
-    
-    buffer.clear();
-    buffer.reserve(targetSizeBytes);
-    
+    buffer.resize(targetSizeBytes);
+    generateText(buffer.data(), targetSizeBytes, seed);
+}
+
+void TextGenerator::generateText(unsigned char* out, size_t size, unsigned int& seed) {
     size_t bytesGenerated = 0;
     unsigned int localSeed = seed;
+    const size_t paragraphCapacity = maxParagraphBytes();
     
-    while (bytesGenerated < targetSizeBytes) {
-        std::string paragraph = generateParagraph(localSeed, PARAGRAPH_SIZE);
-        
-        // Dodaj paragraf do bufora
-        size_t paragraphSize = paragraph.size();
-        size_t remaining = targetSizeBytes - bytesGenerated;
-        size_t bytesToAdd = std::min(paragraphSize, remaining);
+    while (bytesGenerated < size) {
+        size_t remaining = size - bytesGenerated;
         
-        // Dodaj tekst do bufora
-        buffer.insert(buffer.end(), paragraph.begin(), paragraph.begin() + bytesToAdd);
-        bytesGenerated += bytesToAdd;
-        
-        // Jeśli nie dodaliśmy całego paragrafu, przerwij
-        if (bytesToAdd < paragraphSize) {
-            break;
+        if (remaining >= paragraphCapacity) {
+            // Akapit na pewno się zmieści - piszemy prosto do wyjścia
+            bytesGenerated += generateParagraph(localSeed, PARAGRAPH_SIZE, out + bytesGenerated);
+        } else {
+            // Końcówka: akapit do bufora pomocniczego i obcięcie do wolnego miejsca
+            paragraphScratch.resize(paragraphCapacity);
+            size_t paragraphSize = generateParagraph(localSeed, PARAGRAPH_SIZE, paragraphScratch.data());
+            size_t bytesToAdd = std::min(paragraphSize, remaining);
+            memcpy(out + bytesGenerated, paragraphScratch.data(), bytesToAdd);
+            bytesGenerated += bytesToAdd;
+            
+            // Jeśli nie dodaliśmy całego paragrafu, przerwij
+            if (bytesToAdd < paragraphSize) {
+                break;
+            }
         }
         
         // Dodaj podwójny enter między akapitami (jeśli jest miejsce)
-        if (bytesGenerated + 2 <= targetSizeBytes) {
-            buffer.push_back('\n');
-            buffer.push_back('\n');
-            bytesGenerated += 2;
+        if (bytesGenerated + 2 <= size) {
+            out[bytesGenerated++] = '\n';
+            out[bytesGenerated++] = '\n';
         }
     }
     
-    // Upewnij się, że mamy dokładnie targetSizeBytes
-    if (buffer.size() > targetSizeBytes) {
-        buffer.resize(targetSizeBytes);
-    }
-    
     seed = localSeed;
 }
+
+unsigned int TextGenerator::seekableChunkSeed(unsigned int baseSeed, size_t chunkSize, uint64_t chunkIndex) {
+    // Każdy chunk dostaje własny przedział kolejnych ziaren (jak jeden długi plik sekwencyjny),
+    // dzięki czemu zdania nie powtarzają się między chunkami
+    uint64_t stride = std::max<uint64_t>(1, chunkSize / SEEKABLE_SEED_DIVISOR);
+    return baseSeed + static_cast<unsigned int>(chunkIndex * stride);
+}
+
+void TextGenerator::generateSeekableChunk(unsigned int baseSeed, size_t chunkSize, uint64_t chunkIndex,
+                                          unsigned char* out) {
+    unsigned int seed = seekableChunkSeed(baseSeed, chunkSize, chunkIndex);
+    generateText(out, chunkSize, seed);
+}
+
+void TextGenerator::generateSeekableRange(unsigned int baseSeed, size_t chunkSize, uint64_t offset,
+                                          unsigned char* out, size_t size) {
+    while (size > 0) {
+        uint64_t chunkIndex = offset / chunkSize;
+        size_t inChunk = static_cast<size_t>(offset % chunkSize);
+        size_t count = std::min(chunkSize - inChunk, size);
+
+        if (count == chunkSize) {
+            // Cały chunk w zakresie - prosto do wyjścia
+            generateSeekableChunk(baseSeed, chunkSize, chunkIndex, out);
+        } else {
+            // Krótszy tekst nie jest prefiksem pełnego chunka, więc zawsze generujemy cały
+            seekableScratch.resize(chunkSize);
+            generateSeekableChunk(baseSeed, chunkSize, chunkIndex, seekableScratch.data());
+            memcpy(out, seekableScratch.data() + inChunk, count);
+        }
+
+        out += count;
+        offset += count;
+        size -= count;
+    }
+}
+
+void TextGenerator::generateTextFileSeekable(const std::string& outputPath, size_t targetSizeBytes,
+                                             WorkStealingPool& pool) {
+    const size_t CHUNK_SIZE = SEEKABLE_CHUNK_SIZE;
+
+    {
+        std::lock_guard<std::mutex> lock(coutMutex);
+        std::cout << "Generowanie pliku tekstowego (chunki adresowalne, wątki: "
+                  << pool.workerCount() << ")..." << std::endl;
+        std::cout << "  Plik: " << outputPath << std::endl;
+        std::cout << "  Docelowy rozmiar: " << formatBytes(targetSizeBytes) << std::endl;
+    }
+
+    // Utwórz katalog jeśli potrzeba
+    std::filesystem::path path(outputPath);
+    if (path.has_parent_path()) {
+        createDirectory(path.parent_path().string());
+    }
+
+    // Bufor na wątek puli plus dwa w zapisie
+    AsyncOutputSink sink(AsyncOutputOptions::fromEnvironment(CHUNK_SIZE, pool.workerCount() + 2));
+    int file = sink.openFile(outputPath);
+    if (file < 0) {
+        return;
+    }
+
+    unsigned int baseSeed = generator();
+
+    // Generator (stan partii mt19937) na wątek puli; model współdzielony
+    std::vector<std::unique_ptr<TextGenerator>> workerGenerators(pool.workerCount());
+    std::atomic<size_t> bytesWritten{0};
+    size_t lastProgressReport = 0; // chronione przez coutMutex
+    const size_t progressInterval = 500 * 1024 * 1024; // 500 MB
+
+    for (size_t offset = 0; offset < targetSizeBytes; offset += CHUNK_SIZE) {
+        pool.submit([&, offset](size_t worker) {
+            std::unique_ptr<TextGenerator>& workerGenerator = workerGenerators[worker];
+            if (!workerGenerator) {
+                workerGenerator = std::make_unique<TextGenerator>(0, model);
+            }
+            // Po błędzie zapisu (albo bez bufora) pozostałe chunki nie są już generowane
+            if (sink.failed(file)) {
+                return;
+            }
+            size_t chunkSize = std::min(CHUNK_SIZE, targetSizeBytes - offset);
+            unsigned char* chunk = sink.acquire();
+            if (chunk == nullptr) {
+                return;
+            }
+
+            workerGenerator->generateSeekableRange(baseSeed, CHUNK_SIZE, offset, chunk, chunkSize);
+
+            // Zapis w tle; błąd zgłosi closeFile()
+            sink.submit(file, chunk, chunkSize, offset);
+
+            size_t written = bytesWritten.fetch_add(chunkSize) + chunkSize;
+
+            // Wyświetl postęp
+            std::lock_guard<std::mutex> lock(coutMutex);
+            if (written - lastProgressReport >= progressInterval || written >= targetSizeBytes) {
+                double progress = (static_cast<double>(written) / targetSizeBytes) * 100.0;
+                std::cout << "  Postęp: " << std::fixed << std::setprecision(1) << progress
+                          << "% (" << formatBytes(written) << " / "
+                          << formatBytes(targetSizeBytes) << ")" << std::endl;
+                lastProgressReport = written;
+            }
+        });
+    }
+    pool.wait();
+
+    bool closed = sink.closeFile(file);
+
+    std::lock_guard<std::mutex> lock(coutMutex);
+    if (closed && bytesWritten >= targetSizeBytes) {
+        std::cout << "  ✓ Zapisano: " << outputPath
+                  << " (" << formatBytes(bytesWritten) << ")" << std::endl;
+    } else {
+        std::cerr << "  ✗ Nie udało się zapisać pełnego pliku" << std::endl;
+    }
+}
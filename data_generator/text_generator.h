@@ -1,35 +1,77 @@
 #ifndef TEXT_GENERATOR_H
 #define TEXT_GENERATOR_H
 
+#include "markov_model.h"
+#include "mt19937_batch.h"
+#include "work_stealing_pool.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <random>
 #include <fstream>
 #include <mutex>
-#include <map>
-#include <unordered_map>
 
 class TextGenerator {
 private:
     std::mt19937 generator;
     std::mutex coutMutex;
     
-    // Markov chain structures
-    std::unordered_map<std::string, std::vector<std::string>> markovChain;
-    std::vector<std::string> sentenceStarters;
-    
-    void initializeMarkovChain();
-    void addToMarkovChain(const std::string& text);
-    std::vector<std::string> tokenize(const std::string& text);
-    std::string generateSentenceMarkov(unsigned int& seed);
-    std::string generateParagraph(unsigned int& seed, size_t targetSize);
+    static constexpr int MAX_SENTENCE_WORDS = 25;
+    static constexpr size_t PARAGRAPH_SIZE = 1000; // ~1000 znaków na akapit
+
+    // Skompilowany łańcuch Markowa, współdzielony tylko do odczytu (domyślnie MarkovModel::shared())
+    std::shared_ptr<const MarkovModel> model;
+
+    // Stany mt19937 dla kolejnych ziaren zdań, liczone partiami
+    Mt19937Batch sentenceRngs;
+    unsigned int sentenceRngsSeed = 0;
+    uint32_t sentenceRngsUsed = ~0u; // bit na pas; ~0 = partia nieważna
+
+    std::vector<unsigned char> paragraphScratch; // ostatni, obcinany akapit
+    std::vector<unsigned char> seekableScratch;  // chunk tylko częściowo objęty zakresem
+
+    // Chunk zużywa mniej ziaren zdań niż chunkSize / SEEKABLE_SEED_DIVISOR (zdanie ze spacją
+    // ma średnio ~50 bajtów), więc przedziały ziaren kolejnych chunków są rozłączne
+    static constexpr size_t SEEKABLE_SEED_DIVISOR = 8;
+
+    Mt19937Batch::Engine sentenceRng(unsigned int seed);
+    size_t maxParagraphBytes() const;
+
+    // Piszą bezpośrednio do `out` i zwracają liczbę bajtów; `out` musi pomieścić
+    // maxSentenceBytes / maxParagraphBytes()
+    size_t generateSentenceMarkov(unsigned int& seed, unsigned char* out);
+    size_t generateParagraph(unsigned int& seed, size_t targetSize, unsigned char* out);
     std::string formatBytes(size_t bytes);
     void createDirectory(const std::string& dir);
 
 public:
-    TextGenerator(unsigned int seed);
+    explicit TextGenerator(unsigned int seed, std::shared_ptr<const MarkovModel> model = MarkovModel::shared());
     void generateTextFile(const std::string& outputPath, size_t targetSizeBytes);
     void generateTextToBuffer(std::vector<unsigned char>& buffer, size_t targetSizeBytes, unsigned int& seed);
+
+    // Wypełnia dokładnie `size` bajtów tekstem (jak generateTextToBuffer, bez kopiowania)
+    void generateText(unsigned char* out, size_t size, unsigned int& seed);
+
+    /**
+     * Tryb adresowalny: strumień tekstu to ciąg niezależnych chunków po chunkSize bajtów,
+     * chunk k to generateText() od ziarna seekableChunkSeed(baseSeed, chunkSize, k).
+     * Dowolny chunk (i dowolny zakres bajtów) można wygenerować bez liczenia poprzednich,
+     * więc chunki powstają równolegle, a fragment pliku da się odtworzyć na żądanie.
+     * Plik o rozmiarze N to pierwsze N bajtów strumienia.
+     */
+    static constexpr size_t SEEKABLE_CHUNK_SIZE = 10 * 1024 * 1024; // 10 MB
+    static unsigned int seekableChunkSeed(unsigned int baseSeed, size_t chunkSize, uint64_t chunkIndex);
+
+    // Wypełnia `out` pełnym chunkiem (chunkSize bajtów)
+    void generateSeekableChunk(unsigned int baseSeed, size_t chunkSize, uint64_t chunkIndex, unsigned char* out);
+
+    // Odtwarza bajty [offset, offset + size) strumienia
+    void generateSeekableRange(unsigned int baseSeed, size_t chunkSize, uint64_t offset,
+                               unsigned char* out, size_t size);
+
+    // Jak generateTextFile, ale chunki generowane równolegle w puli i zapisywane asynchronicznie (AsyncOutputSink)
+    void generateTextFileSeekable(const std::string& outputPath, size_t targetSizeBytes, WorkStealingPool& pool);
 };
 
 #endif // TEXT_GENERATOR_H
@@ -0,0 +1,163 @@
+#include "cipher_classifier.h"
+#include "dataset_view.h"
+#include "feature_extractor.h"
+#include "feature_table.h"
+#include "work_stealing_pool.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Uczenie klasyfikatora szyfrów (cipher_classifier.h) wprost na wynikach generatorów.
+ *
+ * Użycie: train_classifier <model> <okno_KB> <max_okien> <dane>... [--validate <dane>...]
+ *   model     - plik wynikowy dla classifier_daemon
+ *   okno_KB   - rozmiar okna (jak w extract_features); max_okien - z jednego pliku, 0 = wszystkie
+ *   dane      - "plik" albo "etykieta=plik"; plik to zbiór danych (kontener / surowy, cechy są
+ *               liczone na miejscu) albo tabela cech z extract_features. Bez etykiety brana
+ *               jest metadana "algorithm" kontenera albo "label" tabeli.
+ *   --validate - dalsze pliki tylko do walidacji: całe pliki z innym ziarnem (innym kluczem)
+ *               niż dane uczące; okna tego samego pliku są skorelowane i zawyżają wynik.
+ *               Plik obecny w obu zbiorach albo ten sam klucz kontenera to błąd.
+ *
+ * Przykład pętli na jednej maszynie:
+ *   generate_ciphertexts 7 ct && generate_ciphertexts 8 ct8 && generate_compressed_text 7 gz
+ *   train_classifier model.bin 64 0 ct/des/des_7.bin ... gzip=gz/... --validate ct8/des/des_8.bin ...
+ */
+
+namespace {
+
+bool isFeatureTable(const std::string& path) {
+    char magic[sizeof(FEATURE_TABLE_MAGIC)] = {};
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool table = ::read(fd, magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic)) &&
+                 std::memcmp(magic, FEATURE_TABLE_MAGIC, sizeof(magic)) == 0;
+    ::close(fd);
+    return table;
+}
+
+// Tabela cech z argumentu "plik" albo "etykieta=plik"; false przy błędzie odczytu
+bool loadTable(const std::string& argument, size_t windowSize, size_t maxWindows, WorkStealingPool& pool,
+               FeatureTable& table) {
+    std::string label;
+    std::string path = argument;
+    size_t separator = argument.find('=');
+    if (separator != std::string::npos) {
+        label = argument.substr(0, separator);
+        path = argument.substr(separator + 1);
+    }
+
+    if (isFeatureTable(path)) {
+        if (!loadFeatureTable(path, table)) {
+            return false;
+        }
+        if (maxWindows > 0 && table.rows > maxWindows) {
+            // Kolumny obcinane do pierwszych maxWindows wierszy
+            std::vector<float> values;
+            for (size_t c = 0; c < table.columns(); c++) {
+                values.insert(values.end(), table.column(c), table.column(c) + maxWindows);
+            }
+            table.values.swap(values);
+            table.rows = maxWindows;
+        }
+    } else {
+        DatasetView view;
+        if (!view.open(path)) {
+            return false;
+        }
+        table = extractWindowFeatures(view, windowSize, maxWindows, pool);
+        table.metadata = {{"label", view.isContainer() ? view.header().value("algorithm") : ""},
+                          {"key56", view.isContainer() ? view.header().value("key56") : ""},
+                          {"source", path}};
+    }
+    if (!label.empty()) {
+        table.metadata.insert(table.metadata.begin(), {"label", label});
+    }
+    std::cout << "  " << path << ": " << table.rows << " okien, etykieta " << table.value("label") << std::endl;
+    return true;
+}
+
+// Walidacja ma sens tylko na innych plikach i innych kluczach niż uczenie
+bool disjointFromTraining(const std::vector<FeatureTable>& training, const std::vector<FeatureTable>& validation) {
+    for (const auto& check : validation) {
+        for (const auto& table : training) {
+            const std::string key = check.value("key56");
+            if (check.value("source") == table.value("source") || (!key.empty() && key == table.value("key56"))) {
+                std::cerr << "Błąd: Plik walidacyjny " << check.value("source") << " ma ten sam plik albo klucz co "
+                          << table.value("source") << " ze zbioru uczącego" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Użycie: " << argv[0] << " <model> <okno_KB> <max_okien> <dane>... [--validate <dane>...]"
+                  << std::endl;
+        return 1;
+    }
+    std::string modelPath = argv[1];
+    const size_t windowSize = std::stoul(argv[2]) * 1024;
+    const size_t maxWindows = std::stoul(argv[3]);
+    if (windowSize == 0) {
+        std::cerr << "Błąd: Rozmiar okna musi być dodatni" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== Uczenie klasyfikatora szyfrów ===" << std::endl;
+    WorkStealingPool pool;
+    std::vector<FeatureTable> tables;
+    std::vector<FeatureTable> validation;
+    auto start = std::chrono::steady_clock::now();
+    bool validating = false;
+    for (int i = 4; i < argc; i++) {
+        if (std::string(argv[i]) == "--validate") {
+            validating = true;
+            std::cout << "Zbiór walidacyjny:" << std::endl;
+            continue;
+        }
+        FeatureTable table;
+        if (!loadTable(argv[i], windowSize, maxWindows, pool, table)) {
+            return 1;
+        }
+        (validating ? validation : tables).push_back(std::move(table));
+    }
+    std::chrono::duration<double> extraction = std::chrono::steady_clock::now() - start;
+    std::cout << "Cechy: " << std::fixed << std::setprecision(2) << extraction.count() << " s" << std::endl;
+
+    if (!disjointFromTraining(tables, validation)) {
+        return 1;
+    }
+
+    CipherClassifier classifier;
+    if (!classifier.train(tables, ClassifierTrainingOptions(), std::cout)) {
+        return 1;
+    }
+    if (validation.empty()) {
+        std::cout << "Bez zbioru walidacyjnego (--validate) - dokładność uczenia nie mówi nic o innych kluczach"
+                  << std::endl;
+    } else if (!classifier.evaluate(validation, std::cout)) {
+        return 1;
+    }
+    if (!classifier.save(modelPath)) {
+        return 1;
+    }
+    std::cout << "Zapisano model: " << modelPath << " (klasy:";
+    for (const auto& name : classifier.classes()) {
+        std::cout << " " << name;
+    }
+    std::cout << ")" << std::endl;
+    return 0;
+}
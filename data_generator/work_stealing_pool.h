@@ -0,0 +1,62 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pula wątków z kradzieżą zadań.
+ *
+ * Każdy wątek ma własną kolejkę: bierze zadania z jej końca, a gdy jest pusta,
+ * kradnie z początku kolejek pozostałych wątków. Dzięki temu szybkie algorytmy
+ * (np. RC4) nie blokują rdzeni - po skończeniu swoich chunków wątki przejmują
+ * chunki wolniejszych szyfrów. Zadanie dostaje numer wątku (0..workerCount()-1),
+ * co pozwala trzymać bufory robocze per wątek.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t worker)>;
+
+    // workers == 0 oznacza liczbę rdzeni (std::thread::hardware_concurrency)
+    explicit WorkStealingPool(size_t workers = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t workerCount() const { return threads.size(); }
+
+    void submit(Task task);
+
+    // Czeka, aż wszystkie przekazane dotąd zadania się zakończą
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queued = 0;   // zadania w kolejkach
+    size_t pending = 0;  // zadania w kolejkach lub w trakcie wykonania
+    bool stopping = false;
+    std::atomic<size_t> nextQueue{0};
+
+    void workerLoop(size_t worker);
+    bool tryTake(size_t worker, Task& task);
+};
+
+#endif // WORK_STEALING_POOL_H
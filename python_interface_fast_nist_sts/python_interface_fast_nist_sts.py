@@ -18,6 +18,7 @@ Przykłady:
 from __future__ import annotations
 
 import argparse
+import json
 import shlex
 import subprocess
 import sys
@@ -187,6 +188,16 @@ def run_assess(cmd: Sequence[str], cwd: Optional[Path] = None, timeout_s: Option
     )
 
 
+# Nagłówek kontenera zbioru danych (data_generator/dataset_format.h, CIPHERDATA_FORMAT=container)
+DATASET_CONTAINER_MAGIC = b"CIPHDATA"
+
+
+def is_dataset_container(file_path: Path) -> bool:
+    """Czy plik zaczyna się od nagłówka kontenera zamiast od surowych danych."""
+    with open(file_path, "rb") as f:
+        return f.read(len(DATASET_CONTAINER_MAGIC)) == DATASET_CONTAINER_MAGIC
+
+
 def run_test_on_8GB_sample(
     filename: str,
     input_dir: Path,
@@ -226,6 +237,13 @@ def run_test_on_8GB_sample(
     if isinstance(input_dir, str):
         input_dir = Path(input_dir)
     file_path = input_dir.resolve() / filename
+
+    # assess --binary potraktowałby nagłówek i indeks kontenera jak szyfrogram
+    if is_dataset_container(file_path):
+        raise ValueError(
+            f"{file_path} jest kontenerem zbioru danych - assess czyta tylko surowe dane; "
+            "wygeneruj plik z CIPHERDATA_FORMAT=raw albo użyj run_native_nist_sts"
+        )
     
     # Rozmiar jednego strumienia w bitach
     length_bits = 8 * 1024 * 1024   #  1 MB
@@ -255,6 +273,44 @@ def run_test_on_8GB_sample(
     return result
 
 
+def run_native_nist_sts(
+    file_path: Path,
+    runner_path: Path,
+    length_bits: int = 8 * 1024 * 1024,
+    streams: int = 0,
+    tests_mask: str = "111111111111111",
+    threads: int = 0,
+    json_path: Optional[Path] = None,
+    timeout_s: Optional[int] = None,
+) -> AssessResult:
+    """
+    Uruchamia natywny zestaw testów (data_generator/run_nist_sts) zamiast assess.
+
+    Nie wymaga osobnych instancji katalogów z eksperymentami: raport w układzie
+    finalAnalysisReport.txt trafia na stdout, a przy podanym json_path - także do
+    pliku JSON (pola jak w logs/compress_nist_results.py), wczytywanego do `parsed`.
+
+    Args:
+        file_path: Plik binarny do przetestowania
+        runner_path: Ścieżka do programu run_nist_sts
+        length_bits: Długość strumienia w bitach (domyślnie 1 MB)
+        streams: Liczba strumieni (0 = tyle, ile mieści plik)
+        tests_mask: Maska testów jak --tests assess
+        threads: Liczba wątków (0 = wszystkie rdzenie)
+        json_path: Opcjonalna ścieżka raportu JSON
+        timeout_s: Opcjonalny timeout w sekundach
+    """
+    cmd = [str(runner_path), str(file_path), str(length_bits), str(streams), tests_mask, str(threads)]
+    if json_path is not None:
+        cmd.append(str(json_path))
+
+    result = run_assess(cmd, timeout_s=timeout_s)
+    if result.returncode == 0 and json_path is not None:
+        with open(json_path, "r", encoding="utf-8") as f:
+            result.parsed = json.load(f)
+    return result
+
+
 def cli(argv: Optional[Sequence[str]] = None) -> int:
     p = argparse.ArgumentParser(description="Uruchom 'assess' jako subprocess z wygodnym wrapperem.")
     p.add_argument("--assess", required=True, type=Path, help="Ścieżka do wykonywalnego 'assess' (np. ./assess).")